@@ -0,0 +1,110 @@
+/* 
+  Example use of openCV to detect moving objects in a video by background subtraction
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+   #include <sys/resource.h>
+#endif
+     
+#include <sys/types.h> 
+#include <sys/timeb.h>
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+  
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif 
+    
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+using namespace cv;
+
+#define RUNNING_GAUSSIAN     0     // mean and mean absolute deviation, 8.8 fixed point
+#define APPROXIMATE_MEDIAN   1     // sigma-delta estimate of the median and deviation, 8 bit
+#define MIN_MEDIAN_DEVIATION  2
+#define MAX_MEDIAN_DEVIATION  255
+
+struct backgroundModelType {
+
+   /* parameters */
+
+   int method;                     // RUNNING_GAUSSIAN or APPROXIMATE_MEDIAN
+   int learning_shift;             // running Gaussian: learning rate 1 / 2^learning_shift
+   int deviations;                 // a pixel is foreground if it differs from the background by more than this many deviations
+                                   // (approximate median: the deviation tracks this multiple of the absolute difference)
+   int min_difference;             // ... and by more than this number of grey levels
+   int min_area;                   // blobs smaller than this are ignored, pixels
+
+   /* state: allocated for the first frame and reused for every frame after it */
+
+   Mat mean;                       // CV_16U (8.8 fixed point) or CV_8U
+   Mat deviation;                  // CV_16U (8.8 fixed point) or CV_8U
+   Mat grey;
+   Mat foreground;
+   Mat cleaned;
+   Mat labels;
+   Mat stats;
+   Mat centroids;
+   long number_of_frames;
+};
+
+/* function prototypes go here */
+
+void   initialiseBackgroundModel(backgroundModelType *model, const Mat &grey_image);
+void   updateBackgroundModel(backgroundModelType *model, const Mat &grey_image, Mat &foreground);
+void   detectMotion(backgroundModelType *model, const Mat &bgr_image, vector<Rect> &blobs);
+size_t backgroundModelMemory(const backgroundModelType *model);
+long   peakResidentMemory();
+void   benchmarkBackgroundSubtraction(backgroundModelType *parameters, const Mat &background_image, Size frame_size, int number_of_frames);
+void   prompt_and_exit(int status);
+void   prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
@@ -7,6 +7,11 @@
 
   David Vernon
   24 November 2017
+
+  Audit Trail
+  --------------------
+  Added adaptive thresholding with integral images (Bradley and Sauvola)
+  16 October 2026
 */
 
 
@@ -42,6 +47,7 @@
 #include <cv.h>
 #include <highgui.h>
 #include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -57,12 +63,19 @@
 #define MAX_STRING_LENGTH   80
 #define MAX_FILENAME_LENGTH 200
 
+#define GLOBAL_THRESHOLD   0
+#define BRADLEY_THRESHOLD  1    // black if the pixel is sensitivity percent darker than the local mean
+#define SAUVOLA_THRESHOLD  2    // black if the pixel is darker than mean * (1 + k (standard deviation / 128 - 1)), k = sensitivity / 100
+#define SAUVOLA_RANGE      128.0
+
 using namespace std;
 using namespace cv;
 
 /* function prototypes go here */
 
 void binaryThresholding(int, void*);  
+void computeIntegralImages(const Mat &greyscaleImage, Mat &sumImage, Mat &squaredSumImage);
+void adaptiveThresholding(const Mat &greyscaleImage, Mat &thresholdedImage, int method, int windowRadius, int sensitivity);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -0,0 +1,96 @@
+/* 
+  Example use of openCV to split touching blobs with the distance transform and the watershed
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+#endif
+     
+#include <sys/types.h> 
+#include <sys/timeb.h>
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+  
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif 
+    
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+using namespace cv;
+
+#define EDT_INFINITY 1.0e20f      // squared distance of a pixel with no background pixel in its row or column
+
+struct blobSplittingParametersType {
+   float min_radius;                // maxima of the distance map below this are not markers, pixels
+   int   separation;                // a marker is a maximum of the distance map in the (2 s + 1) x (2 s + 1) window around it
+};
+
+struct blobSplittingStatisticsType {
+   int    number_of_components;     // connected components before splitting
+   int    number_of_blobs;          // blobs after splitting
+   double distance_time_ms;
+   double marker_time_ms;
+   double watershed_time_ms;
+};
+
+/* function prototypes go here */
+
+void distanceTransformEDT(const Mat &binary_image, Mat &distance_image);
+int  findDistanceMarkers(const Mat &binary_image, const Mat &distance_image, blobSplittingParametersType *parameters, Mat &markers);
+void watershedFlood(const Mat &binary_image, const Mat &distance_image, Mat &labels);
+void computeRegionTable(const Mat &labels, int number_of_labels, Mat &stats, Mat &centroids);
+int  splitBlobs(const Mat &binary_image, Mat &labels, Mat &stats, Mat &centroids,
+                blobSplittingParametersType *parameters, blobSplittingStatisticsType *statistics);
+void labelsToColourImage(const Mat &labels, int number_of_labels, Mat &colour_image);
+void prompt_and_exit(int status);
+void prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
@@ -0,0 +1,121 @@
+/* 
+  Example use of openCV to detect coloured bricks and estimate their image pose
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+#endif
+     
+#include <sys/types.h> 
+#include <sys/timeb.h>
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+  
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif 
+    
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+using namespace cv;
+
+#define MAX_NUMBER_OF_COLOURS 8
+#define COLOUR_NAME_LENGTH    20
+#define NO_COLOUR             255    // colour index of pixels that belong to none of the colours
+#define MIN_VALUE             50     // minimum HSV value of a brick pixel: darker pixels are not classified
+
+struct brickColourType {
+   char name[COLOUR_NAME_LENGTH];
+   int  hue_min;                     // OpenCV hue, 0 to 180; the range wraps through 0 if hue_min > hue_max
+   int  hue_max;
+   int  saturation_min;
+};
+
+struct brickDetectorType {
+   brickColourType colours[MAX_NUMBER_OF_COLOURS];
+   int    number_of_colours;
+   int    min_area;                  // pixels
+   int    max_area;
+   double min_aspect_ratio;          // ratio of the principal axis lengths
+   double max_aspect_ratio;
+   Mat    colour_lut;                // 180 x 256 colour index for each hue and saturation, built by buildColourLUT()
+};
+
+struct blobMomentsType {
+   double m00, m10, m01, m20, m11, m02;
+};
+
+struct brickType {
+   int   colour;                     // index into the colours of the detector
+   float u, v;                       // sub-pixel centroid
+   float phi;                        // orientation of the principal axis in degrees, -90 < phi <= 90, from the u axis towards the v axis
+   int   area;
+   float aspect_ratio;
+};
+
+struct brickFrameType {
+   long   frame_number;
+   double timestamp;                 // ms: position in the video, or time since the start for images
+   double processing_time;           // ms
+   vector<brickType> bricks;
+};
+
+/* function prototypes go here */
+
+void buildColourLUT(brickDetectorType *detector);
+void classifyColours(const Mat &bgr_image, const Mat &colour_lut, Mat &colour_index);
+void accumulateBlobMoments(const Mat &labels, const Mat &stats, int number_of_labels, vector<blobMomentsType> &moments);
+bool brickFromMoments(const blobMomentsType &m, int colour, brickDetectorType *detector, brickType *brick);
+void detectBricks(const Mat &bgr_image, brickDetectorType *detector, vector<brickType> &bricks);
+void writeBrickFrame(FILE *fp, brickDetectorType *detector, const brickFrameType &frame);
+void drawBricks(Mat &image, brickDetectorType *detector, const vector<brickType> &bricks);
+void prompt_and_exit(int status);
+void prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
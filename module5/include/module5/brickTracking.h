@@ -0,0 +1,52 @@
+/* 
+  Example use of openCV to track coloured bricks with a Kalman filter and process only the regions where they are predicted
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are declared in the interface file.)
+
+  The brick detector (detectBricks(), ...) and the utility functions are those of the brickDetection application;
+  this application is built with brickDetectionImplementation.cpp.
+
+  16 October 2026
+*/
+
+#include "module5/brickDetection.h"
+
+#include <algorithm>
+
+#define MAX_TRACK_MISSES       3      // a track is lost after this many successive frames without a detection
+#define MATCH_DISTANCE        20.0    // pixels: a detection further than this from the predicted position starts a new track
+#define DUPLICATE_DISTANCE     2.0    // pixels: detections of the same colour closer than this are the same brick seen in two regions
+#define PROCESS_NOISE          1.0    // variance of the change in velocity per frame, pixels^2
+#define MEASUREMENT_NOISE      0.5    // variance of the measured centroid, pixels^2
+
+struct trackType {
+   int          id;
+   KalmanFilter filter;               // state (u, v, du, dv) in pixels and pixels per frame; measurement (u, v)
+   brickType    brick;                // last detection, with the filtered centroid
+   Rect         roi;                  // predicted region of interest in the current frame
+   int          misses;               // successive frames without a detection
+};
+
+struct trackerType {
+   brickDetectorType *detector;
+   vector<trackType>  tracks;
+   int    full_scan_interval;         // frames between full-frame scans
+   int    roi_padding;                // pixels added to each side of the predicted extent of a brick
+   int    frames_since_full_scan;
+   bool   track_lost;                 // forces a full-frame scan in the next frame
+   int    next_id;
+   long   full_scans;                 // statistics
+   long   roi_scans;
+   double pixels_processed;           // fraction of the frame processed, summed over frames
+};
+
+/* function prototypes go here */
+
+void initialiseTracker(trackerType *tracker, brickDetectorType *detector, int full_scan_interval, int roi_padding);
+void initialiseTrack(trackType *track, const brickType &brick, int id);
+Rect predictROI(trackType *track, int padding, Size image_size);
+void detectBricksInROI(const Mat &bgr_image, Rect roi, brickDetectorType *detector, vector<brickType> &bricks);
+bool trackBricks(const Mat &bgr_image, trackerType *tracker);
+void writeTrackFrame(FILE *fp, trackerType *tracker, long frame_number, double timestamp);
+void drawTracks(Mat &image, trackerType *tracker, bool full_scan);
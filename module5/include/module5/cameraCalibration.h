@@ -63,7 +63,7 @@ using namespace std;
 using namespace cv;
 
 /* function prototypes go here */ 
-int CameraCalibration( string passed_settings_filename );
+int CameraCalibration( string passed_settings_filename, bool headless = false );
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
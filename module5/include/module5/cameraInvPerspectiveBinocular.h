@@ -45,6 +45,7 @@
 #include <cv.h>
 #include <highgui.h>
 #include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
@@ -60,6 +61,15 @@
 #define FALSE 0
 #define MAX_STRING_LENGTH 80
 #define MAX_FILENAME_LENGTH 200
+#define MAX_NUMBER_OF_FEATURES 500   // maximum number of left image features matched automatically
+#define ZNCC_MIN_SCORE 0.8f          // automatic correspondences with a lower score are rejected
+
+#define SGM_MAX_DISPARITY        64  // disparities 0 .. SGM_MAX_DISPARITY-1 are searched; must be a multiple of 8
+#define SGM_P1                   4   // path penalty for a disparity change of one pixel
+#define SGM_P2                   24  // path penalty for a larger disparity change
+#define SGM_NUMBER_OF_DIRECTIONS 4   // 4 (horizontal and vertical) or 8 (horizontal, vertical, and diagonal)
+#define SGM_UNIQUENESS_RATIO     10  // percentage by which the best cost must be lower than any other non-neighbouring cost
+#define DENSE_STEREO_BENCHMARK_RUNS 5
 
 using namespace std;
 using namespace cv;
@@ -72,10 +82,31 @@ struct worldPointType {
    float x, y, z;
 };
 
+struct denseStereoTimingType {       // milliseconds spent in each stage of the dense reconstruction
+   double rectification;
+   double census;
+   double cost;
+   double aggregation;
+   double disparity;
+   double triangulation;
+};
+
 
 /* function prototypes go here */
 
 void inversePerspectiveTransformation(Point2f left_sample_point, Point2f right_sample_point, float left_camera_model[][4], float right_camera_model[][4], Point3f *world_sample_point);
+int  triangulateStereoPoints(const vector<Point2f> &left_points, const vector<Point2f> &right_points, float left_camera_model[][4], float right_camera_model[][4], vector<Point3f> &world_points, vector<float> &residuals);
+bool computeFundamentalMatrix(float left_camera_model[][4], float right_camera_model[][4], Matx33d &F);
+void prepareStereoMatchImage(Mat &image, Mat &match_image);
+float findEpipolarCorrespondence(const Mat &left_match_image, const Mat &right_match_image, const Matx33d &F, Point2f left_point, Point2f *right_point);
+int  findStereoCorrespondences(const Mat &left_match_image, const Mat &right_match_image, const Matx33d &F, const vector<Point2f> &left_points, vector<Point2f> &right_points, vector<float> &scores);
+int  matchAndTriangulate(const Mat &left_match_image, const Mat &right_match_image, const Matx33d &F, float left_camera_model[][4], float right_camera_model[][4], const vector<Point2f> &left_points, vector<Point2f> &matched_left_points, vector<Point2f> &matched_right_points, vector<Point3f> &world_points, vector<float> &residuals);
+bool computeRectification(float left_camera_model[][4], float right_camera_model[][4], Size image_size, Matx33d &left_homography, Matx33d &right_homography, float rectified_left_model[][4], float rectified_right_model[][4]);
+void censusTransform(const Mat &grey, Mat &census);
+void semiGlobalMatching(const Mat &left_rectified, const Mat &right_rectified, Mat &disparity, denseStereoTimingType *timing);
+int  writeDisparityPointCloud(char *filename, const Mat &disparity, const Mat &left_colour, float rectified_left_model[][4], float rectified_right_model[][4]);
+bool denseStereoReconstruction(Mat &left_image, Mat &right_image, float left_camera_model[][4], float right_camera_model[][4], char *ply_filename, Mat &disparity, denseStereoTimingType *timing);
+void printDenseStereoTiming(denseStereoTimingType *timing, int number_of_runs);
 void getLeftSamplePoint( int event, int x, int y, int, void*);
 void getRightSamplePoint( int event, int x, int y, int, void*);
 void prompt_and_exit(int status);
@@ -76,6 +76,15 @@ struct worldPointType {
 /* function prototypes go here */
 
 void inversePerspectiveTransformation(Point2f image_sample_point, float camera_model[][4], float z, Point3f *world_sample_point);
+bool computeGroundPlaneHomography(float camera_model[][4], float z, double inverse_homography[][3]);
+bool inversePerspectiveTransformationBatch(const vector<Point2f> &image_points, float camera_model[][4], float z, vector<Point3f> &world_points);
+bool buildGroundPlaneMap(float camera_model[][4], float z, Size image_size, Mat &ground_plane_map);
+bool saveGroundPlaneMap(char *filename, Mat &ground_plane_map, float camera_model[][4], float z);
+bool loadGroundPlaneMap(char *filename, float camera_model[][4], float z, Size image_size, Mat &ground_plane_map);
+bool getGroundPlaneMap(char *filename, float camera_model[][4], float z, Size image_size, Mat &ground_plane_map);
+Point2f mapPointToGroundPlane(Point2f image_point, Mat &ground_plane_map);
+void mapContourToGroundPlane(const vector<Point> &contour, Mat &ground_plane_map, vector<Point2f> &world_contour);
+void mapMaskToGroundPlane(Mat &mask, Mat &ground_plane_map, vector<Point2f> &world_points);
 void getSamplePoint( int event, int x, int y, int, void*);
 void prompt_and_exit(int status);
 void prompt_and_continue();
@@ -44,6 +44,8 @@
 #include <highgui.h>
 #include <opencv2/opencv.hpp>
 
+#include "module5/fnv1a.h"
+
 #ifdef ROS
    // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
    #include <ncurses.h>
@@ -58,22 +60,71 @@
 #define FALSE 0
 #define MAX_STRING_LENGTH 80
 #define MAX_FILENAME_LENGTH 200
-#define MAX_NUMBER_OF_CONTROL_POINTS 500 
 #define NUMBER_OF_UNKNOWNS 11 
+#define RANSAC_INLIER_THRESHOLD 2.0      // maximum reprojection error in pixels of an inlier control point
+
+#define BINARY_FORMAT_VERSION     1
+#define BINARY_FILE_EXTENSION     ".bin"
+#define BINARY_IMAGE_POINTS_MAGIC "M5IP"
+#define BINARY_WORLD_POINTS_MAGIC "M5WP"
+#define BINARY_CAMERA_MODEL_MAGIC "M5CM"
 
 using namespace std;
 using namespace cv;
 
 struct imagePointType {
-   int u, v;
+   float u, v;                 // sub-pixel image coordinates, e.g. from cornerSubPix()
 };
 
 struct worldPointType {
    float x, y, z;
 };
 
+struct cameraModelStatisticsType {
+   double initial_rms_error;   // RMS reprojection error in pixels of the linear solution
+   double rms_error;           // RMS reprojection error in pixels of the refined solution
+   double max_error;           // maximum reprojection error in pixels of the refined solution
+   int    lm_iterations;       // number of Levenberg-Marquardt iterations
+   double solve_time_ms;       // time to compute the camera model
+   int    number_of_inliers;   // number of control points consistent with the model (all of them unless the robust estimator is used)
+   int    ransac_hypotheses;   // number of minimal-sample hypotheses scored by the robust estimator
+};
+
+struct binaryFileHeaderType {
+   char         magic[4];
+   unsigned int version;
+   unsigned int count;         // number of points
+   unsigned int components;    // number of values per point, stored as separate arrays
+   unsigned int element_size;  // number of bytes per value
+   unsigned int checksum;      // FNV-1a hash of the data that follow the header
+   unsigned int reserved[2];   // pads the header to 32 bytes so that the data are aligned
+};
+
+struct mappedBinaryFileType {
+   void                       *mapping;
+   size_t                      size;
+   const binaryFileHeaderType *header;
+   const unsigned char        *data;
+};
+
 /* function prototypes go here */ 
 void computeCameraModel(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], double cameraModel[][4]);
+void computeCameraModelNormalised(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], double cameraModel[][4], cameraModelStatisticsType *statistics);
+int computeCameraModelRobust(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], double threshold, double cameraModel[][4], vector<unsigned char> &inliers, cameraModelStatisticsType *statistics);
+double cameraModelRMSError(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], double cameraModel[][4], double *max_error);
+bool mapBinaryFile(const char *filename, const char *magic, mappedBinaryFileType *file);
+void unmapBinaryFile(mappedBinaryFileType *file);
+bool writeImageControlPointsBinary(const char *filename, int numberOfControlPoints, imagePointType imagePoints[]);
+bool writeWorldControlPointsBinary(const char *filename, int numberOfControlPoints, worldPointType worldPoints[]);
+bool writeCameraModelBinary(const char *filename, double cameraModel[][4]);
+int  readImageControlPointsBinary(const char *filename, vector<imagePointType> &imagePoints);
+int  readWorldControlPointsBinary(const char *filename, vector<worldPointType> &worldPoints);
+bool readCameraModelBinary(const char *filename, double cameraModel[][4]);
+int  convertImageControlPointsText(const char *text_filename, const char *binary_filename);
+int  convertWorldControlPointsText(const char *text_filename, const char *binary_filename);
+bool convertCameraModelText(const char *text_filename, const char *binary_filename);
+void binaryFilename(const char *text_filename, char *binary_filename);
+bool binaryFileIsCurrent(const char *text_filename, const char *binary_filename);
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
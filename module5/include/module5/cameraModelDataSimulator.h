@@ -23,6 +23,8 @@
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <time.h>
+#include <vector>
+#include <future>
 
 
 //opencv
@@ -68,6 +70,11 @@ struct worldPointType {
    float x, y, z;
 };
 
+struct checkerboardPoseType {
+   float x, y, z;              // position of the centre of the board in millimetres
+   float roll, pitch, yaw;     // orientation in degrees
+};
+
 /* function prototypes go here */ 
 int  getImageControlPoints(string configurationFilename, int numberOfViews, int *numberOfControlPoints, imagePointType imagePoints[],
                              FILE* fp_world_points, float cameraX, float cameraY, float boardZ);
@@ -84,3 +91,8 @@ void imageMessageReceived(const sensor_msgs::ImageConstPtr& msg);
 void writeWorldCoordinatesToFile(FILE *fp_world_points, float cameraX, float cameraY, float boardZ, float boxsize, Size size);
 void delete_checkerboard();
 void deleteFiles(const char* data_dir);
+void imageMessageReceivedInMemory(const sensor_msgs::ImageConstPtr& msg);
+void getDefaultCheckerboardPoses(int numberOfViews, float cameraX, float cameraY, vector<checkerboardPoseType> &poses);
+int  readCheckerboardPoses(const char *filename, vector<checkerboardPoseType> &poses);
+int  captureCheckerboardCampaign(const char *sdf_filename, string configuration_filename, const vector<checkerboardPoseType> &poses,
+                                 FILE *fp_image_points, FILE *fp_world_points);
@@ -0,0 +1,120 @@
+/* 
+  Example use of openCV to classify the colours of an image with a trained look-up table
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+#endif
+     
+#include <sys/types.h> 
+#include <sys/timeb.h>
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "module5/fnv1a.h"
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+  
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif 
+    
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+using namespace cv;
+
+#define MAX_NUMBER_OF_CLASSES   16
+#define CLASS_NAME_LENGTH       20
+#define BACKGROUND               0     // class 0 is the background: every colour that is not one of the other classes
+#define UNASSIGNED             255     // cell of the look-up table with no class while the table is being compiled
+#define MIN_LUT_BITS             4     // bits per channel of the quantised BGR colour: 16, 32, or 64 levels
+#define MAX_LUT_BITS             6
+#define SAMPLE_RADIUS            2     // a click trains the classifier with the (2 r + 1) x (2 r + 1) pixels around it
+
+#define COLOUR_LUT_MAGIC   "M5CL"
+#define COLOUR_LUT_VERSION 1
+
+struct colourClassifierType {
+   int   bits;                                          // bits per channel: the table has 2^(3 bits) cells
+   int   number_of_classes;
+   char  names[MAX_NUMBER_OF_CLASSES][CLASS_NAME_LENGTH];
+   Vec3b display_colours[MAX_NUMBER_OF_CLASSES];        // mean BGR colour of the training samples of each class
+   vector<uchar> lut;                                   // class of each quantised colour, index (b << 2 bits) | (g << bits) | r
+};
+
+struct colourTrainingDataType {
+   int bits;
+   int number_of_classes;
+   vector<unsigned int> counts;                         // number of samples of each class in each cell, class-major
+   double sums[MAX_NUMBER_OF_CLASSES][3];               // sum of the BGR values of the samples of each class
+};
+
+struct colourLUTHeaderType {
+   char         magic[4];
+   unsigned int version;
+   unsigned int bits;
+   unsigned int number_of_classes;
+   unsigned int checksum;                               // FNV-1a hash of the data that follow the header
+   unsigned int reserved[3];                            // pads the header to 32 bytes
+};
+
+/* function prototypes go here */
+
+void initialiseTrainingData(colourTrainingDataType *training, int bits, int number_of_classes);
+int  addTrainingMask(const Mat &bgr_image, const Mat &mask, int class_id, colourTrainingDataType *training);
+int  addTrainingClick(const Mat &bgr_image, Point click, int class_id, colourTrainingDataType *training);
+void compileColourLUT(colourTrainingDataType *training, int min_samples, int fill_radius, colourClassifierType *classifier);
+void classifyColours(const Mat &bgr_image, const colourClassifierType *classifier, Mat &labels, bool use_simd);
+void labelsToColourImage(const Mat &labels, const colourClassifierType *classifier, Mat &colour_image);
+bool writeColourLUT(const char *filename, const colourClassifierType *classifier);
+bool readColourLUT(const char *filename, colourClassifierType *classifier);
+void trainFromClicks(const Mat &bgr_image, colourClassifierType *classifier, colourTrainingDataType *training);
+void prompt_and_exit(int status);
+void prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
@@ -0,0 +1,91 @@
+/* 
+  Example use of openCV to reduce the number of colours in an image
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+#endif
+     
+#include <sys/types.h> 
+#include <sys/timeb.h>
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+  
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif 
+    
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+using namespace cv;
+
+#define MAX_PALETTE_SIZE      256    // palette indices are stored as bytes
+#define PALETTE_LUT_BITS        5    // bits per channel of the nearest-palette look-up table: 32 x 32 x 32 cells
+#define KMEANS_BATCH_SIZE    1024    // pixels sampled in each mini-batch k-means iteration
+#define KMEANS_ITERATIONS     100
+
+struct paletteType {
+   vector<Vec3b> colours;
+   vector<uchar> lut;                // index of the nearest palette colour to the centre of each cell, index (b << 10) | (g << 5) | r
+};
+
+/* function prototypes go here */
+
+void changeQuantisation(const Mat &image, Mat &quantised_image, int bits);
+void changeQuantisationAt(const Mat &image, Mat &quantised_image, int bits);
+void computePalette(const Mat &image, int palette_size, paletteType *palette);
+void buildPaletteLUT(paletteType *palette);
+void quantiseToPalette(const Mat &image, const paletteType *palette, Mat &quantised_image, Mat &indices);
+void quantiseToPaletteAt(const Mat &image, const paletteType *palette, Mat &quantised_image);
+double meanSquaredError(const Mat &image1, const Mat &image2);
+void prompt_and_exit(int status);
+void prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
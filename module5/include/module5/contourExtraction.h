@@ -64,6 +64,9 @@ using namespace cv;
 /* function prototypes go here */
 
 void ContourExtraction(int, void*);
+void ContourExtractionTrackbar(int, void*);
+void update_contour_extraction();
+void reset_contour_cache();
 void prompt_and_exit(int status);
 void prompt_and_continue();
 
@@ -0,0 +1,244 @@
+/* 
+  Example use of openCV to track corner features in a video or simulator camera stream by sparse optical flow
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+#endif
+     
+#include <sys/types.h> 
+#include <sys/timeb.h>
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+  
+   #include <ros/ros.h>
+   #include <ros/package.h>
+   #include <ros/callback_queue.h>
+   #include <sensor_msgs/image_encodings.h>
+   #include <image_transport/image_transport.h>
+   #include <cv_bridge/cv_bridge.h>
+#endif 
+    
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+using namespace cv;
+
+#define SHI_TOMASI                0
+#define FAST_CORNERS              1
+#define CAPTURE_RING_CAPACITY     4      // frames waiting for the tracker
+#define CAPTURE_TIMEOUT           5.0    // s: a stream is finished when no frame has arrived for this long
+#define MAX_GRID_CELLS           64
+#define SIMULATOR_STREAM         "simulator"
+#define SIMULATOR_TOPIC          "/lynxmotion_al5d/external_vision/image_raw"
+
+
+/***************************************************************************************************************************
+
+   Capture ring buffer
+
+   A fixed number of frame slots allocated once; push() and pushLatest() copy a frame into a free slot and pop() swaps
+   the oldest slot with the caller's image, so that, once the slots and the caller's image have the size of the frames,
+   no image is allocated while a stream is processed.
+
+****************************************************************************************************************************/
+
+class captureRing {
+public:
+    captureRing(size_t capacity) : slots_(capacity), head_(0), count_(0), closed_(false), dropped_(0) {}
+
+    /* append a frame, waiting while the ring is full; returns false if the ring has been closed (use for video files) */
+
+    bool push(const Mat &frame) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || count_ < slots_.size(); });
+        if (closed_) return false;
+        frame.copyTo(slots_[(head_ + count_) % slots_.size()]);
+        count_++;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /* append a frame without waiting, overwriting the oldest frame if the ring is full (use for live cameras) */
+
+    void pushLatest(const Mat &frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) return;
+        if (count_ == slots_.size()) {
+            head_ = (head_ + 1) % slots_.size();
+            count_--;
+            dropped_++;
+        }
+        frame.copyTo(slots_[(head_ + count_) % slots_.size()]);
+        count_++;
+        not_empty_.notify_one();
+    }
+
+    /* take the oldest frame, waiting at most timeout seconds; returns false on timeout or when the ring is closed and empty */
+
+    bool pop(Mat &frame, double timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return closed_ || count_ > 0; });
+        if (count_ == 0) return false;
+        std::swap(frame, slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        count_--;
+        not_full_.notify_one();
+        return true;
+    }
+
+    /* no more frames: pop() returns the frames already in the ring and then false */
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    void reopen() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        head_    = 0;
+        count_   = 0;
+        closed_  = false;
+        dropped_ = 0;
+    }
+
+    long dropped() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+private:
+    vector<Mat>             slots_;
+    size_t                  head_;
+    size_t                  count_;
+    bool                    closed_;
+    long                    dropped_;
+    std::mutex              mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+
+/***************************************************************************************************************************
+
+   Feature tracker
+
+****************************************************************************************************************************/
+
+struct trackType {
+   int     id;                       // unique for the stream; a lost track is never reused
+   Point2f point;                    // position in the current frame
+   Point2f previous_point;           // position in the previous frame (equal to point in the frame of detection)
+   int     age;                      // number of frames in which the feature has been tracked
+};
+
+struct featureTrackerType {
+
+   /* parameters */
+
+   int    detector;                  // SHI_TOMASI or FAST_CORNERS
+   int    max_tracks;                // spread evenly over the grid cells
+   int    grid_columns;
+   int    grid_rows;
+   double redetect_fraction;         // detect again when fewer than this fraction of max_tracks are tracked
+   int    min_distance;              // pixels between a new corner and any other track
+   double quality_level;             // Shi-Tomasi: relative to the strongest corner in the cell
+   int    fast_threshold;            // FAST: intensity difference
+   int    window_size;               // Lucas-Kanade window, pixels
+   int    pyramid_levels;            // Lucas-Kanade pyramid levels above the full-resolution image
+   double max_backward_error;        // pixels: forward-backward check, 0 to disable
+
+   /* state, allocated for the first frame and reused for the following ones */
+
+   Mat             grey;
+   vector<Mat>     pyramid;          // current and previous pyramids, swapped after each frame
+   vector<Mat>     previous_pyramid;
+   vector<Point2f> previous_points;
+   vector<Point2f> points;
+   vector<Point2f> backward_points;
+   vector<uchar>   status;
+   vector<uchar>   backward_status;
+   vector<float>   error;
+   vector<trackType> tracks;
+   Mat             detection_mask;
+   vector<Point2f> corners;
+   vector<KeyPoint> keypoints;
+   int             next_id;
+   long            number_of_frames;
+   long            number_of_detections; // frames in which corners were detected
+};
+
+struct trackingStatisticsType {
+   long   number_of_frames;
+   long   dropped_frames;
+   double tracking_time;             // s, tracker only
+   double elapsed_time;              // s, first frame to last frame
+   double total_tracks;              // sum over the frames, for the mean number of tracks per frame
+};
+
+/* function prototypes go here */
+
+void   initialiseFeatureTracker(featureTrackerType *tracker);
+int    detectCorners(featureTrackerType *tracker);
+void   trackFeatures(featureTrackerType *tracker, const Mat &bgr_image);
+void   captureVideo(VideoCapture *video, captureRing *ring);
+void   trackStream(featureTrackerType *tracker, captureRing *ring, FILE *fp_out, const char *window_name, trackingStatisticsType *statistics);
+void   writeTrackFrame(FILE *fp_out, long frame_number, const vector<trackType> &tracks);
+void   drawTracks(Mat &image, const vector<trackType> &tracks);
+void   imageMessageReceived(const sensor_msgs::ImageConstPtr& msg);
+void   prompt_and_exit(int status);
+void   prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
@@ -0,0 +1,29 @@
+/* 
+  FNV-1a checksum of the binary files written by the cameraModel and colourClassification applications
+   
+  (This is an interface file shared by these applications: the function is defined here so that there is a single
+  definition of the checksum.)
+
+  16 October 2026
+*/
+
+#ifndef MODULE5_FNV1A_H
+#define MODULE5_FNV1A_H
+
+#include <stddef.h>
+
+/*
+ * fnv1a_checksum
+ * 32-bit FNV-1a hash of a block of memory; pass the hash of the previous block to checksum several blocks as one
+ */
+
+static inline unsigned int fnv1a_checksum(const unsigned char *data, size_t size, unsigned int hash = 2166136261u) {
+   size_t i;
+
+   for (i=0; i<size; i++) {
+      hash = (hash ^ data[i]) * 16777619u;
+   }
+   return hash;
+}
+
+#endif
@@ -63,6 +63,9 @@ using namespace cv;
 /* function prototypes go here */
 
 void performGrabCut(int, void*);  
+void reset_grabcut_model();
+void multiresolution_grabcut(Mat &image, Rect region, int iterations);
+void refine_boundary_band(Mat &image, int iterations);
 void getControlPoints( int event, int x, int y, int, void*);
 void prompt_and_exit(int status);
 void prompt_and_continue();
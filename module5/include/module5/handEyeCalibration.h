@@ -0,0 +1,101 @@
+/*
+  Example use of openCV to compute the hand-eye calibration of a robot and a camera
+  ---------------------------------------------------------------------------------
+
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+#endif
+
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif
+
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+#define EYE_TO_HAND 0                    // camera fixed, calibration grid held by the gripper: solve AX = ZB
+#define EYE_IN_HAND 1                    // camera mounted on the gripper, calibration grid fixed: solve AX = XB
+
+#define HAND_EYE_MIN_POSES          3    // at least two motions with non-parallel rotation axes are needed
+#define HAND_EYE_MIN_ROTATION       1.0  // degrees: relative motions with less rotation carry no information about the rotation axis
+#define HAND_EYE_ROTATION_WEIGHT  100.0  // mm per radian: weight of rotation errors relative to translation errors in the refinement
+#define HAND_EYE_MAX_ITERATIONS    50    // Levenberg-Marquardt iterations
+
+using namespace std;
+using namespace cv;
+
+struct handEyeStatisticsType {
+   double initial_rotation_error;      // RMS rotation error in degrees of the Tsai-Lenz solution
+   double initial_translation_error;   // RMS translation error in mm of the Tsai-Lenz solution
+   double rotation_error;              // RMS rotation error in degrees of the refined solution
+   double translation_error;           // RMS translation error in mm of the refined solution
+   int    number_of_motions;           // number of relative motions used by Tsai-Lenz
+   int    lm_iterations;               // number of Levenberg-Marquardt iterations
+   double tsai_lenz_time_ms;           // time to compute the closed-form solution
+   double refinement_time_ms;          // time to refine it
+};
+
+/* function prototypes go here */
+bool solveHandEyeTsaiLenz(const vector<Matx44d> &A, const vector<Matx44d> &B, Matx44d &X);
+bool solveHandEye(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, Matx44d &X, Matx44d &Z, handEyeStatisticsType *statistics);
+bool solveRobotWorldHandEye(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, Matx44d &X, Matx44d &Z, handEyeStatisticsType *statistics);
+void handEyeError(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, int configuration, const Matx44d &X, const Matx44d &Z, double *rotation_error, double *translation_error);
+Matx44d poseFromRotationTranslation(const Vec3d &rvec, const Vec3d &tvec);
+Matx44d invertPose(const Matx44d &T);
+int  readHandEyePosePairs(const char *filename, vector<Matx44d> &robotPoses, vector<Matx44d> &cameraPoses);
+bool writeHandEyeTransform(const char *filename, const Matx44d &X, const Matx44d &Z);
+bool readHandEyeTransform(const char *filename, Matx44d &X, Matx44d &Z);
+void generateSyntheticPosePairs(int numberOfPoses, int configuration, const Matx44d &X, const Matx44d &Z, double rotation_noise, double translation_noise, RNG &rng, vector<Matx44d> &robotPoses, vector<Matx44d> &cameraPoses);
+void benchmarkHandEye(int numberOfPoses, int configuration);
+void prompt_and_exit(int status);
+void prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
@@ -0,0 +1,105 @@
+/* 
+  Example use of openCV to perform mathematical morphology with large rectangular structuring elements
+   
+  (This is the interface file: it contains the declarations of dedicated functions to implement the application.
+  These function are called by client code in the application file. The functions are defined in the implementation file.)
+
+  16 October 2026
+*/
+ 
+
+
+#define GCC_COMPILER (defined(__GNUC__) && !defined(__clang__))
+
+#if GCC_COMPILER
+   #ifndef ROS
+       #define ROS
+   #endif
+   #ifndef ROS_PACKAGE_NAME
+      #define ROS_PACKAGE_NAME "module5"
+   #endif
+#endif
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <ctype.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef ROS
+   #include <conio.h>
+#else
+   #include <sys/select.h>
+   #include <termios.h>
+   #include <stropts.h>
+   #include <sys/ioctl.h>
+#endif
+     
+#include <sys/types.h> 
+#include <sys/timeb.h>
+
+//opencv
+#include <cv.h>
+#include <highgui.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#ifdef ROS
+   // ncurses.h must be included after opencv2/opencv.hpp to avoid incompatibility
+   #include <ncurses.h>
+  
+   #include <ros/ros.h>
+   #include <ros/package.h>
+#endif 
+    
+
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_STRING_LENGTH 80
+#define MAX_FILENAME_LENGTH 200
+
+using namespace std;
+using namespace cv;
+
+#define EROSION              0
+#define DILATION             1
+#define OPENING              2
+#define CLOSING              3
+#define GRADIENT             4
+#define TOP_HAT              5
+#define BLACK_HAT            6
+#define NUMBER_OF_OPERATIONS 7
+
+#define MAX_KERNEL_SIZE      101
+#define COLUMN_BAND_WIDTH    64     // columns processed by each task of the vertical pass
+
+/* buffers reused by successive operations; they are only reallocated when the image or kernel size changes */
+
+struct morphologyWorkspaceType {
+   Mat forward;                     // running minimum (or maximum) from the start of each block of the vertical pass
+   Mat backward;                    // running minimum (or maximum) from the end of each block of the vertical pass
+   Mat intermediate;                // result of the horizontal pass
+   Mat stage;                       // result of the first operation of a composition
+};
+
+/* function prototypes go here */
+
+void erodeRectangle(const Mat &image, Mat &eroded_image, Size kernel_size, morphologyWorkspaceType *workspace);
+void dilateRectangle(const Mat &image, Mat &dilated_image, Size kernel_size, morphologyWorkspaceType *workspace);
+void openRectangle(const Mat &image, Mat &opened_image, Size kernel_size, morphologyWorkspaceType *workspace);
+void closeRectangle(const Mat &image, Mat &closed_image, Size kernel_size, morphologyWorkspaceType *workspace);
+void morphologicalGradient(const Mat &image, Mat &gradient_image, Size kernel_size, morphologyWorkspaceType *workspace);
+void topHat(const Mat &image, Mat &top_hat_image, Size kernel_size, morphologyWorkspaceType *workspace);
+void blackHat(const Mat &image, Mat &black_hat_image, Size kernel_size, morphologyWorkspaceType *workspace);
+void applyMorphology(const Mat &image, Mat &result_image, int operation, Size kernel_size, morphologyWorkspaceType *workspace);
+void benchmarkMorphology(const Mat &image);
+void morphology(int, void*);
+void prompt_and_exit(int status);
+void prompt_and_continue();
+
+#ifdef ROS
+   int _kbhit();
+#endif
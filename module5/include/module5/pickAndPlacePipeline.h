@@ -0,0 +1,230 @@
+/*******************************************************************************************************************
+*   Vision-guided pick-and-place pipeline for a LynxMotion AL5D robot arm
+*
+*   Interface file
+*
+*   The robot control functions (move(), grasp(), pickAndPlace(), ...) are those of the moveRobot application;
+*   this application is built with moveRobotImplementation.cpp.
+*
+*   The brick detector is copied from the brickDetection application and the ground-plane mapping from the
+*   cameraInvPerspectiveMonocular application, so that the bricks are found and located in the same way.
+*
+*   16 October 2026
+*
+********************************************************************************************************************/
+
+#include <module5/moveRobot.h>
+
+#include <ros/callback_queue.h>
+
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+
+/***************************************************************************************************************************
+
+   Pipeline parameters
+
+****************************************************************************************************************************/
+
+#define FRAME_QUEUE_CAPACITY      2     // frames waiting for perception: the oldest is dropped when a new frame arrives
+#define POSE_QUEUE_CAPACITY       8     // brick poses waiting for the arm: perception blocks when the arm falls this far behind
+#define STABLE_FRAMES             3     // a brick must be seen at the same place in this many successive frames
+#define MATCH_DISTANCE           10.0   // mm: detections closer than this in successive frames are the same brick
+#define EXCLUSION_DISTANCE       30.0   // mm: detections this close to a brick already handed to the arm are ignored
+#define PLACE_SPACING            40.0   // mm: successive bricks of the same colour are placed this far apart in y
+#define IDLE_TIMEOUT             10.0   // s: stop when no brick has been found for this long
+#define ORIENTATION_OFFSET       10.0   // pixels: length of the principal axis segment mapped to the ground plane
+
+
+/***************************************************************************************************************************
+
+   Brick detector: copied from brickDetection.h
+
+****************************************************************************************************************************/
+
+#define MAX_NUMBER_OF_COLOURS 8
+#define COLOUR_NAME_LENGTH    20
+#define NO_COLOUR             255    // colour index of pixels that belong to none of the colours
+#define MIN_VALUE             50     // minimum HSV value of a brick pixel: darker pixels are not classified
+
+struct brickColourType {
+   char name[COLOUR_NAME_LENGTH];
+   int  hue_min;                     // OpenCV hue, 0 to 180; the range wraps through 0 if hue_min > hue_max
+   int  hue_max;
+   int  saturation_min;
+};
+
+struct brickDetectorType {
+   brickColourType colours[MAX_NUMBER_OF_COLOURS];
+   int    number_of_colours;
+   int    min_area;                  // pixels
+   int    max_area;
+   double min_aspect_ratio;          // ratio of the principal axis lengths
+   double max_aspect_ratio;
+   Mat    colour_lut;                // 180 x 256 colour index for each hue and saturation, built by buildColourLUT()
+};
+
+struct blobMomentsType {
+   double m00, m10, m01, m20, m11, m02;
+};
+
+struct brickType {
+   int   colour;                     // index into the colours of the detector
+   float u, v;                       // sub-pixel centroid
+   float phi;                        // orientation of the principal axis in degrees, -90 < phi <= 90, from the u axis towards the v axis
+   int   area;
+   float aspect_ratio;
+};
+
+
+/***************************************************************************************************************************
+
+   Bounded queue connecting two pipeline stages
+
+****************************************************************************************************************************/
+
+template <typename T>
+class boundedQueue {
+public:
+    boundedQueue(size_t capacity) : capacity_(capacity), closed_(false), dropped_(0) {}
+
+    /* append an item, waiting while the queue is full; returns false if the queue has been closed */
+
+    bool push(const T &item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || queue_.size() < capacity_; });
+        if (closed_) return false;
+        queue_.push_back(item);
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /* append an item without waiting, dropping the oldest item if the queue is full */
+
+    void pushLatest(const T &item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) return;
+        if (queue_.size() == capacity_) {
+            queue_.pop_front();
+            dropped_++;
+        }
+        queue_.push_back(item);
+        not_empty_.notify_one();
+    }
+
+    /* remove the oldest item, waiting at most timeout seconds; returns false on timeout or if the queue has been closed */
+
+    bool pop(T &item, double timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return closed_ || !queue_.empty(); });
+        if (closed_ || queue_.empty()) return false;
+        item = queue_.front();
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    bool closed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    long dropped() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+private:
+    std::deque<T>           queue_;
+    size_t                  capacity_;
+    bool                    closed_;
+    long                    dropped_;
+    std::mutex              mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+
+/***************************************************************************************************************************
+
+   Pipeline data
+
+****************************************************************************************************************************/
+
+struct frameType {
+    Mat    image;
+    double capture_time;               // s, pipelineTime() when the image was received
+};
+
+struct brickMessageType {
+    int       colour;                  // index into the colours of the pipeline
+    BrickPose pose;
+    double    capture_time;            // s, capture time of the frame in which the brick was confirmed
+    double    perceived_time;          // s, time at which the pose was handed to the arm
+};
+
+struct latencyType {
+    vector<double> frame_wait;         // ms, image received to perception started
+    vector<double> perception;         // ms, segmentation, blob geometry, and inverse perspective for one frame
+    vector<double> pose_wait;          // ms, pose handed to the arm to pick started
+    vector<double> execution;          // ms, pick and place
+    vector<double> end_to_end;         // ms, image received to brick placed
+};
+
+struct pipelineType {
+    pipelineType() : frames(FRAME_QUEUE_CAPACITY), poses(POSE_QUEUE_CAPACITY) {}
+
+    boundedQueue<frameType>        frames;
+    boundedQueue<brickMessageType> poses;
+
+    brickDetectorType detector;
+    BrickPose       destinations[MAX_NUMBER_OF_COLOURS];    // where bricks of each colour are placed
+    int             number_placed[MAX_NUMBER_OF_COLOURS];
+    float           object_z;                   // z of the bricks passed to pickAndPlace()
+    float           camera_model[3][4];         // from the cameraModel application; the bricks are located on the plane z = 0
+
+    std::mutex      mutex;                      // protects the data below
+    vector<Point2f> excluded;                   // positions of bricks handed to the arm and of placed bricks
+    latencyType     latency;
+    long            frames_received;
+    long            frames_processed;
+};
+
+
+/***************************************************************************************************************************
+
+   Function prototypes
+
+****************************************************************************************************************************/
+
+void   pickAndPlace(float object_x, float object_y, float object_z, float object_phi,
+                    float destination_x, float destination_y, float destination_z, float destination_phi);
+
+void   buildColourLUT(brickDetectorType *detector);
+void   classifyColours(const Mat &bgr_image, const Mat &colour_lut, Mat &colour_index);
+void   accumulateBlobMoments(const Mat &labels, const Mat &stats, int number_of_labels, vector<blobMomentsType> &moments);
+bool   brickFromMoments(const blobMomentsType &m, int colour, brickDetectorType *detector, brickType *brick);
+void   detectBricks(const Mat &bgr_image, brickDetectorType *detector, vector<brickType> &bricks);
+bool   computeGroundPlaneHomography(float camera_model[][4], float z, double inverse_homography[][3]);
+bool   inversePerspectiveTransformationBatch(const vector<Point2f> &image_points, float camera_model[][4], float z,
+                                             vector<Point3f> &world_points);
+
+double pipelineTime();
+void   locateBricks(const Mat &image, pipelineType *pipeline, vector<brickMessageType> &bricks);
+void   imageMessageReceived(const sensor_msgs::ImageConstPtr& msg);
+void   perceptionStage(pipelineType *pipeline);
+void   executionStage(pipelineType *pipeline, int max_bricks);
+void   printLatencyPercentiles(const char *stage, vector<double> samples);
+void   printPipelineReport(pipelineType *pipeline, double elapsed_time);
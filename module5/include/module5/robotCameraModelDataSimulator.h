@@ -33,6 +33,7 @@
 #include <iostream>
 #include <math.h>
 #include <vector>
+#include <algorithm>
 
 #ifdef ROS
 #include <sys/select.h>
@@ -61,6 +62,7 @@
 #include <cv.h>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
+#include <opencv2/calib3d.hpp>
 
 // CV Bridge includes
 #include <image_transport/image_transport.h>
@@ -310,4 +312,12 @@ void spawn_model(const char* sdf_filename, string model_name, float x, float y,
 void delete_model(string model_name);
 void writeWorldCoordinatesToFile(FILE *fp_world_points, float topleftX, float topleftY, Size2f boxsize, Size size);
 
+void imageMessageReceived(const sensor_msgs::ImageConstPtr& msg);
+void leave_field_of_view();
+bool servoToImagePoint(Point2f target, Matx22f jacobian, Point2f base, float radius, const Mat &background,
+                       float &x, float &y, int *iterations);
+bool collectControlPointsAutomatically(const char *checkerboard_sdf_filename, float cameraX, float cameraY, float cameraZ,
+                                       float boardZ, int nPointsX, int nPointsY, float boxsize, 
+                                       float controlPointCoordinates[2][2]);
+
 #endif
\ No newline at end of file
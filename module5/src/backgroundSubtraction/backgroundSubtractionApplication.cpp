@@ -0,0 +1,187 @@
+/* 
+  Example use of openCV to detect moving objects in a video by background subtraction
+  ------------------------------------------------------------------------------------
+  
+  This application reads the parameters of the background model from an input file backgroundSubtractionInput.txt:
+
+  - the model: 0 for a running Gaussian (mean and mean absolute deviation in 8.8 fixed point), 1 for an approximate median
+  - the learning rate of the running Gaussian, as a power of two: n gives a rate of 1 / 2^n
+  - the number of deviations from the background for a pixel to be foreground
+  - the minimum difference from the background, in grey levels, for a pixel to be foreground
+  - the minimum area of a moving object in pixels
+  - the filename of a background image and the number of frames for the benchmark
+
+  These are followed by a sequence of lines, each containing the filename of a video to be processed.
+
+  The benchmark runs the detector on a synthetic sequence of objects moving in front of the background image at
+  640 x 480 and 1920 x 1080 and reports the frames per second and the memory used.  Each video is then processed
+  frame by frame, displaying the moving objects and the foreground.
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/backgroundSubtraction.h"
+
+int main() {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "backgroundSubtractionInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+   char background_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   bool stopped;
+   int number_of_benchmark_frames;
+   unsigned int i;
+   long number_of_frames;
+   double ticks;
+   double time;
+
+   FILE *fp_in;
+
+   backgroundModelType model;
+   vector<Rect> blobs;
+   VideoCapture video;
+   Mat background_image, frame;
+
+   const char* video_window_name      = "Moving Objects";
+   const char* foreground_window_name = "Foreground";
+   
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input backgroundSubtractionInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Example of how to use openCV to detect moving objects by background subtraction.\n\n");
+
+   end_of_file = fscanf(fp_in, "%d %d %d %d %d %s %d", &model.method, &model.learning_shift, &model.deviations,
+                        &model.min_difference, &model.min_area, background_filename, &number_of_benchmark_frames);
+
+   if (end_of_file != 7 || (model.method != RUNNING_GAUSSIAN && model.method != APPROXIMATE_MEDIAN) ||
+       model.learning_shift < 0 || model.learning_shift > 15 || model.deviations < 1) {
+      printf("Error can't read the parameters of the background model from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   if (debug) printf("%s, learning rate 1/%d, %d deviations, minimum difference %d, minimum area %d\n\n",
+                     model.method == RUNNING_GAUSSIAN ? "running Gaussian" : "approximate median", 1 << model.learning_shift,
+                     model.deviations, model.min_difference, model.min_area);
+
+   /* benchmark */
+
+   strcpy(file_path_and_filename, data_dir);
+   strcat(file_path_and_filename, background_filename);
+
+   background_image = imread(file_path_and_filename, CV_LOAD_IMAGE_COLOR);
+   if (background_image.empty()) {
+      cout << "can not open " << file_path_and_filename << endl;
+      prompt_and_exit(-1);
+   }
+
+   printf("Benchmark: %d frames of %s with moving objects, %d threads\n", number_of_benchmark_frames, background_filename, getNumThreads());
+   benchmarkBackgroundSubtraction(&model, background_image, Size(640, 480),   number_of_benchmark_frames);
+   benchmarkBackgroundSubtraction(&model, background_image, Size(1920, 1080), number_of_benchmark_frames);
+   printf("\n");
+
+   /* videos */
+
+   do {
+      end_of_file = fscanf(fp_in, "%s", filename);
+
+      if (end_of_file != EOF) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         video.open(file_path_and_filename);
+         if (!video.isOpened()) {
+            cout << "can not open " << file_path_and_filename << endl;
+            prompt_and_exit(-1);
+         }
+
+         printf("%s: press any key to stop\n", filename);
+
+         namedWindow(video_window_name,      CV_WINDOW_AUTOSIZE);
+         namedWindow(foreground_window_name, CV_WINDOW_AUTOSIZE);
+
+         model.mean.release();                 // start a new model for each video
+         number_of_frames = 0;
+         time    = 0;
+         stopped = false;
+
+         while (!stopped) {
+            video >> frame;
+            if (frame.empty()) break;
+
+            ticks = (double) getTickCount();
+            detectMotion(&model, frame, blobs);
+            time += (double) getTickCount() - ticks;
+            number_of_frames++;
+
+            for (i = 0; i < blobs.size(); i++) {
+               rectangle(frame, blobs[i], Scalar(0, 255, 0), 2);
+            }
+
+            imshow(video_window_name, frame);
+            imshow(foreground_window_name, model.cleaned.empty() ? model.foreground : model.cleaned);
+            waitKey(1);
+
+            if (_kbhit()) {
+               getchar(); // flush the buffer from the keyboard hit
+               stopped = true;
+            }
+         }
+         video.release();
+
+         destroyWindow(video_window_name);
+         destroyWindow(foreground_window_name);
+
+         if (number_of_frames > 0) {
+            time = time / getTickFrequency();
+            printf("%s: %ld frames of %d x %d, %.1f frames per second, model %.1f MB\n\n", filename, number_of_frames,
+                   model.grey.cols, model.grey.rows, number_of_frames / time, backgroundModelMemory(&model) / 1048576.0);
+         }
+      }
+   } while (end_of_file != EOF);
+
+   fclose(fp_in);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
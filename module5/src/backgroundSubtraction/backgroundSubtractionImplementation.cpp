@@ -0,0 +1,409 @@
+/* 
+  Example use of openCV to detect moving objects in a video by background subtraction
+  ------------------------------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/backgroundSubtraction.h"
+
+
+/*=======================================================*/
+/* Background model                                      */
+/*=======================================================*/
+
+/*
+ * initialiseBackgroundModel
+ * Allocate the model for the size of the first frame and start it from that frame
+ */
+
+void initialiseBackgroundModel(backgroundModelType *model, const Mat &grey_image) {
+
+   CV_Assert(grey_image.type() == CV_8UC1);
+
+   if (model->method == RUNNING_GAUSSIAN) {
+      grey_image.convertTo(model->mean, CV_16U, 256);
+      model->deviation.create(grey_image.size(), CV_16U);
+      model->deviation.setTo(Scalar(model->min_difference * 256));
+   }
+   else {
+      grey_image.copyTo(model->mean);
+      model->deviation.create(grey_image.size(), CV_8U);
+      model->deviation.setTo(Scalar(MIN_MEDIAN_DEVIATION));
+   }
+
+   model->foreground.create(grey_image.size(), CV_8U);
+   model->foreground.setTo(Scalar(0));
+   model->number_of_frames = 0;
+}
+
+
+/*
+ * Parallel body for updateBackgroundModel: each row is independent and sixteen pixels are processed at a time with SIMD.
+ *
+ * Running Gaussian: the mean M and the mean absolute deviation S of each pixel are kept in 8.8 fixed point and
+ * updated with M += (256 I - M) / 2^a and S += (|256 I - M| - S) / 2^a, using saturating unsigned arithmetic
+ * so that the signed differences are never formed.  A pixel is foreground if |256 I - M| > k S.
+ *
+ * Approximate median (sigma-delta): the median estimate M moves one grey level towards I and the deviation V one
+ * grey level towards k |I - M| in each frame.  A pixel is foreground if |I - M| >= V.
+ */
+
+class BackgroundUpdateBody : public ParallelLoopBody {
+public:
+   BackgroundUpdateBody(backgroundModelType *model, const Mat &grey, Mat &foreground) : model_(model), grey_(grey), foreground_(foreground) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      if (model_->method == RUNNING_GAUSSIAN) {
+         runningGaussian(range);
+      }
+      else {
+         approximateMedian(range);
+      }
+   }
+
+private:
+
+   /* saturating 16-bit arithmetic for the scalar tail */
+
+   static inline int subtract16(int a, int b) { return a > b ? a - b : 0; }
+   static inline int add16(int a, int b)      { return min(a + b, 65535); }
+
+   void runningGaussian(const Range &range) const {
+      int shift = model_->learning_shift;
+      int k = model_->deviations;
+      int min_difference = model_->min_difference * 256;
+      int row, col, j;
+
+      for (row = range.start; row < range.end; row++) {
+         const uchar *in  = grey_.ptr<uchar>(row);
+         ushort      *m   = model_->mean.ptr<ushort>(row);
+         ushort      *s   = model_->deviation.ptr<ushort>(row);
+         uchar       *out = foreground_.ptr<uchar>(row);
+         col = 0;
+
+#if CV_SIMD128
+         v_uint16x8 min_diff = v_setall_u16((ushort) min_difference);
+         v_uint16x8 i[2], mean, dev, up, down, d, threshold, fg[2];
+         int h;
+
+         for ( ; col <= grey_.cols - 16; col += 16) {
+            v_expand(v_load(in + col), i[0], i[1]);
+
+            for (h = 0; h < 2; h++) {
+               i[h]  = i[h] << 8;
+               mean  = v_load(m + col + 8 * h);
+               dev   = v_load(s + col + 8 * h);
+
+               up    = i[h] - mean;                   // saturating: zero unless I is above the mean
+               down  = mean - i[h];
+               d     = up + down;                     // |256 I - M|
+
+               threshold = dev;
+               for (j = 1; j < k; j++) threshold = threshold + dev;
+               fg[h] = (d > threshold) & (d > min_diff);
+
+               v_store(m + col + 8 * h, (mean + (up >> shift)) - (down >> shift));
+               v_store(s + col + 8 * h, (dev + ((d - dev) >> shift)) - ((dev - d) >> shift));
+            }
+
+            v_store(out + col, v_pack(fg[0], fg[1]));
+         }
+#endif
+
+         for ( ; col < grey_.cols; col++) {
+            int value = in[col] << 8;
+            int up    = subtract16(value, m[col]);
+            int down  = subtract16(m[col], value);
+            int d     = up + down;
+
+            out[col] = d > min(k * s[col], 65535) && d > min_difference ? 255 : 0;
+
+            m[col] = (ushort) subtract16(add16(m[col], up >> shift), down >> shift);
+            s[col] = (ushort) subtract16(add16(s[col], subtract16(d, s[col]) >> shift), subtract16(s[col], d) >> shift);
+         }
+      }
+   }
+
+   void approximateMedian(const Range &range) const {
+      int k = model_->deviations;
+      int min_difference = model_->min_difference;
+      int row, col, j;
+
+      for (row = range.start; row < range.end; row++) {
+         const uchar *in  = grey_.ptr<uchar>(row);
+         uchar       *m   = model_->mean.ptr<uchar>(row);
+         uchar       *v   = model_->deviation.ptr<uchar>(row);
+         uchar       *out = foreground_.ptr<uchar>(row);
+         col = 0;
+
+#if CV_SIMD128
+         v_uint8x16 one      = v_setall_u8(1);
+         v_uint8x16 zero     = v_setall_u8(0);
+         v_uint8x16 min_dev  = v_setall_u8(MIN_MEDIAN_DEVIATION);
+         v_uint8x16 max_dev  = v_setall_u8(MAX_MEDIAN_DEVIATION);
+         v_uint8x16 min_diff = v_setall_u8((uchar) min_difference);
+         v_uint8x16 i, median, dev, d, kd, changed;
+
+         for ( ; col <= grey_.cols - 16; col += 16) {
+            i      = v_load(in + col);
+            median = v_load(m + col);
+            dev    = v_load(v + col);
+
+            median = (median + ((i > median) & one)) - ((i < median) & one);
+            d      = v_absdiff(i, median);
+
+            kd = d;
+            for (j = 1; j < k; j++) kd = kd + d;       // saturating
+
+            changed = d > zero;
+            dev = (dev + ((kd > dev) & changed & one)) - ((kd < dev) & changed & one);
+            dev = v_min(v_max(dev, min_dev), max_dev);
+
+            v_store(m + col, median);
+            v_store(v + col, dev);
+            v_store(out + col, ~(d < dev) & (d > min_diff));
+         }
+#endif
+
+         for ( ; col < grey_.cols; col++) {
+            if (in[col] > m[col]) m[col]++;
+            else if (in[col] < m[col]) m[col]--;
+
+            int d  = abs(in[col] - m[col]);
+            int kd = min(k * d, 255);
+
+            if (d != 0) {
+               if (kd > v[col]) v[col]++;
+               else if (kd < v[col]) v[col]--;
+            }
+            v[col] = (uchar) min(max((int) v[col], MIN_MEDIAN_DEVIATION), MAX_MEDIAN_DEVIATION);
+
+            out[col] = d >= v[col] && d > min_difference ? 255 : 0;
+         }
+      }
+   }
+
+   backgroundModelType *model_;
+   const Mat           &grey_;
+   Mat                 &foreground_;
+};
+
+
+/*
+ * updateBackgroundModel
+ * Classify each pixel of the next frame as foreground (255) or background (0) and update the model
+ */
+
+void updateBackgroundModel(backgroundModelType *model, const Mat &grey_image, Mat &foreground) {
+
+   CV_Assert(grey_image.type() == CV_8UC1 && grey_image.size() == model->mean.size());
+
+   foreground.create(grey_image.size(), CV_8U);
+   parallel_for_(Range(0, grey_image.rows), BackgroundUpdateBody(model, grey_image, foreground));
+
+   model->number_of_frames++;
+}
+
+
+/*
+ * detectMotion
+ * Bounding boxes of the moving objects in the next frame: background subtraction, an opening to remove isolated
+ * pixels and a closing to fill small holes, then the connected components of at least min_area pixels.
+ * All images are kept in the model, so no memory is allocated after the first frame.
+ */
+
+void detectMotion(backgroundModelType *model, const Mat &bgr_image, vector<Rect> &blobs) {
+
+   static Mat opening_element = getStructuringElement(MORPH_RECT, Size(3, 3));
+   static Mat closing_element = getStructuringElement(MORPH_RECT, Size(5, 5));
+   int number_of_labels, l;
+
+   blobs.clear();
+
+   if (bgr_image.channels() == 3) {
+      cvtColor(bgr_image, model->grey, CV_BGR2GRAY);
+   }
+   else {
+      bgr_image.copyTo(model->grey);
+   }
+
+   if (model->mean.empty() || model->mean.size() != model->grey.size()) {
+      initialiseBackgroundModel(model, model->grey);
+      return;
+   }
+
+   updateBackgroundModel(model, model->grey, model->foreground);
+
+   morphologyEx(model->foreground, model->cleaned, MORPH_OPEN,  opening_element);
+   morphologyEx(model->cleaned,    model->cleaned, MORPH_CLOSE, closing_element);
+
+   number_of_labels = connectedComponentsWithStats(model->cleaned, model->labels, model->stats, model->centroids, 8, CV_32S);
+
+   for (l = 1; l < number_of_labels; l++) {
+      if (model->stats.at<int>(l, CC_STAT_AREA) >= model->min_area) {
+         blobs.push_back(Rect(model->stats.at<int>(l, CC_STAT_LEFT),  model->stats.at<int>(l, CC_STAT_TOP),
+                              model->stats.at<int>(l, CC_STAT_WIDTH), model->stats.at<int>(l, CC_STAT_HEIGHT)));
+      }
+   }
+}
+
+
+/*
+ * backgroundModelMemory
+ * Bytes of image memory held by the model
+ */
+
+size_t backgroundModelMemory(const backgroundModelType *model) {
+
+   const Mat *images[] = {&model->mean, &model->deviation, &model->grey, &model->foreground, &model->cleaned,
+                          &model->labels, &model->stats, &model->centroids};
+   size_t bytes = 0;
+   unsigned int i;
+
+   for (i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+      bytes += images[i]->total() * images[i]->elemSize();
+   }
+   return bytes;
+}
+
+
+/*
+ * peakResidentMemory
+ * Peak resident memory of the process in kB, or -1 if it is not available
+ */
+
+long peakResidentMemory() {
+
+#ifdef ROS
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage) == 0) {
+      return usage.ru_maxrss;
+   }
+#endif
+   return -1;
+}
+
+
+/*
+ * benchmarkBackgroundSubtraction
+ * Frames per second and memory of detectMotion() on a synthetic sequence of a given size: the background image
+ * with sensor noise and two objects moving across it
+ */
+
+void benchmarkBackgroundSubtraction(backgroundModelType *parameters, const Mat &background_image, Size frame_size, int number_of_frames) {
+
+   const int number_of_noisy_backgrounds = 4;
+   backgroundModelType model;
+   vector<Mat> backgrounds(number_of_noisy_backgrounds);
+   Mat noise, frame;
+   vector<Rect> blobs;
+   double ticks, time = 0;
+   long memory_before = -1, memory_after;
+   long number_of_blobs = 0;
+   int f, x, y, radius;
+
+   model.method         = parameters->method;
+   model.learning_shift = parameters->learning_shift;
+   model.deviations     = parameters->deviations;
+   model.min_difference = parameters->min_difference;
+   model.min_area       = parameters->min_area;
+
+   for (f = 0; f < number_of_noisy_backgrounds; f++) {
+      resize(background_image, backgrounds[f], frame_size);
+      noise.create(frame_size, CV_16SC3);
+      randn(noise, Scalar::all(0), Scalar::all(3));
+      add(backgrounds[f], noise, backgrounds[f], noArray(), CV_8UC3);
+   }
+
+   radius = frame_size.height / 12;
+
+   for (f = 0; f < number_of_frames; f++) {
+      backgrounds[f % number_of_noisy_backgrounds].copyTo(frame);
+
+      if (f >= number_of_frames / 4) {     // the model learns the empty scene first
+         x = (f * frame_size.width / number_of_frames) % frame_size.width;
+         y = frame_size.height / 2;
+         rectangle(frame, Rect(x, y - radius, radius, 2 * radius), Scalar(40, 40, 160), CV_FILLED);
+         circle(frame, Point(frame_size.width - x, y + 2 * radius), radius, Scalar(200, 200, 200), CV_FILLED);
+      }
+
+      if (f == 1) memory_before = peakResidentMemory();   // after the model has been allocated
+
+      ticks = (double) getTickCount();
+      detectMotion(&model, frame, blobs);
+      time += (double) getTickCount() - ticks;
+
+      if (f >= number_of_frames / 4) number_of_blobs += blobs.size();
+   }
+
+   memory_after = peakResidentMemory();
+   time = time / getTickFrequency();
+
+   printf("   %4d x %-4d %6.1f frames per second, %.2f ms per frame, %.1f blobs per frame, model %.1f MB",
+          frame_size.width, frame_size.height, number_of_frames / time, time * 1000 / number_of_frames,
+          (double) number_of_blobs / (number_of_frames - number_of_frames / 4), backgroundModelMemory(&model) / 1048576.0);
+
+   if (memory_after >= 0 && memory_before >= 0) {
+      printf(", peak resident memory %.1f MB (+%.1f MB after the first frame)", memory_after / 1024.0, (memory_after - memory_before) / 1024.0);
+   }
+   printf("\n");
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
@@ -5,6 +5,14 @@
   This application reads a sequence lines from an input file binaryThresholdingInput.txt.
   Each line contains a filename of an image to be processed. 
 
+  The threshold is either global, set with the Threshold trackbar, or adaptive (Method trackbar: 0 global, 1 Bradley,
+  2 Sauvola), computed for each pixel from the mean and standard deviation of the window around it, with the
+  window radius and sensitivity set with the Radius and Sensitivity trackbars.
+
+  In batch mode (binaryThresholding batch), the application instead reads binaryThresholdingBatchInput.txt, in which each
+  line contains the filename of an image, the method, the window radius, the sensitivity (or the threshold for the
+  global method), and the filename of the thresholded image to be written, and reports the time taken for each image.
+
   It is assumed that the input file is located in a data directory given by the path ../data/ 
   defined relative to the location of executable for this application.
 
@@ -24,6 +32,9 @@
   Abrham Gebreselasie
   10 March 2021
   
+  Added adaptive thresholding (Bradley and Sauvola) and batch mode
+  16 October 2026
+
 
 */
 
@@ -34,12 +45,15 @@
 
 Mat inputImage;
 int thresholdValue            = 128; // default threshold
+int thresholdMethod           = GLOBAL_THRESHOLD;
+int windowRadius              = 15;  // default adaptive threshold window 31 x 31
+int sensitivityValue          = 15;  // default adaptive threshold sensitivity, percent
 
 const char* input_window_name       = "Input Image";
 const char* thresholded_window_name = "Thresholded Image";
 
 
-int main() {
+int main(int argc, char **argv) {
    
    #ifdef ROS
       // Turn off canonical terminal mode and character echoing
@@ -59,9 +73,17 @@ int main() {
          
    int end_of_file;
    bool debug = true;
+   bool batch = argc > 1 && strcmp(argv[1], "batch") == 0;
    char filename[MAX_FILENAME_LENGTH];
+   char output_filename[MAX_FILENAME_LENGTH];
+   int  method, radius, sensitivity;
+   double ticks;
+   Mat greyscaleImage, thresholdedImage;
 
    int const max_threshold     = 255; 
+   int const max_method        = 2;
+   int const max_radius        = 100;
+   int const max_sensitivity   = 100;
 
    FILE *fp_in;
 
@@ -76,14 +98,64 @@ int main() {
    
    strcat(data_dir, "/data/");
    strcpy(input_path_and_filename, data_dir);
-   strcat(input_path_and_filename, input_filename);
+   if (batch) {
+      strcat(input_path_and_filename, "binaryThresholdingBatchInput.txt");
+   }
+   else {
+      strcat(input_path_and_filename, input_filename);
+   }
    
 
    if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
-	  printf("Error can't open input file binaryThresholdingInput.txt\n");
+	  printf("Error can't open input file %s\n", batch ? "binaryThresholdingBatchInput.txt" : input_filename);
      prompt_and_exit(1);
    }
 
+   if (batch) {
+
+      /* batch mode: threshold each image with the given parameters and write the result */
+
+      while (fscanf(fp_in, "%s %d %d %d %s", filename, &method, &radius, &sensitivity, output_filename) == 5) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         greyscaleImage = imread(file_path_and_filename, CV_LOAD_IMAGE_GRAYSCALE);
+         if(greyscaleImage.empty()) {
+            cout << "can not open " << filename << endl;
+            prompt_and_exit(-1);
+         }
+
+         ticks = (double) getTickCount();
+         if (method == GLOBAL_THRESHOLD) {
+            threshold(greyscaleImage, thresholdedImage, sensitivity - 1, 255, THRESH_BINARY);
+         }
+         else {
+            adaptiveThresholding(greyscaleImage, thresholdedImage, method, max(radius, 1), sensitivity);
+         }
+         ticks = ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, output_filename);
+         if (!imwrite(file_path_and_filename, thresholdedImage)) {
+            printf("Error can't write %s\n", output_filename);
+            prompt_and_exit(1);
+         }
+
+         printf("%s: %d x %d, method %d, window %d x %d, %.2f ms -> %s\n", filename, greyscaleImage.cols, greyscaleImage.rows,
+                method, 2 * radius + 1, 2 * radius + 1, ticks, output_filename);
+      }
+
+      fclose(fp_in);
+
+      if (debug) prompt_and_continue();
+
+      #ifdef ROS
+         // Reset terminal
+         tcsetattr(STDIN, TCSANOW, &old_term);
+      #endif
+      return 0;
+   }
+
    do {
 
       end_of_file = fscanf(fp_in, "%s", filename);
@@ -109,6 +181,9 @@ int main() {
          resizeWindow(thresholded_window_name,0,0); // this forces the trackbar to be as small as possible (and to fit in the window)
 
          createTrackbar( "Threshold", thresholded_window_name, &thresholdValue, max_threshold, binaryThresholding);
+         createTrackbar( "Method", thresholded_window_name, &thresholdMethod, max_method, binaryThresholding);
+         createTrackbar( "Radius", thresholded_window_name, &windowRadius, max_radius, binaryThresholding);
+         createTrackbar( "Sensitivity", thresholded_window_name, &sensitivityValue, max_sensitivity, binaryThresholding);
 
          // Show the image
          binaryThresholding(0, 0);
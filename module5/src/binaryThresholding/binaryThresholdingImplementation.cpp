@@ -12,6 +12,9 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Added adaptive thresholding with integral images (Bradley and Sauvola)
+  16 October 2026
     
 */
  
@@ -26,6 +29,9 @@ void binaryThresholding(int, void*) {
 
    extern Mat inputImage; 
    extern int thresholdValue; 
+   extern int thresholdMethod;
+   extern int windowRadius;
+   extern int sensitivityValue;
    extern char* thresholded_window_name;
    Mat greyscaleImage;
    Mat thresholdedImage; 
@@ -41,6 +47,15 @@ void binaryThresholding(int, void*) {
       greyscaleImage = inputImage.clone();
    }
 
+   if (thresholdMethod != GLOBAL_THRESHOLD) {
+      if (windowRadius < 1)  // the trackbar has a lower value of 0 which is invalid
+         windowRadius = 1;
+
+      adaptiveThresholding(greyscaleImage, thresholdedImage, thresholdMethod, windowRadius, sensitivityValue);
+      imshow(thresholded_window_name, thresholdedImage);
+      return;
+   }
+
    thresholdedImage.create(greyscaleImage.size(), CV_8UC1);
    
 	for (row=0; row < greyscaleImage.rows; row++) {
@@ -62,6 +77,153 @@ void binaryThresholding(int, void*) {
    imshow(thresholded_window_name, thresholdedImage);
 }
 
+
+/*
+ * function computeIntegralImages
+ * Integral image (CV_32S, used as unsigned) and integral of squares (CV_64F) of an 8-bit image, both (rows+1) x (cols+1),
+ * in one pass: the running sums along each row are added to the row above sixteen bytes at a time with SIMD.
+ * The 32-bit sums may wrap for very large images but the difference of four of them, i.e. the sum over any window
+ * of up to 2^24 pixels, is still exact in unsigned arithmetic.
+*/
+
+void computeIntegralImages(const Mat &greyscaleImage, Mat &sumImage, Mat &squaredSumImage) {
+
+   int row, col;
+   unsigned int rowSum;
+   double rowSquaredSum;
+
+   CV_Assert(greyscaleImage.type() == CV_8UC1);
+
+   sumImage.create(greyscaleImage.rows + 1, greyscaleImage.cols + 1, CV_32S);
+   squaredSumImage.create(greyscaleImage.rows + 1, greyscaleImage.cols + 1, CV_64F);
+
+   sumImage.row(0).setTo(Scalar(0));
+   squaredSumImage.row(0).setTo(Scalar(0));
+
+   for (row=0; row < greyscaleImage.rows; row++) {
+      const uchar  *grey           = greyscaleImage.ptr<uchar>(row);
+      const unsigned int *above    = sumImage.ptr<unsigned int>(row);
+      unsigned int *sum            = sumImage.ptr<unsigned int>(row + 1);
+      const double *squaredAbove   = squaredSumImage.ptr<double>(row);
+      double       *squaredSum     = squaredSumImage.ptr<double>(row + 1);
+
+      /* running sums along the row */
+
+      sum[0]        = 0;
+      squaredSum[0] = 0;
+      rowSum        = 0;
+      rowSquaredSum = 0;
+      for (col=0; col < greyscaleImage.cols; col++) {
+         rowSum        += grey[col];
+         rowSquaredSum += grey[col] * grey[col];
+         sum[col + 1]        = rowSum;
+         squaredSum[col + 1] = rowSquaredSum;
+      }
+
+      /* add the row above */
+
+      col = 0;
+#if CV_SIMD128
+      for ( ; col <= greyscaleImage.cols + 1 - 4; col += 4) {
+         v_store(sum + col, v_load(sum + col) + v_load(above + col));
+      }
+#endif
+      for ( ; col <= greyscaleImage.cols; col++) {
+         sum[col] += above[col];
+      }
+
+      col = 0;
+#if CV_SIMD128_64F
+      for ( ; col <= greyscaleImage.cols + 1 - 2; col += 2) {
+         v_store(squaredSum + col, v_load(squaredSum + col) + v_load(squaredAbove + col));
+      }
+#endif
+      for ( ; col <= greyscaleImage.cols; col++) {
+         squaredSum[col] += squaredAbove[col];
+      }
+   }
+}
+
+
+/*
+ * Parallel body for adaptiveThresholding: each band of rows is thresholded independently.
+ * The mean (and for Sauvola the variance) of the (2 r + 1) x (2 r + 1) window centred on each pixel, clipped at the
+ * borders of the image, is computed from four values of the integral images, whatever the size of the window.
+*/
+
+class AdaptiveThresholdBody : public ParallelLoopBody {
+public:
+   AdaptiveThresholdBody(const Mat &grey, const Mat &sum, const Mat &squaredSum, Mat &thresholded, int method, int radius, int sensitivity) :
+      grey_(grey), sum_(sum), squaredSum_(squaredSum), thresholded_(thresholded), method_(method), radius_(radius), sensitivity_(sensitivity) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int row, col, x0, x1, y0, y1, count;
+      unsigned int windowSum;
+      double mean, variance, threshold;
+      double k = sensitivity_ / 100.0;
+
+      for (row = range.start; row < range.end; row++) {
+         const uchar *grey = grey_.ptr<uchar>(row);
+         uchar *out        = thresholded_.ptr<uchar>(row);
+
+         y0 = max(row - radius_, 0);
+         y1 = min(row + radius_ + 1, grey_.rows);
+
+         const unsigned int *sumTop    = sum_.ptr<unsigned int>(y0);
+         const unsigned int *sumBottom = sum_.ptr<unsigned int>(y1);
+         const double *squaredTop      = squaredSum_.ptr<double>(y0);
+         const double *squaredBottom   = squaredSum_.ptr<double>(y1);
+
+         for (col = 0; col < grey_.cols; col++) {
+            x0 = max(col - radius_, 0);
+            x1 = min(col + radius_ + 1, grey_.cols);
+            count = (x1 - x0) * (y1 - y0);
+
+            windowSum = sumBottom[x1] - sumBottom[x0] - sumTop[x1] + sumTop[x0];
+
+            if (method_ == BRADLEY_THRESHOLD) {
+               out[col] = (long long) grey[col] * count * 100 <= (long long) windowSum * (100 - sensitivity_) ? 0 : 255;
+            }
+            else {
+               mean      = (double) windowSum / count;
+               variance  = (squaredBottom[x1] - squaredBottom[x0] - squaredTop[x1] + squaredTop[x0]) / count - mean * mean;
+               threshold = mean * (1 + k * (sqrt(max(variance, 0.0)) / SAUVOLA_RANGE - 1));
+               out[col]  = grey[col] <= threshold ? 0 : 255;
+            }
+         }
+      }
+   }
+
+private:
+   const Mat &grey_;
+   const Mat &sum_;
+   const Mat &squaredSum_;
+   Mat       &thresholded_;
+   int        method_;
+   int        radius_;
+   int        sensitivity_;
+};
+
+
+/*
+ * function adaptiveThresholding
+ * Threshold each pixel of an 8-bit image against the statistics of the window around it:
+ * BRADLEY_THRESHOLD or SAUVOLA_THRESHOLD, window (2 windowRadius + 1) x (2 windowRadius + 1), sensitivity in percent
+*/
+
+void adaptiveThresholding(const Mat &greyscaleImage, Mat &thresholdedImage, int method, int windowRadius, int sensitivity) {
+
+   Mat sumImage;
+   Mat squaredSumImage;
+
+   computeIntegralImages(greyscaleImage, sumImage, squaredSumImage);
+
+   thresholdedImage.create(greyscaleImage.size(), CV_8UC1);
+   parallel_for_(Range(0, greyscaleImage.rows),
+                 AdaptiveThresholdBody(greyscaleImage, sumImage, squaredSumImage, thresholdedImage, method, windowRadius, sensitivity));
+}
+
 void prompt_and_exit(int status) {
    printf("Press any key to continue and close terminal ... \n");
    getchar();
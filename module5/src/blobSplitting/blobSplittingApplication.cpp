@@ -0,0 +1,183 @@
+/* 
+  Example use of openCV to split touching blobs with the distance transform and the watershed
+  -------------------------------------------------------------------------------------------
+  
+  This application reads the parameters of the blob splitting from the first line of an input file blobSplittingInput.txt:
+  the minimum radius of a blob and the separation of the markers, both in pixels.
+
+  This is followed by a sequence of lines, each containing the filename of an image to be processed, the threshold
+  (0 to select it automatically with Otsu's method), and the polarity of the blobs (0 if they are brighter than the
+  background, 1 if they are darker).
+
+  Each image is thresholded and the Euclidean distance from each foreground pixel to the background is computed.
+  A marker is placed at each maximum of the distance map, i.e. at the centre of each round object, and the markers are
+  grown over the foreground in order of decreasing distance, so that touching blobs are separated at the necks between
+  them.  The number of connected components and of blobs after splitting are reported, together with the time taken
+  and a comparison of the distance transform with openCV distanceTransform().
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/blobSplitting.h"
+
+int main() {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "blobSplittingInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   int threshold_value;
+   int polarity;
+   int number_of_labels;
+   int l;
+   double ticks;
+   double opencv_time;
+   double max_difference;
+
+   FILE *fp_in;
+
+   blobSplittingParametersType parameters;
+   blobSplittingStatisticsType statistics;
+   Mat image, greyscale_image, binary_image;
+   Mat labels, stats, centroids;
+   Mat distance_image, opencv_distance_image;
+   Mat label_image;
+
+   const char* input_window_name  = "Input Image";
+   const char* binary_window_name = "Thresholded Image";
+   const char* blobs_window_name  = "Blobs";
+   
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input blobSplittingInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Example of how to use openCV to split touching blobs.\n\n");
+
+   end_of_file = fscanf(fp_in, "%f %d", &parameters.min_radius, &parameters.separation);
+
+   if (end_of_file != 2 || parameters.separation < 1) {
+      printf("Error can't read the minimum radius and the separation from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   if (debug) printf("minimum radius %.1f, separation %d\n\n", parameters.min_radius, parameters.separation);
+
+   do {
+      end_of_file = fscanf(fp_in, "%s %d %d", filename, &threshold_value, &polarity);
+
+      if (end_of_file == 3) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         image = imread(file_path_and_filename, CV_LOAD_IMAGE_UNCHANGED);
+         if (image.empty()) {
+            cout << "can not open " << file_path_and_filename << endl;
+            prompt_and_exit(-1);
+         }
+
+         if (image.type() == CV_8UC3) { // colour image
+            cvtColor(image, greyscale_image, CV_BGR2GRAY);
+         }
+         else {
+            greyscale_image = image;
+         }
+
+         threshold(greyscale_image, binary_image, threshold_value, 255,
+                   (polarity == 0 ? THRESH_BINARY : THRESH_BINARY_INV) | (threshold_value == 0 ? THRESH_OTSU : 0));
+
+         /* split the blobs */
+
+         number_of_labels = splitBlobs(binary_image, labels, stats, centroids, &parameters, &statistics);
+
+         printf("%s: %d x %d, %d connected components, %d blobs\n", filename, image.cols, image.rows,
+                statistics.number_of_components, statistics.number_of_blobs);
+         printf("   distance transform %.2f ms, markers %.2f ms, watershed %.2f ms\n",
+                statistics.distance_time_ms, statistics.marker_time_ms, statistics.watershed_time_ms);
+
+         /* compare the distance transform with openCV */
+
+         distanceTransformEDT(binary_image, distance_image);
+
+         ticks = (double) getTickCount();
+         distanceTransform(binary_image, opencv_distance_image, DIST_L2, DIST_MASK_PRECISE);
+         opencv_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+         if (countNonZero(binary_image == 0) > 0) {
+            max_difference = norm(distance_image, opencv_distance_image, NORM_INF);
+            printf("   openCV distance transform %.2f ms, maximum difference %.3f pixels\n", opencv_time, max_difference);
+         }
+
+         if (debug) {
+            for (l = 1; l < number_of_labels; l++) {
+               printf("   %3d: area %6d at (%7.1f, %7.1f)\n", l, stats.at<int>(l, CC_STAT_AREA),
+                      centroids.at<double>(l, 0), centroids.at<double>(l, 1));
+            }
+         }
+         printf("\n");
+
+         labelsToColourImage(labels, number_of_labels, label_image);
+
+         namedWindow(input_window_name,  CV_WINDOW_AUTOSIZE);
+         namedWindow(binary_window_name, CV_WINDOW_AUTOSIZE);
+         namedWindow(blobs_window_name,  CV_WINDOW_AUTOSIZE);
+         imshow(input_window_name,  image);
+         imshow(binary_window_name, binary_image);
+         imshow(blobs_window_name,  label_image);
+
+         printf("Press any key to continue ...\n");
+         do {
+            waitKey(30);
+         } while (!_kbhit());
+
+         getchar(); // flush the buffer from the keyboard hit
+
+         destroyWindow(input_window_name);
+         destroyWindow(binary_window_name);
+         destroyWindow(blobs_window_name);
+      }
+   } while (end_of_file == 3);
+
+   fclose(fp_in);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
@@ -0,0 +1,434 @@
+/* 
+  Example use of openCV to split touching blobs with the distance transform and the watershed
+  -------------------------------------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/blobSplitting.h"
+
+
+/*=======================================================*/
+/* Euclidean distance transform                          */
+/*=======================================================*/
+
+/*
+ * distanceTransform1D
+ * Squared distance transform of a sampled function f of n values, with the algorithm of Felzenszwalb and Huttenlocher:
+ * d[q] = min over p of (q - p)^2 + f[p], the lower envelope of n parabolas, in O(n).
+ * v holds the positions of the parabolas of the envelope and z the boundaries between them; both are work space
+ * of n and n + 1 values.
+ */
+
+static void distanceTransform1D(const float *f, float *d, int n, int *v, float *z) {
+
+   int k = 0;
+   int p, q;
+   float s;
+
+   v[0] = 0;
+   z[0] = -EDT_INFINITY;
+   z[1] =  EDT_INFINITY;
+
+   for (q = 1; q < n; q++) {
+      p = v[k];
+      s = ((f[q] + (float) q * q) - (f[p] + (float) p * p)) / (2.0f * (q - p));
+
+      while (s <= z[k]) {      // parabola q hides parabola p: remove p from the envelope
+         k--;
+         p = v[k];
+         s = ((f[q] + (float) q * q) - (f[p] + (float) p * p)) / (2.0f * (q - p));
+      }
+
+      k++;
+      v[k]     = q;
+      z[k]     = s;
+      z[k + 1] = EDT_INFINITY;
+   }
+
+   k = 0;
+   for (q = 0; q < n; q++) {
+      while (z[k + 1] < q) k++;
+      d[q] = (float) (q - v[k]) * (q - v[k]) + f[v[k]];
+   }
+}
+
+
+/*
+ * Parallel body for the row pass: the squared distance along each row to the nearest background pixel
+ */
+
+class DistanceRowBody : public ParallelLoopBody {
+public:
+   DistanceRowBody(const Mat &binary, Mat &squared) : binary_(binary), squared_(squared) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int n = binary_.cols;
+      vector<float> f(n), d(n), z(n + 1);
+      vector<int> v(n);
+      int row, col;
+
+      for (row = range.start; row < range.end; row++) {
+         const uchar *b = binary_.ptr<uchar>(row);
+
+         for (col = 0; col < n; col++) {
+            f[col] = b[col] != 0 ? EDT_INFINITY : 0;
+         }
+         distanceTransform1D(&f[0], squared_.ptr<float>(row), n, &v[0], &z[0]);
+      }
+   }
+
+private:
+   const Mat &binary_;
+   Mat       &squared_;
+};
+
+
+/*
+ * Parallel body for the column pass: the squared distance in two dimensions, from the row distances of each column
+ */
+
+class DistanceColumnBody : public ParallelLoopBody {
+public:
+   DistanceColumnBody(const Mat &squared, Mat &distance) : squared_(squared), distance_(distance) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int n = squared_.rows;
+      vector<float> f(n), d(n), z(n + 1);
+      vector<int> v(n);
+      int row, col;
+
+      for (col = range.start; col < range.end; col++) {
+         for (row = 0; row < n; row++) {
+            f[row] = min(squared_.at<float>(row, col), EDT_INFINITY);
+         }
+
+         distanceTransform1D(&f[0], &d[0], n, &v[0], &z[0]);
+
+         for (row = 0; row < n; row++) {
+            distance_.at<float>(row, col) = sqrt(d[row]);
+         }
+      }
+   }
+
+private:
+   const Mat &squared_;
+   Mat       &distance_;
+};
+
+
+/*
+ * distanceTransformEDT
+ * Exact Euclidean distance (CV_32F) from each non-zero pixel of a binary image to the nearest zero pixel, in linear time:
+ * a one-dimensional transform along each row and then along each column, each in parallel.
+ * Zero pixels have distance zero; if there are no zero pixels, the distance is about 1e10.
+ */
+
+void distanceTransformEDT(const Mat &binary_image, Mat &distance_image) {
+
+   Mat squared(binary_image.size(), CV_32F);
+
+   CV_Assert(binary_image.type() == CV_8UC1);
+
+   distance_image.create(binary_image.size(), CV_32F);
+
+   parallel_for_(Range(0, binary_image.rows), DistanceRowBody(binary_image, squared));
+   parallel_for_(Range(0, binary_image.cols), DistanceColumnBody(squared, distance_image));
+}
+
+
+/*=======================================================*/
+/* Markers and watershed                                 */
+/*=======================================================*/
+
+/*
+ * findDistanceMarkers
+ * Label image (CV_32S) of the markers: the plateaus of the distance map that are maxima of the window around them
+ * and at least min_radius from the background, so that there is one marker for each round object.
+ * A connected component with no such maximum is given a marker at its furthest pixel from the background,
+ * so that every component has at least one blob.  Returns the number of markers.
+ */
+
+int findDistanceMarkers(const Mat &binary_image, const Mat &distance_image, blobSplittingParametersType *parameters, Mat &markers) {
+
+   Mat maximum_image, maxima, components, marker_components;
+   vector<float> component_maximum;
+   vector<Point> component_location;
+   vector<bool> component_marked;
+   int number_of_components, number_of_markers;
+   int row, col, c, m;
+
+   /* maxima of the distance map */
+
+   dilate(distance_image, maximum_image,
+          getStructuringElement(MORPH_RECT, Size(2 * parameters->separation + 1, 2 * parameters->separation + 1)));
+   maxima = (distance_image >= maximum_image) & (distance_image >= parameters->min_radius) & (binary_image != 0);
+
+   number_of_markers = connectedComponents(maxima, markers, 8, CV_32S) - 1;
+
+   /* components of the foreground with no marker */
+
+   number_of_components = connectedComponents(binary_image, components, 8, CV_32S);
+
+   component_maximum.assign(number_of_components, -1);
+   component_location.assign(number_of_components, Point(0, 0));
+   component_marked.assign(number_of_components, false);
+
+   for (row = 0; row < binary_image.rows; row++) {
+      for (col = 0; col < binary_image.cols; col++) {
+         c = components.at<int>(row, col);
+         if (c == 0) continue;
+
+         if (markers.at<int>(row, col) != 0) {
+            component_marked[c] = true;
+         }
+         if (distance_image.at<float>(row, col) > component_maximum[c]) {
+            component_maximum[c]  = distance_image.at<float>(row, col);
+            component_location[c] = Point(col, row);
+         }
+      }
+   }
+
+   for (c = 1; c < number_of_components; c++) {
+      if (!component_marked[c]) {
+         m = ++number_of_markers;
+         markers.at<int>(component_location[c]) = m;
+      }
+   }
+
+   return number_of_markers;
+}
+
+
+/*
+ * watershedFlood
+ * Grow the markers over the foreground in order of decreasing distance from the background with a priority queue,
+ * so that touching blobs meet at the necks between them.  labels holds the markers on entry and the blobs on exit;
+ * background pixels keep label 0.
+ */
+
+struct floodElementType {
+   float distance;
+   long  order;                     // pixels of equal distance are flooded first in, first out
+   int   index;
+
+   bool operator<(const floodElementType &other) const {
+      return distance < other.distance || (distance == other.distance && order > other.order);
+   }
+};
+
+void watershedFlood(const Mat &binary_image, const Mat &distance_image, Mat &labels) {
+
+   const int dx[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+   const int dy[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+   priority_queue<floodElementType> queue;
+   floodElementType element;
+   int *label = labels.ptr<int>(0);
+   const float *distance = distance_image.ptr<float>(0);
+   const uchar *foreground = binary_image.ptr<uchar>(0);
+   int cols = binary_image.cols;
+   int row, col, x, y, i, n;
+   long order = 0;
+
+   CV_Assert(labels.type() == CV_32S && labels.isContinuous() && binary_image.isContinuous() && distance_image.isContinuous());
+
+   for (i = 0; i < (int) binary_image.total(); i++) {
+      if (label[i] != 0) {
+         element.distance = distance[i];
+         element.order    = order++;
+         element.index    = i;
+         queue.push(element);
+      }
+   }
+
+   while (!queue.empty()) {
+      element = queue.top();
+      queue.pop();
+
+      row = element.index / cols;
+      col = element.index % cols;
+
+      for (i = 0; i < 8; i++) {
+         x = col + dx[i];
+         y = row + dy[i];
+         if (x < 0 || x >= cols || y < 0 || y >= binary_image.rows) continue;
+
+         n = y * cols + x;
+         if (foreground[n] != 0 && label[n] == 0) {
+            label[n] = label[element.index];
+
+            floodElementType neighbour;
+            neighbour.distance = distance[n];
+            neighbour.order    = order++;
+            neighbour.index    = n;
+            queue.push(neighbour);
+         }
+      }
+   }
+}
+
+
+/*
+ * computeRegionTable
+ * Statistics of each label in the layout of openCV connectedComponentsWithStats(): stats (CV_32S) holds the
+ * CC_STAT_LEFT, CC_STAT_TOP, CC_STAT_WIDTH, CC_STAT_HEIGHT, and CC_STAT_AREA of each label and centroids (CV_64F) its x and y
+ */
+
+void computeRegionTable(const Mat &labels, int number_of_labels, Mat &stats, Mat &centroids) {
+
+   vector<int> left(number_of_labels, INT_MAX), top(number_of_labels, INT_MAX), right(number_of_labels, -1), bottom(number_of_labels, -1);
+   vector<int> area(number_of_labels, 0);
+   vector<double> sum_x(number_of_labels, 0), sum_y(number_of_labels, 0);
+   int row, col, l;
+
+   for (row = 0; row < labels.rows; row++) {
+      const int *label = labels.ptr<int>(row);
+
+      for (col = 0; col < labels.cols; col++) {
+         l = label[col];
+         left[l]   = min(left[l], col);
+         right[l]  = max(right[l], col);
+         top[l]    = min(top[l], row);
+         bottom[l] = max(bottom[l], row);
+         area[l]++;
+         sum_x[l] += col;
+         sum_y[l] += row;
+      }
+   }
+
+   stats.create(number_of_labels, CC_STAT_MAX, CV_32S);
+   centroids.create(number_of_labels, 2, CV_64F);
+
+   for (l = 0; l < number_of_labels; l++) {
+      if (area[l] == 0) {
+         stats.row(l).setTo(Scalar(0));
+         centroids.row(l).setTo(Scalar(0));
+         continue;
+      }
+      stats.at<int>(l, CC_STAT_LEFT)   = left[l];
+      stats.at<int>(l, CC_STAT_TOP)    = top[l];
+      stats.at<int>(l, CC_STAT_WIDTH)  = right[l] - left[l] + 1;
+      stats.at<int>(l, CC_STAT_HEIGHT) = bottom[l] - top[l] + 1;
+      stats.at<int>(l, CC_STAT_AREA)   = area[l];
+      centroids.at<double>(l, 0) = sum_x[l] / area[l];
+      centroids.at<double>(l, 1) = sum_y[l] / area[l];
+   }
+}
+
+
+/*
+ * splitBlobs
+ * Label the blobs of a binary image, splitting touching blobs: labels (CV_32S), stats, and centroids are as returned by
+ * connectedComponentsWithStats(), and so is the return value, the number of labels including the background label 0
+ */
+
+int splitBlobs(const Mat &binary_image, Mat &labels, Mat &stats, Mat &centroids,
+               blobSplittingParametersType *parameters, blobSplittingStatisticsType *statistics) {
+
+   Mat distance_image;
+   Mat components;
+   int number_of_markers;
+   double ticks;
+
+   ticks = (double) getTickCount();
+   distanceTransformEDT(binary_image, distance_image);
+   statistics->distance_time_ms = ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+   ticks = (double) getTickCount();
+   number_of_markers = findDistanceMarkers(binary_image, distance_image, parameters, labels);
+   statistics->marker_time_ms = ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+   ticks = (double) getTickCount();
+   watershedFlood(binary_image, distance_image, labels);
+   statistics->watershed_time_ms = ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+   computeRegionTable(labels, number_of_markers + 1, stats, centroids);
+
+   statistics->number_of_components = connectedComponents(binary_image, components, 8, CV_32S) - 1;
+   statistics->number_of_blobs      = number_of_markers;
+
+   return number_of_markers + 1;
+}
+
+
+/*
+ * labelsToColourImage
+ * Paint each label with a random colour and the background black
+ */
+
+void labelsToColourImage(const Mat &labels, int number_of_labels, Mat &colour_image) {
+
+   RNG rng(12345);
+   vector<Vec3b> colours(number_of_labels);
+   int row, col, l;
+
+   colours[0] = Vec3b(0, 0, 0);
+   for (l = 1; l < number_of_labels; l++) {
+      colours[l] = Vec3b((uchar) rng.uniform(64, 256), (uchar) rng.uniform(64, 256), (uchar) rng.uniform(64, 256));
+   }
+
+   colour_image.create(labels.size(), CV_8UC3);
+   for (row = 0; row < labels.rows; row++) {
+      for (col = 0; col < labels.cols; col++) {
+         colour_image.at<Vec3b>(row, col) = colours[labels.at<int>(row, col)];
+      }
+   }
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
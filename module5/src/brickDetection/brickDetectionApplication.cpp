@@ -0,0 +1,220 @@
+/* 
+  Example use of openCV to detect coloured bricks and estimate their image pose
+  -----------------------------------------------------------------------------
+  
+  This application reads the parameters of the brick detector from an input file brickDetectionInput.txt:
+
+  - the filename of the output file
+  - the minimum and maximum area of a brick in pixels
+  - the minimum and maximum aspect ratio of a brick, i.e. the ratio of its length to its width
+  - the number of brick colours, followed by one line for each colour with the colour name, the minimum and maximum
+    hue (0 to 180; the range wraps through 0 if the minimum is greater than the maximum), and the minimum saturation
+
+  These are followed by a sequence of lines, each containing the filename of an image or a video to be processed.
+
+  Each image, or each frame of a video, is classified by colour with a hue-saturation look-up table and the pixels
+  of each colour are labelled as connected components.  The centroid and the orientation of the principal axis of
+  each component are computed to sub-pixel precision from its second-order moments, accumulated in a single pass over
+  the label image (no contours are traced), and components whose area or aspect ratio is not that of a brick are rejected.
+
+  For each brick the frame number, the timestamp (ms), the colour, the centroid (u, v), and the orientation phi
+  (degrees, from the u axis towards the v axis) are written to the output file, ready for inverse perspective
+  transformation.  The processing time of each frame is reported at the end of each image or video.
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/brickDetection.h"
+
+int main() {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "brickDetectionInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+   char output_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   bool is_video;
+   int c;
+   long number_of_frames;
+   long number_of_bricks;
+   double start_ticks;
+   double total_time;
+   double max_time;
+
+   FILE *fp_in;
+   FILE *fp_out;
+
+   brickDetectorType detector;
+   brickColourType *colour;
+   brickFrameType frame;
+   VideoCapture video;
+   Mat image;
+
+   const char* window_name = "Bricks";
+   
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input brickDetectionInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Example of how to use openCV to detect coloured bricks and estimate their image pose.\n\n");
+
+   end_of_file = fscanf(fp_in, "%s %d %d %lf %lf %d", output_filename, &detector.min_area, &detector.max_area,
+                        &detector.min_aspect_ratio, &detector.max_aspect_ratio, &detector.number_of_colours);
+
+   if (end_of_file != 6 || detector.number_of_colours < 1 || detector.number_of_colours > MAX_NUMBER_OF_COLOURS) {
+      printf("Error can't read the detector parameters from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   for (c = 0; c < detector.number_of_colours; c++) {
+      colour = &detector.colours[c];
+      if (fscanf(fp_in, "%19s %d %d %d", colour->name, &colour->hue_min, &colour->hue_max, &colour->saturation_min) != 4) {
+         printf("Error can't read colour %d from %s\n", c + 1, input_filename);
+         prompt_and_exit(1);
+      }
+
+      if (debug) printf("%-8s hue %3d to %3d, saturation >= %3d\n", colour->name, colour->hue_min, colour->hue_max, colour->saturation_min);
+   }
+
+   if (debug) printf("area %d to %d, aspect ratio %4.2f to %4.2f\n\n",
+                     detector.min_area, detector.max_area, detector.min_aspect_ratio, detector.max_aspect_ratio);
+
+   buildColourLUT(&detector);
+
+   strcpy(file_path_and_filename, data_dir);
+   strcat(file_path_and_filename, output_filename);
+
+   if ((fp_out = fopen(file_path_and_filename,"w")) == 0) {
+	  printf("Error can't open output %s\n", output_filename);
+     prompt_and_exit(1);
+   }
+
+   namedWindow(window_name, CV_WINDOW_AUTOSIZE);
+
+   do {
+      end_of_file = fscanf(fp_in, "%s", filename);
+
+      if (end_of_file != EOF) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         /* an image, or else a video processed frame by frame */
+
+         image = imread(file_path_and_filename, CV_LOAD_IMAGE_COLOR);
+         is_video = image.empty();
+
+         if (is_video) {
+            video.open(file_path_and_filename);
+            if (!video.isOpened()) {
+               cout << "can not open " << file_path_and_filename << endl;
+               prompt_and_exit(-1);
+            }
+            printf("%s: press any key to stop\n", filename);
+         }
+
+         number_of_frames = 0;
+         number_of_bricks = 0;
+         total_time       = 0;
+         max_time         = 0;
+         start_ticks      = (double) getTickCount();
+
+         do {
+            if (is_video) {
+               video >> image;
+               if (image.empty()) break;
+               frame.timestamp = video.get(CV_CAP_PROP_POS_MSEC);
+            }
+            else {
+               frame.timestamp = ((double) getTickCount() - start_ticks) * 1000 / getTickFrequency();
+            }
+            frame.frame_number = number_of_frames;
+
+            frame.processing_time = (double) getTickCount();
+            detectBricks(image, &detector, frame.bricks);
+            frame.processing_time = ((double) getTickCount() - frame.processing_time) * 1000 / getTickFrequency();
+
+            writeBrickFrame(fp_out, &detector, frame);
+
+            number_of_frames++;
+            number_of_bricks += frame.bricks.size();
+            total_time       += frame.processing_time;
+            if (frame.processing_time > max_time) max_time = frame.processing_time;
+
+            drawBricks(image, &detector, frame.bricks);
+            imshow(window_name, image);
+            waitKey(1);
+
+         } while (is_video && !_kbhit());
+
+         if (is_video) {
+            video.release();
+            if (_kbhit()) getchar(); // flush the buffer from the keyboard hit
+         }
+         else {
+            for (c = 0; c < (int) frame.bricks.size(); c++) {
+               printf("%-8s u %7.2f v %7.2f phi %7.2f area %6d aspect ratio %4.2f\n",
+                      detector.colours[frame.bricks[c].colour].name, frame.bricks[c].u, frame.bricks[c].v,
+                      frame.bricks[c].phi, frame.bricks[c].area, frame.bricks[c].aspect_ratio);
+            }
+            printf("Press any key to continue ...\n");
+            do {
+               waitKey(30);
+            } while (!_kbhit());
+            getchar(); // flush the buffer from the keyboard hit
+         }
+
+         if (number_of_frames > 0) {
+            printf("%s: %ld frames, %ld bricks, %.2f ms per frame (max %.2f ms), %.1f frames per second\n\n",
+                   filename, number_of_frames, number_of_bricks,
+                   total_time / number_of_frames, max_time, number_of_frames * 1000 / total_time);
+         }
+      }
+   } while (end_of_file != EOF);
+
+   destroyWindow(window_name);
+
+   fclose(fp_in);
+   fclose(fp_out);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
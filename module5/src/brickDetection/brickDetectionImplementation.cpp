@@ -0,0 +1,310 @@
+/* 
+  Example use of openCV to detect coloured bricks and estimate their image pose
+  -----------------------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/brickDetection.h"
+
+
+/*=======================================================*/
+/* Colour classification                                 */
+/*=======================================================*/
+
+/*
+ * buildColourLUT
+ * Fill the 180 x 256 hue-saturation table with the index of the colour of each hue and saturation, or NO_COLOUR,
+ * so that each pixel is classified by one table look-up whatever the number of colours
+ */
+
+void buildColourLUT(brickDetectorType *detector) {
+
+   int hue, saturation, c;
+   bool in_range;
+   brickColourType *colour;
+
+   detector->colour_lut = Mat(180, 256, CV_8U, Scalar(NO_COLOUR));
+
+   for (c = detector->number_of_colours - 1; c >= 0; c--) {   // the first colour wins where ranges overlap
+      colour = &detector->colours[c];
+
+      for (hue = 0; hue < 180; hue++) {
+         if (colour->hue_min <= colour->hue_max) {
+            in_range = hue >= colour->hue_min && hue <= colour->hue_max;
+         }
+         else {
+            in_range = hue >= colour->hue_min || hue <= colour->hue_max;
+         }
+
+         if (in_range) {
+            for (saturation = colour->saturation_min; saturation < 256; saturation++) {
+               detector->colour_lut.at<uchar>(hue, saturation) = (uchar) c;
+            }
+         }
+      }
+   }
+}
+
+
+/*
+ * classifyColours
+ * Colour index of each pixel of a BGR image
+ */
+
+void classifyColours(const Mat &bgr_image, const Mat &colour_lut, Mat &colour_index) {
+
+   Mat hsv_image;
+   const uchar *hsv;
+   uchar *index;
+   int row, col;
+
+   cvtColor(bgr_image, hsv_image, CV_BGR2HSV);
+   colour_index.create(bgr_image.rows, bgr_image.cols, CV_8U);
+
+   for (row = 0; row < hsv_image.rows; row++) {
+      hsv   = hsv_image.ptr<uchar>(row);
+      index = colour_index.ptr<uchar>(row);
+
+      for (col = 0; col < hsv_image.cols; col++, hsv += 3) {
+         if (hsv[2] < MIN_VALUE) {
+            index[col] = NO_COLOUR;
+         }
+         else {
+            index[col] = colour_lut.at<uchar>(hsv[0], hsv[1]);
+         }
+      }
+   }
+}
+
+
+/*=======================================================*/
+/* Blob geometry                                         */
+/*=======================================================*/
+
+/*
+ * accumulateBlobMoments
+ * Raw moments up to second order of every label, in one pass over the label image.
+ * The coordinates are taken relative to the top left of the bounding box of each label to keep the sums small.
+ */
+
+void accumulateBlobMoments(const Mat &labels, const Mat &stats, int number_of_labels, vector<blobMomentsType> &moments) {
+
+   const int *label;
+   blobMomentsType *m;
+   int row, col, l;
+   double x, y;
+
+   moments.assign(number_of_labels, blobMomentsType());
+
+   for (row = 0; row < labels.rows; row++) {
+      label = labels.ptr<int>(row);
+
+      for (col = 0; col < labels.cols; col++) {
+         l = label[col];
+         if (l == 0) continue;
+
+         m = &moments[l];
+         x = col - stats.at<int>(l, CC_STAT_LEFT);
+         y = row - stats.at<int>(l, CC_STAT_TOP);
+
+         m->m00 += 1;
+         m->m10 += x;
+         m->m01 += y;
+         m->m20 += x * x;
+         m->m11 += x * y;
+         m->m02 += y * y;
+      }
+   }
+}
+
+
+/*
+ * brickFromMoments
+ * Centroid, principal axis, and aspect ratio of a blob from its moments; returns false if the blob is not a brick
+ */
+
+bool brickFromMoments(const blobMomentsType &m, int colour, brickDetectorType *detector, brickType *brick) {
+
+   double u, v, mu20, mu11, mu02;
+   double common, lambda1, lambda2;
+   double aspect_ratio;
+   double phi;
+
+   if (m.m00 < detector->min_area || m.m00 > detector->max_area) {
+      return false;
+   }
+
+   /* centroid and central moments */
+
+   u    = m.m10 / m.m00;
+   v    = m.m01 / m.m00;
+   mu20 = m.m20 / m.m00 - u * u;
+   mu11 = m.m11 / m.m00 - u * v;
+   mu02 = m.m02 / m.m00 - v * v;
+
+   /* eigenvalues of the covariance matrix: the variances along the principal axes */
+
+   common  = sqrt(4 * mu11 * mu11 + (mu20 - mu02) * (mu20 - mu02));
+   lambda1 = (mu20 + mu02 + common) / 2;
+   lambda2 = (mu20 + mu02 - common) / 2;
+
+   if (lambda2 <= 0) {
+      return false;                         // a line of pixels
+   }
+
+   aspect_ratio = sqrt(lambda1 / lambda2);   // ratio of length to width for a rectangle
+
+   if (aspect_ratio < detector->min_aspect_ratio || aspect_ratio > detector->max_aspect_ratio) {
+      return false;
+   }
+
+   phi = 0.5 * atan2(2 * mu11, mu20 - mu02) * 180 / CV_PI;
+   if (phi <= -90) phi += 180;
+
+   brick->colour       = colour;
+   brick->u            = (float) u;
+   brick->v            = (float) v;
+   brick->phi          = (float) phi;
+   brick->area         = (int) m.m00;
+   brick->aspect_ratio = (float) aspect_ratio;
+
+   return true;
+}
+
+
+/*
+ * detectBricks
+ * Bricks of each colour in a BGR image: colour classification, connected component labelling, and blob moments
+ */
+
+void detectBricks(const Mat &bgr_image, brickDetectorType *detector, vector<brickType> &bricks) {
+
+   static Mat opening_element = getStructuringElement(MORPH_RECT, Size(3, 3));
+
+   Mat colour_index, mask, labels, stats, centroids;
+   vector<blobMomentsType> moments;
+   brickType brick;
+   int c, l, number_of_labels;
+
+   bricks.clear();
+
+   classifyColours(bgr_image, detector->colour_lut, colour_index);
+
+   for (c = 0; c < detector->number_of_colours; c++) {
+      compare(colour_index, Scalar(c), mask, CMP_EQ);
+      morphologyEx(mask, mask, MORPH_OPEN, opening_element);
+
+      number_of_labels = connectedComponentsWithStats(mask, labels, stats, centroids, 8, CV_32S);
+
+      accumulateBlobMoments(labels, stats, number_of_labels, moments);
+
+      for (l = 1; l < number_of_labels; l++) {
+         if (brickFromMoments(moments[l], c, detector, &brick)) {
+            brick.u += stats.at<int>(l, CC_STAT_LEFT);
+            brick.v += stats.at<int>(l, CC_STAT_TOP);
+            bricks.push_back(brick);
+         }
+      }
+   }
+}
+
+
+/*=======================================================*/
+/* Output                                                */
+/*=======================================================*/
+
+/*
+ * writeBrickFrame
+ * One line per brick: frame number, timestamp (ms), colour, u, v, phi (degrees)
+ */
+
+void writeBrickFrame(FILE *fp, brickDetectorType *detector, const brickFrameType &frame) {
+
+   unsigned int i;
+
+   for (i = 0; i < frame.bricks.size(); i++) {
+      fprintf(fp, "%6ld %10.1f %-8s %8.2f %8.2f %7.2f\n", frame.frame_number, frame.timestamp,
+              detector->colours[frame.bricks[i].colour].name, frame.bricks[i].u, frame.bricks[i].v, frame.bricks[i].phi);
+   }
+}
+
+
+/*
+ * drawBricks
+ * Mark the centroid and principal axis of each brick
+ */
+
+void drawBricks(Mat &image, brickDetectorType *detector, const vector<brickType> &bricks) {
+
+   unsigned int i;
+   float length;
+   Point2f centroid, axis;
+
+   for (i = 0; i < bricks.size(); i++) {
+      centroid = Point2f(bricks[i].u, bricks[i].v);
+      length   = (float) sqrt((double) bricks[i].area);
+      axis     = Point2f((float) cos(bricks[i].phi * CV_PI / 180), (float) sin(bricks[i].phi * CV_PI / 180)) * length / 2;
+
+      line(image, centroid - axis, centroid + axis, Scalar(0, 255, 255), 2);
+      circle(image, centroid, 3, Scalar(0, 255, 255), -1);
+      putText(image, detector->colours[bricks[i].colour].name, centroid + Point2f(5, -5),
+              FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 255, 255), 1);
+   }
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
@@ -0,0 +1,234 @@
+/* 
+  Example use of openCV to track coloured bricks with a Kalman filter and process only the regions where they are predicted
+  -----------------------------------------------------------------------------------------------------------------------
+  
+  This application reads the parameters of the brick detector and the tracker from an input file brickTrackingInput.txt:
+
+  - the filename of the output file
+  - the minimum and maximum area of a brick in pixels
+  - the minimum and maximum aspect ratio of a brick, i.e. the ratio of its length to its width
+  - the number of brick colours, followed by one line for each colour with the colour name, the minimum and maximum
+    hue (0 to 180; the range wraps through 0 if the minimum is greater than the maximum), and the minimum saturation
+  - the number of frames between full-frame scans
+  - the padding in pixels added to each side of the predicted extent of a brick to form its region of interest
+
+  These are followed by a sequence of lines, each containing the filename of a video to be processed.
+
+  The bricks are detected as in the brickDetection application.  Once a brick has been found, its centroid is tracked
+  with a constant-velocity Kalman filter and only the region of interest around its predicted position is segmented
+  in the next frame.  The whole frame is scanned again periodically, and as soon as a track is missed.
+
+  Each video is processed twice: first scanning every frame in full, then with tracking.  The processing time per
+  frame of both is reported, together with the fraction of the pixels processed with tracking.
+  For each tracked brick, the frame number, the timestamp (ms), the track number, the colour, the filtered centroid
+  (u, v), and the orientation phi (degrees) are written to the output file.
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/brickTracking.h"
+
+int main() {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "brickTrackingInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+   char output_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   bool full_scan;
+   bool stopped;
+   int c;
+   int full_scan_interval;
+   int roi_padding;
+   long number_of_frames;
+   double ticks;
+   double full_frame_time;
+   double tracking_time;
+
+   FILE *fp_in;
+   FILE *fp_out;
+
+   brickDetectorType detector;
+   brickColourType *colour;
+   trackerType tracker;
+   vector<brickType> bricks;
+   VideoCapture video;
+   Mat image;
+
+   const char* window_name = "Tracked Bricks";
+   
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input brickTrackingInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Example of how to use openCV to track coloured bricks with a Kalman filter.\n\n");
+
+   end_of_file = fscanf(fp_in, "%s %d %d %lf %lf %d", output_filename, &detector.min_area, &detector.max_area,
+                        &detector.min_aspect_ratio, &detector.max_aspect_ratio, &detector.number_of_colours);
+
+   if (end_of_file != 6 || detector.number_of_colours < 1 || detector.number_of_colours > MAX_NUMBER_OF_COLOURS) {
+      printf("Error can't read the detector parameters from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   for (c = 0; c < detector.number_of_colours; c++) {
+      colour = &detector.colours[c];
+      if (fscanf(fp_in, "%19s %d %d %d", colour->name, &colour->hue_min, &colour->hue_max, &colour->saturation_min) != 4) {
+         printf("Error can't read colour %d from %s\n", c + 1, input_filename);
+         prompt_and_exit(1);
+      }
+
+      if (debug) printf("%-8s hue %3d to %3d, saturation >= %3d\n", colour->name, colour->hue_min, colour->hue_max, colour->saturation_min);
+   }
+
+   if (fscanf(fp_in, "%d %d", &full_scan_interval, &roi_padding) != 2 || full_scan_interval < 1 || roi_padding < 0) {
+      printf("Error can't read the tracker parameters from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   if (debug) printf("area %d to %d, aspect ratio %4.2f to %4.2f, full scan every %d frames, padding %d pixels\n\n",
+                     detector.min_area, detector.max_area, detector.min_aspect_ratio, detector.max_aspect_ratio,
+                     full_scan_interval, roi_padding);
+
+   buildColourLUT(&detector);
+
+   strcpy(file_path_and_filename, data_dir);
+   strcat(file_path_and_filename, output_filename);
+
+   if ((fp_out = fopen(file_path_and_filename,"w")) == 0) {
+	  printf("Error can't open output %s\n", output_filename);
+     prompt_and_exit(1);
+   }
+
+   do {
+      end_of_file = fscanf(fp_in, "%s", filename);
+
+      if (end_of_file != EOF) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         /* full-frame scan of every frame */
+
+         video.open(file_path_and_filename);
+         if (!video.isOpened()) {
+            cout << "can not open " << file_path_and_filename << endl;
+            prompt_and_exit(-1);
+         }
+
+         printf("%s: scanning every frame in full ...\n", filename);
+
+         number_of_frames = 0;
+         full_frame_time  = 0;
+
+         while (true) {
+            video >> image;
+            if (image.empty()) break;
+
+            ticks = (double) getTickCount();
+            detectBricks(image, &detector, bricks);
+            full_frame_time += ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+            number_of_frames++;
+         }
+         video.release();
+
+         if (number_of_frames == 0) {
+            printf("%s: no frames\n\n", filename);
+            continue;
+         }
+
+         /* tracking */
+
+         video.open(file_path_and_filename);
+
+         printf("%s: tracking; press any key to stop\n", filename);
+
+         namedWindow(window_name, CV_WINDOW_AUTOSIZE);
+
+         initialiseTracker(&tracker, &detector, full_scan_interval, roi_padding);
+         tracking_time = 0;
+         stopped = false;
+
+         while (!stopped) {
+            video >> image;
+            if (image.empty()) break;
+
+            ticks = (double) getTickCount();
+            full_scan = trackBricks(image, &tracker);
+            tracking_time += ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+            writeTrackFrame(fp_out, &tracker, tracker.full_scans + tracker.roi_scans - 1, video.get(CV_CAP_PROP_POS_MSEC));
+
+            drawTracks(image, &tracker, full_scan);
+            imshow(window_name, image);
+            waitKey(1);
+
+            if (_kbhit()) {
+               getchar(); // flush the buffer from the keyboard hit
+               stopped = true;
+            }
+         }
+         video.release();
+
+         destroyWindow(window_name);
+
+         /* compare the throughput over the frames processed by both */
+
+         printf("Full frame:   %ld frames, %.2f ms per frame, %.1f frames per second\n",
+                number_of_frames, full_frame_time / number_of_frames, number_of_frames * 1000 / full_frame_time);
+
+         if (tracker.full_scans + tracker.roi_scans > 0) {
+            number_of_frames = tracker.full_scans + tracker.roi_scans;
+            printf("ROI tracking: %ld frames, %.2f ms per frame, %.1f frames per second\n",
+                   number_of_frames, tracking_time / number_of_frames, number_of_frames * 1000 / tracking_time);
+            printf("              %ld full-frame scans, %.1f%% of the pixels processed\n\n",
+                   tracker.full_scans, 100 * tracker.pixels_processed / number_of_frames);
+         }
+      }
+   } while (end_of_file != EOF);
+
+   fclose(fp_in);
+   fclose(fp_out);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
@@ -0,0 +1,295 @@
+/* 
+  Example use of openCV to track coloured bricks with a Kalman filter and process only the regions where they are predicted
+  -----------------------------------------------------------------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/brickTracking.h"
+
+
+/*
+ * initialiseTracker
+ */
+
+void initialiseTracker(trackerType *tracker, brickDetectorType *detector, int full_scan_interval, int roi_padding) {
+
+   tracker->detector               = detector;
+   tracker->tracks.clear();
+   tracker->full_scan_interval     = full_scan_interval;
+   tracker->roi_padding            = roi_padding;
+   tracker->frames_since_full_scan = 0;
+   tracker->track_lost             = false;
+   tracker->next_id                = 1;
+   tracker->full_scans             = 0;
+   tracker->roi_scans              = 0;
+   tracker->pixels_processed       = 0;
+}
+
+
+/*
+ * initialiseTrack
+ * Constant-velocity Kalman filter, one frame per time step, starting at rest at the detected centroid
+ */
+
+void initialiseTrack(trackType *track, const brickType &brick, int id) {
+
+   float q = (float) PROCESS_NOISE;
+
+   track->filter.init(4, 2, 0, CV_32F);
+
+   track->filter.transitionMatrix = (Mat_<float>(4, 4) << 1, 0, 1, 0,
+                                                          0, 1, 0, 1,
+                                                          0, 0, 1, 0,
+                                                          0, 0, 0, 1);
+
+   track->filter.processNoiseCov = (Mat_<float>(4, 4) << q/4,   0, q/2,   0,    // random acceleration
+                                                           0, q/4,   0, q/2,
+                                                         q/2,   0,   q,   0,
+                                                           0, q/2,   0,   q);
+
+   setIdentity(track->filter.measurementMatrix);
+   setIdentity(track->filter.measurementNoiseCov, Scalar::all(MEASUREMENT_NOISE));
+
+   track->filter.errorCovPost = (Mat_<float>(4, 4) << MEASUREMENT_NOISE, 0, 0, 0,
+                                                      0, MEASUREMENT_NOISE, 0, 0,
+                                                      0, 0, MATCH_DISTANCE, 0,      // the velocity is unknown
+                                                      0, 0, 0, MATCH_DISTANCE);
+
+   track->filter.statePost = (Mat_<float>(4, 1) << brick.u, brick.v, 0, 0);
+
+   track->id     = id;
+   track->brick  = brick;
+   track->misses = 0;
+}
+
+
+/*
+ * predictROI
+ * Predict the position of a tracked brick in the next frame and the region that contains it:
+ * the circle that encloses the brick, enlarged by the padding and by three standard deviations of the predicted position
+ */
+
+Rect predictROI(trackType *track, int padding, Size image_size) {
+
+   Mat prediction;
+   double length, width, uncertainty, half_size;
+
+   prediction = track->filter.predict();
+
+   track->brick.u = prediction.at<float>(0);
+   track->brick.v = prediction.at<float>(1);
+
+   length      = sqrt(track->brick.area * track->brick.aspect_ratio);
+   width       = track->brick.area / length;
+   uncertainty = 3 * sqrt(max(track->filter.errorCovPre.at<float>(0, 0), track->filter.errorCovPre.at<float>(1, 1)));
+   half_size   = sqrt(length * length + width * width) / 2 + padding + uncertainty;
+
+   track->roi = Rect(cvFloor(track->brick.u - half_size), cvFloor(track->brick.v - half_size),
+                     cvCeil(2 * half_size) + 1,            cvCeil(2 * half_size) + 1) & Rect(Point(0, 0), image_size);
+
+   return track->roi;
+}
+
+
+/*
+ * detectBricksInROI
+ * Bricks in a region of interest of a BGR image, with centroids in the coordinates of the full image.
+ * The region is processed in place: no pixels are copied.
+ */
+
+void detectBricksInROI(const Mat &bgr_image, Rect roi, brickDetectorType *detector, vector<brickType> &bricks) {
+
+   unsigned int i;
+
+   bricks.clear();
+
+   if (roi.area() == 0) return;
+
+   detectBricks(bgr_image(roi), detector, bricks);
+
+   for (i = 0; i < bricks.size(); i++) {
+      bricks[i].u += roi.x;
+      bricks[i].v += roi.y;
+   }
+}
+
+
+/*
+ * trackBricks
+ * Detect the bricks in the next frame and update the tracks.
+ *
+ * The whole frame is scanned when there are no tracks, when a track was missed in the last frame, and every
+ * full_scan_interval frames; otherwise only the predicted region of each track is scanned.  New tracks are only
+ * started by a full-frame scan.  Returns true if the whole frame was scanned.
+ */
+
+bool trackBricks(const Mat &bgr_image, trackerType *tracker) {
+
+   vector<brickType> detections, roi_detections;
+   vector<bool> duplicate, detection_matched, track_matched;
+   vector< pair<double, pair<int, int> > > pairs;       // distance, (track, detection)
+   Mat measurement(2, 1, CV_32F);
+   Mat estimate;
+   bool full_scan;
+   double roi_area;
+   double distance;
+   unsigned int i, j, t, d;
+
+   full_scan = tracker->tracks.empty() || tracker->track_lost || tracker->frames_since_full_scan >= tracker->full_scan_interval;
+
+   /* predict the region of each track */
+
+   for (t = 0; t < tracker->tracks.size(); t++) {
+      predictROI(&tracker->tracks[t], tracker->roi_padding, bgr_image.size());
+   }
+
+   /* detect */
+
+   if (full_scan) {
+      detectBricks(bgr_image, tracker->detector, detections);
+
+      tracker->full_scans++;
+      tracker->pixels_processed += 1;
+      tracker->frames_since_full_scan = 0;
+   }
+   else {
+      roi_area = 0;
+      for (t = 0; t < tracker->tracks.size(); t++) {
+         detectBricksInROI(bgr_image, tracker->tracks[t].roi, tracker->detector, roi_detections);
+         detections.insert(detections.end(), roi_detections.begin(), roi_detections.end());
+         roi_area += tracker->tracks[t].roi.area();
+      }
+
+      /* a brick in overlapping regions is detected once in each */
+
+      duplicate.assign(detections.size(), false);
+      for (i = 0; i < detections.size(); i++) {
+         for (j = i + 1; j < detections.size(); j++) {
+            if (!duplicate[j] && detections[j].colour == detections[i].colour &&
+                norm(Point2f(detections[j].u - detections[i].u, detections[j].v - detections[i].v)) < DUPLICATE_DISTANCE) {
+               duplicate[j] = true;
+            }
+         }
+      }
+      for (i = detections.size(); i-- > 0; ) {
+         if (duplicate[i]) detections.erase(detections.begin() + i);
+      }
+
+      tracker->roi_scans++;
+      tracker->pixels_processed += roi_area / bgr_image.total();
+      tracker->frames_since_full_scan++;
+   }
+
+   /* associate detections with tracks, nearest first */
+
+   for (t = 0; t < tracker->tracks.size(); t++) {
+      for (d = 0; d < detections.size(); d++) {
+         if (detections[d].colour == tracker->tracks[t].brick.colour) {
+            distance = norm(Point2f(detections[d].u - tracker->tracks[t].brick.u, detections[d].v - tracker->tracks[t].brick.v));
+            if (distance < MATCH_DISTANCE) {
+               pairs.push_back(make_pair(distance, make_pair((int) t, (int) d)));
+            }
+         }
+      }
+   }
+   sort(pairs.begin(), pairs.end());
+
+   track_matched.assign(tracker->tracks.size(), false);
+   detection_matched.assign(detections.size(), false);
+
+   for (i = 0; i < pairs.size(); i++) {
+      t = pairs[i].second.first;
+      d = pairs[i].second.second;
+
+      if (track_matched[t] || detection_matched[d]) continue;
+
+      track_matched[t]     = true;
+      detection_matched[d] = true;
+
+      measurement.at<float>(0) = detections[d].u;
+      measurement.at<float>(1) = detections[d].v;
+      estimate = tracker->tracks[t].filter.correct(measurement);
+
+      tracker->tracks[t].brick   = detections[d];
+      tracker->tracks[t].brick.u = estimate.at<float>(0);
+      tracker->tracks[t].brick.v = estimate.at<float>(1);
+      tracker->tracks[t].misses  = 0;
+   }
+
+   /* missed tracks force a full-frame scan and are dropped when they have been missed too often */
+
+   tracker->track_lost = false;
+
+   for (t = tracker->tracks.size(); t-- > 0; ) {
+      if (!track_matched[t]) {
+         tracker->track_lost = true;
+         if (++tracker->tracks[t].misses > MAX_TRACK_MISSES) {
+            tracker->tracks.erase(tracker->tracks.begin() + t);
+         }
+      }
+   }
+
+   /* new tracks */
+
+   if (full_scan) {
+      for (d = 0; d < detections.size(); d++) {
+         if (!detection_matched[d]) {
+            tracker->tracks.push_back(trackType());
+            initialiseTrack(&tracker->tracks.back(), detections[d], tracker->next_id++);
+         }
+      }
+   }
+
+   return full_scan;
+}
+
+
+/*
+ * writeTrackFrame
+ * One line per track seen in this frame: frame number, timestamp (ms), track, colour, u, v, phi (degrees)
+ */
+
+void writeTrackFrame(FILE *fp, trackerType *tracker, long frame_number, double timestamp) {
+
+   unsigned int t;
+   brickType *brick;
+
+   for (t = 0; t < tracker->tracks.size(); t++) {
+      if (tracker->tracks[t].misses == 0) {
+         brick = &tracker->tracks[t].brick;
+         fprintf(fp, "%6ld %10.1f %4d %-8s %8.2f %8.2f %7.2f\n", frame_number, timestamp, tracker->tracks[t].id,
+                 tracker->detector->colours[brick->colour].name, brick->u, brick->v, brick->phi);
+      }
+   }
+}
+
+
+/*
+ * drawTracks
+ * Mark the bricks and, unless the whole frame was scanned, the regions of interest
+ */
+
+void drawTracks(Mat &image, trackerType *tracker, bool full_scan) {
+
+   vector<brickType> bricks;
+   unsigned int t;
+   char label[MAX_STRING_LENGTH];
+
+   for (t = 0; t < tracker->tracks.size(); t++) {
+      if (!full_scan) {
+         rectangle(image, tracker->tracks[t].roi, Scalar(255, 0, 255), 1);
+      }
+      if (tracker->tracks[t].misses == 0) {
+         bricks.push_back(tracker->tracks[t].brick);
+         sprintf(label, "%d", tracker->tracks[t].id);
+         putText(image, label, Point2f(tracker->tracks[t].brick.u + 5, tracker->tracks[t].brick.v + 15),
+                 FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 255, 255), 1);
+      }
+   }
+
+   drawBricks(image, tracker->detector, bricks);
+}
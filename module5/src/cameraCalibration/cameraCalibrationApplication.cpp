@@ -24,6 +24,9 @@
   Abrham Gebreselasie
   10 March 2021
   
+  Run headless, i.e. without displaying images, when there is no display
+  16 October 2026
+  
 
 */
  
@@ -49,6 +52,7 @@ int main() {
 
    int end_of_file;
    bool debug = false;
+   bool headless = false;
    char filename[MAX_FILENAME_LENGTH];
 
    FILE *fp_in;
@@ -60,6 +64,10 @@ int main() {
       strcpy(data_dir, "..");
    #endif
    
+   #ifdef ROS
+      headless = (getenv("DISPLAY") == NULL);
+   #endif
+
    strcat(data_dir, "/data/");
    strcpy(input_path_and_filename, data_dir);
    strcat(input_path_and_filename, input_filename);
@@ -87,7 +95,7 @@ int main() {
 
          printf("\nPerforming camera calibration on %s \n",filename);
 
-		   CameraCalibration( string(filename) );
+		   CameraCalibration( string(filename), headless );
       }
    } while (end_of_file != EOF);
 
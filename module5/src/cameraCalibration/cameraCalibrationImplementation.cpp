@@ -12,6 +12,15 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Image lists are calibrated by a separate front end that detects the pattern in all images concurrently,
+  detects chessboards in a reduced image and refines the corners at full resolution, reports the detection
+  time for each image, and skips the display in headless mode
+  16 October 2026
+
+  Undistortion maps are built once per calibration, saved next to the configuration file, memory-mapped at startup,
+  and applied with remap in parallel tiles instead of calling undistort for every frame
+  16 October 2026
     
 */
  
@@ -36,6 +45,13 @@
 #include <opencv2/calib3d/calib3d.hpp>
 #include <opencv2/highgui/highgui.hpp>
 
+#ifdef ROS
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
+
 using namespace cv;
 using namespace std;
 
@@ -233,7 +249,7 @@ static void read(const FileNode& node, Settings& x, const Settings& default_valu
 enum { DETECTION = 0, CAPTURING = 1, CALIBRATED = 2 };
 
 bool runCalibrationAndSave(Settings& s, Size imageSize, Mat&  cameraMatrix, Mat& distCoeffs,
-                           vector<vector<Point2f> > imagePoints );
+                           vector<vector<Point2f> > imagePoints, bool warmStart = false );
 
 static double computeReprojectionErrors( const vector<vector<Point3f> >& objectPoints,
                                          const vector<vector<Point2f> >& imagePoints,
@@ -285,16 +301,27 @@ static void calcBoardCornerPositions(Size boardSize, float squareSize, vector<Po
     }
 }
 
+// with warmStart, cameraMatrix and distCoeffs hold the initial estimate, e.g. from the incremental calibration
 static bool runCalibration( Settings& s, Size& imageSize, Mat& cameraMatrix, Mat& distCoeffs,
                             vector<vector<Point2f> > imagePoints, vector<Mat>& rvecs, vector<Mat>& tvecs,
-                            vector<float>& reprojErrs,  double& totalAvgErr)
+                            vector<float>& reprojErrs,  double& totalAvgErr, bool warmStart)
 {
 
-    cameraMatrix = Mat::eye(3, 3, CV_64F);
-    if( s.flag & CV_CALIB_FIX_ASPECT_RATIO )
-        cameraMatrix.at<double>(0,0) = 1.0;
+    int flag = s.flag|CV_CALIB_FIX_K4|CV_CALIB_FIX_K5;
 
-    distCoeffs = Mat::zeros(8, 1, CV_64F);
+    if( warmStart )
+    {
+        CV_Assert( cameraMatrix.rows == 3 && cameraMatrix.cols == 3 && distCoeffs.total() == 8 );
+        flag |= CV_CALIB_USE_INTRINSIC_GUESS;
+    }
+    else
+    {
+        cameraMatrix = Mat::eye(3, 3, CV_64F);
+        if( s.flag & CV_CALIB_FIX_ASPECT_RATIO )
+            cameraMatrix.at<double>(0,0) = 1.0;
+
+        distCoeffs = Mat::zeros(8, 1, CV_64F);
+    }
 
     vector<vector<Point3f> > objectPoints(1);
     calcBoardCornerPositions(s.boardSize, s.squareSize, objectPoints[0], s.calibrationPattern);
@@ -303,7 +330,7 @@ static bool runCalibration( Settings& s, Size& imageSize, Mat& cameraMatrix, Mat
 
     //Find intrinsic and extrinsic camera parameters
     double rms = calibrateCamera(objectPoints, imagePoints, imageSize, cameraMatrix,
-                                 distCoeffs, rvecs, tvecs, s.flag|CV_CALIB_FIX_K4|CV_CALIB_FIX_K5);
+                                 distCoeffs, rvecs, tvecs, flag);
 
     bool ok = checkRange(cameraMatrix) && checkRange(distCoeffs);
 
@@ -392,14 +419,14 @@ static void saveCameraParams( Settings& s, Size& imageSize, Mat& cameraMatrix, M
     }
 }
 
-bool runCalibrationAndSave(Settings& s, Size imageSize, Mat&  cameraMatrix, Mat& distCoeffs,vector<vector<Point2f> > imagePoints )
+bool runCalibrationAndSave(Settings& s, Size imageSize, Mat&  cameraMatrix, Mat& distCoeffs,vector<vector<Point2f> > imagePoints, bool warmStart )
 {
     vector<Mat> rvecs, tvecs;
     vector<float> reprojErrs;
     double totalAvgErr = 0;
 
     bool ok = runCalibration(s,imageSize, cameraMatrix, distCoeffs, imagePoints, rvecs, tvecs,
-                             reprojErrs, totalAvgErr);
+                             reprojErrs, totalAvgErr, warmStart);
     cout << (ok ? "Calibration succeeded" : "Calibration failed")
          << ".  Average re-projection error = "  << totalAvgErr ;
 
@@ -410,7 +437,681 @@ bool runCalibrationAndSave(Settings& s, Size imageSize, Mat&  cameraMatrix, Mat&
 }
 
 
-int CameraCalibration( string passed_settings_filename  )
+/*
+ * Incremental calibration
+ * -----------------------
+ * While views are being captured, the intrinsic parameters and distortion coefficients are updated after each
+ * accepted view so that progress can be reported and capture can stop as soon as the calibration is good enough.
+ *
+ * The first INCREMENTAL_INITIAL_VIEWS views are calibrated with calibrateCamera().  Each later view is added as a
+ * recursive least-squares update: its pose is found with solvePnP() using the current intrinsics, projectPoints()
+ * provides the Jacobian of its reprojection error, the pose parameters are eliminated with the Schur complement to
+ * give the view's information block for the intrinsic parameters, and the intrinsics are updated by a few Gauss-Newton
+ * iterations warm-started from the previous solution, with the information accumulated from the earlier views acting
+ * as a prior.  Each update therefore costs one view's work, whatever the number of views already captured.
+ *
+ * The covariance of the intrinsic parameters is the inverse of the accumulated information scaled by the residual
+ * variance; capture stops once the standard deviations of the focal length and principal point are all below
+ * INCREMENTAL_MAX_STD_DEV pixels.  The final calibration is computed by calibrateCamera() starting from the
+ * incremental estimate.
+ */
+
+#define INCREMENTAL_INITIAL_VIEWS   3
+#define INCREMENTAL_ITERATIONS      3
+#define INCREMENTAL_MAX_STD_DEV     1.0    // pixels
+#define INCREMENTAL_INTRINSICS      12     // fx, fy, cx, cy, and eight distortion coefficients, as in projectPoints()
+
+class IncrementalCalibration
+{
+public:
+    IncrementalCalibration(Settings& s) : s_(s) { reset(); }
+
+    void reset()
+    {
+        int j;
+
+        initialViews_.clear();
+        cameraMatrix_.release();
+        distCoeffs_.release();
+        sse_ = 0;
+        observations_ = 0;
+        initialised_ = false;
+
+        calcBoardCornerPositions(s_.boardSize, s_.squareSize, objectPoints_, s_.calibrationPattern);
+
+        /* free parameters: the columns of M map them to the full set of intrinsic parameters */
+
+        vector<int> free;
+        if( !(s_.flag & CV_CALIB_FIX_ASPECT_RATIO) )    free.push_back(0);
+        free.push_back(1);                              // with a fixed aspect ratio, column 0 also maps to fx (see initialise)
+        if( !(s_.flag & CV_CALIB_FIX_PRINCIPAL_POINT) ) { free.push_back(2); free.push_back(3); }
+        free.push_back(4); free.push_back(5);
+        if( !(s_.flag & CV_CALIB_ZERO_TANGENT_DIST) )   { free.push_back(6); free.push_back(7); }
+        free.push_back(8);
+
+        M_ = Mat::zeros(INCREMENTAL_INTRINSICS, (int)free.size(), CV_64F);
+        for( j = 0; j < (int)free.size(); j++ )
+            M_.at<double>(free[j], j) = 1.0;
+
+        information_ = Mat::zeros((int)free.size(), (int)free.size(), CV_64F);
+    }
+
+    /* add a view; returns true once the intrinsic parameters are known well enough to stop capturing */
+    bool addView(const vector<Point2f>& imagePoints, Size imageSize)
+    {
+        if( !initialised_ )
+        {
+            initialViews_.push_back(imagePoints);
+            if( (int)initialViews_.size() < INCREMENTAL_INITIAL_VIEWS )
+                return false;
+
+            initialise(imageSize);
+            return converged();
+        }
+
+        Mat rvec, tvec;
+        solvePnP(objectPoints_, imagePoints, cameraMatrix_, distCoeffs_, rvec, tvec);
+
+        Mat theta0 = intrinsics();
+        Mat delta  = Mat::zeros(information_.rows, 1, CV_64F);
+        Mat S, g, A, B, ge;
+        double sse;
+
+        for( int iteration = 0; iteration < INCREMENTAL_ITERATIONS; iteration++ )
+        {
+            linearise(imagePoints, rvec, tvec, A, B, S, g, ge);
+
+            // Gauss-Newton step for this view plus the prior given by the information of the earlier views, centred on theta0
+            Mat delta_intrinsics;
+            if( !solve(information_ + S, g - information_ * delta, delta_intrinsics, DECOMP_CHOLESKY) )
+                break;
+
+            // back-substitute for the pose of this view
+            Mat delta_pose;
+            solve(A, ge - B * delta_intrinsics, delta_pose, DECOMP_CHOLESKY);
+
+            rvec  += delta_pose.rowRange(0, 3);
+            tvec  += delta_pose.rowRange(3, 6);
+            delta += delta_intrinsics;
+            setIntrinsics(theta0 + M_ * delta);
+        }
+
+        sse = linearise(imagePoints, rvec, tvec, A, B, S, g, ge);
+        information_ += S;
+        sse_ += sse;
+        observations_ += 2 * (int)imagePoints.size() - 6;
+
+        return converged();
+    }
+
+    /* standard deviations in pixels of fx, fy, cx, and cy (zero for a fixed parameter) */
+    void standardDeviations(double sd[4]) const
+    {
+        int i;
+
+        for( i = 0; i < 4; i++ )
+            sd[i] = 0;
+
+        if( !initialised_ || observations_ <= information_.rows )
+            return;
+
+        double variance = sse_ / (observations_ - information_.rows);
+        Mat covariance = M_ * information_.inv(DECOMP_SVD) * M_.t() * variance;
+
+        for( i = 0; i < 4; i++ )
+            sd[i] = std::sqrt(std::max(covariance.at<double>(i, i), 0.0));
+    }
+
+    bool initialised() const { return initialised_; }
+    const Mat& cameraMatrix() const { return cameraMatrix_; }
+    const Mat& distCoeffs() const { return distCoeffs_; }
+
+private:
+    void initialise(Size imageSize)
+    {
+        vector<vector<Point3f> > objectPoints(initialViews_.size(), objectPoints_);
+        vector<Mat> rvecs, tvecs;
+        Mat A, B, S, g, ge;
+
+        cameraMatrix_ = Mat::eye(3, 3, CV_64F);
+        distCoeffs_   = Mat::zeros(8, 1, CV_64F);
+
+        calibrateCamera(objectPoints, initialViews_, imageSize, cameraMatrix_, distCoeffs_, rvecs, tvecs,
+                        s_.flag|CV_CALIB_FIX_K4|CV_CALIB_FIX_K5);
+
+        // with a fixed aspect ratio the free focal length is fy and fx = aspect * fy
+        if( s_.flag & CV_CALIB_FIX_ASPECT_RATIO )
+            M_.at<double>(0, 0) = cameraMatrix_.at<double>(0, 0) / cameraMatrix_.at<double>(1, 1);
+
+        for( size_t i = 0; i < initialViews_.size(); i++ )
+        {
+            sse_ += linearise(initialViews_[i], rvecs[i], tvecs[i], A, B, S, g, ge);
+            information_ += S;
+            observations_ += 2 * (int)initialViews_[i].size() - 6;
+        }
+        initialViews_.clear();
+        initialised_ = true;
+    }
+
+    /*
+     * Jacobian blocks of the reprojection error of one view: A = Je'Je, B = Je'Ji, and the Schur complement S and
+     * gradient g for the intrinsic parameters, and the gradient ge for the pose.  Returns the sum of squared errors.
+     */
+    double linearise(const vector<Point2f>& imagePoints, const Mat& rvec, const Mat& tvec,
+                     Mat& A, Mat& B, Mat& S, Mat& g, Mat& ge) const
+    {
+        vector<Point2f> projected;
+        Mat jacobian;
+
+        projectPoints(objectPoints_, rvec, tvec, cameraMatrix_, distCoeffs_, projected, jacobian);
+
+        Mat residual = (Mat(imagePoints).reshape(1, 2 * (int)imagePoints.size()) -
+                        Mat(projected).reshape(1, 2 * (int)projected.size()));
+        residual.convertTo(residual, CV_64F);
+
+        Mat Je = jacobian.colRange(0, 6);
+        Mat Ji = jacobian.colRange(6, 6 + INCREMENTAL_INTRINSICS) * M_;
+
+        A = Je.t() * Je;
+        B = Je.t() * Ji;
+        ge = Je.t() * residual;
+        Mat C  = Ji.t() * Ji;
+        Mat gi = Ji.t() * residual;
+
+        Mat Ainv = A.inv(DECOMP_CHOLESKY);
+        S = C - B.t() * Ainv * B;
+        g = gi - B.t() * Ainv * ge;
+
+        return residual.dot(residual);
+    }
+
+    Mat intrinsics() const
+    {
+        Mat theta(INCREMENTAL_INTRINSICS, 1, CV_64F);
+
+        theta.at<double>(0) = cameraMatrix_.at<double>(0, 0);
+        theta.at<double>(1) = cameraMatrix_.at<double>(1, 1);
+        theta.at<double>(2) = cameraMatrix_.at<double>(0, 2);
+        theta.at<double>(3) = cameraMatrix_.at<double>(1, 2);
+        for( int i = 0; i < 8; i++ )
+            theta.at<double>(4 + i) = distCoeffs_.at<double>(i);
+        return theta;
+    }
+
+    void setIntrinsics(const Mat& theta)
+    {
+        cameraMatrix_.at<double>(0, 0) = theta.at<double>(0);
+        cameraMatrix_.at<double>(1, 1) = theta.at<double>(1);
+        cameraMatrix_.at<double>(0, 2) = theta.at<double>(2);
+        cameraMatrix_.at<double>(1, 2) = theta.at<double>(3);
+        for( int i = 0; i < 8; i++ )
+            distCoeffs_.at<double>(i) = theta.at<double>(4 + i);
+    }
+
+    bool converged() const
+    {
+        double sd[4];
+
+        if( !initialised_ )
+            return false;
+
+        standardDeviations(sd);
+        return sd[0] < INCREMENTAL_MAX_STD_DEV && sd[1] < INCREMENTAL_MAX_STD_DEV &&
+               sd[2] < INCREMENTAL_MAX_STD_DEV && sd[3] < INCREMENTAL_MAX_STD_DEV;
+    }
+
+    Settings& s_;
+    vector<Point3f> objectPoints_;
+    vector<vector<Point2f> > initialViews_;
+    Mat M_;                        // free parameters -> fx, fy, cx, cy, k1, k2, p1, p2, k3, k4, k5, k6
+    Mat information_;
+    Mat cameraMatrix_, distCoeffs_;
+    double sse_;
+    int observations_;
+    bool initialised_;
+};
+
+
+/*
+ * Undistortion service
+ * --------------------
+ * initUndistortRectifyMap() is expensive and undistort() calls it for every frame, so the undistortion maps are built
+ * once for each camera matrix, distortion coefficients, and image size, in the fixed-point CV_16SC2/CV_16UC1 format
+ * that remap() processes fastest, and saved in a binary file next to the calibration configuration file.
+ * As with undistort(), the camera matrix of the undistorted image is that of the calibration, so the output has the same
+ * scale and field of view as before.  When a camera is used, the calibration saved by the previous run is read at startup
+ * and the saved maps are memory-mapped and used in place, so loading takes milliseconds; they are rebuilt only if the
+ * calibration changes.  Frames are undistorted with remap() in parallel horizontal tiles.
+ *
+ * File format: undistortionMapHeaderType followed by map1 (width*height*4 bytes) and map2 (width*height*2 bytes)
+ */
+
+#define UNDISTORTION_MAP_MAGIC     "UDM1"
+#define UNDISTORTION_MAP_COEFFS    8
+#define UNDISTORTION_MAP_TILE_ROWS 32
+
+struct undistortionMapHeaderType {
+    char   magic[4];
+    int    width;
+    int    height;
+    int    reserved;
+    double cameraMatrix[9];
+    double distCoeffs[UNDISTORTION_MAP_COEFFS];
+};
+
+class RemapTileBody : public ParallelLoopBody
+{
+public:
+    RemapTileBody(const Mat& src, Mat& dst, const Mat& map1, const Mat& map2) :
+        src_(src), dst_(dst), map1_(map1), map2_(map2) {}
+
+    virtual void operator()(const Range& range) const
+    {
+        int row_start = range.start * UNDISTORTION_MAP_TILE_ROWS;
+        int row_end   = std::min(range.end * UNDISTORTION_MAP_TILE_ROWS, dst_.rows);
+
+        // the maps hold absolute source coordinates, so each tile of the output only needs its own rows of the maps
+        Mat dst_tile = dst_.rowRange(row_start, row_end);
+        remap(src_, dst_tile, map1_.rowRange(row_start, row_end), map2_.rowRange(row_start, row_end), INTER_LINEAR);
+    }
+
+private:
+    const Mat& src_;
+    Mat& dst_;
+    const Mat& map1_;
+    const Mat& map2_;
+};
+
+class UndistortionService
+{
+public:
+    UndistortionService() : mapped_(NULL), mapped_size_(0) { memset(&header_, 0, sizeof(header_)); }
+    ~UndistortionService() { release(); }
+
+    /* memory-map the maps saved in filename; returns false if there is no valid file */
+    bool load(const string& filename)
+    {
+        undistortionMapHeaderType header;
+        size_t map_bytes;
+
+        release();
+
+#ifdef ROS
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(header))
+        {
+            close(fd);
+            return false;
+        }
+
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            return false;
+
+        memcpy(&header, p, sizeof(header));
+        map_bytes = (size_t)header.width * header.height * 6;
+        if (memcmp(header.magic, UNDISTORTION_MAP_MAGIC, 4) != 0 || header.width <= 0 || header.height <= 0 ||
+            (size_t)st.st_size != sizeof(header) + map_bytes)
+        {
+            munmap(p, (size_t)st.st_size);
+            return false;
+        }
+
+        mapped_      = p;
+        mapped_size_ = (size_t)st.st_size;
+
+        unsigned char *data = (unsigned char *)p + sizeof(header);
+        map1_ = Mat(header.height, header.width, CV_16SC2, data);
+        map2_ = Mat(header.height, header.width, CV_16UC1, data + (size_t)header.width * header.height * 4);
+#else
+        FILE *fp = fopen(filename.c_str(), "rb");
+        if (fp == NULL)
+            return false;
+
+        if (fread(&header, sizeof(header), 1, fp) != 1 ||
+            memcmp(header.magic, UNDISTORTION_MAP_MAGIC, 4) != 0 || header.width <= 0 || header.height <= 0)
+        {
+            fclose(fp);
+            return false;
+        }
+        map_bytes = (size_t)header.width * header.height * 6;
+
+        map1_.create(header.height, header.width, CV_16SC2);
+        map2_.create(header.height, header.width, CV_16UC1);
+        if (fread(map1_.data, 1, map_bytes * 4 / 6, fp) != map_bytes * 4 / 6 ||
+            fread(map2_.data, 1, map_bytes * 2 / 6, fp) != map_bytes * 2 / 6)
+        {
+            fclose(fp);
+            map1_.release();
+            map2_.release();
+            return false;
+        }
+        fclose(fp);
+#endif
+
+        header_ = header;
+        return true;
+    }
+
+    /* make sure the maps correspond to the calibration, loading them from filename or building and saving them if necessary */
+    bool prepare(const Mat& cameraMatrix, const Mat& distCoeffs, Size imageSize, const string& filename)
+    {
+        undistortionMapHeaderType header;
+
+        makeHeader(cameraMatrix, distCoeffs, imageSize, &header);
+
+        if (!map1_.empty() && sameCalibration(header))
+            return true;
+
+        if (load(filename) && sameCalibration(header))
+            return true;
+
+        release();
+
+        initUndistortRectifyMap(cameraMatrix, distCoeffs, Mat(), cameraMatrix,    // same output as undistort()
+            imageSize, CV_16SC2, map1_, map2_);
+        header_ = header;
+
+        return save(filename);
+    }
+
+    /* undistort a frame; the frame must have the size for which the maps were built */
+    void apply(const Mat& src, Mat& dst) const
+    {
+        CV_Assert(!map1_.empty() && src.cols == map1_.cols && src.rows == map1_.rows);
+
+        dst.create(src.size(), src.type());
+        parallel_for_(Range(0, (src.rows + UNDISTORTION_MAP_TILE_ROWS - 1) / UNDISTORTION_MAP_TILE_ROWS),
+                      RemapTileBody(src, dst, map1_, map2_));
+    }
+
+private:
+    static void makeHeader(const Mat& cameraMatrix, const Mat& distCoeffs, Size imageSize, undistortionMapHeaderType *header)
+    {
+        Mat K, D;
+        int i;
+
+        memset(header, 0, sizeof(*header));
+        memcpy(header->magic, UNDISTORTION_MAP_MAGIC, 4);
+        header->width  = imageSize.width;
+        header->height = imageSize.height;
+
+        cameraMatrix.convertTo(K, CV_64F);
+        distCoeffs.convertTo(D, CV_64F);
+        for (i = 0; i < 9; i++)
+            header->cameraMatrix[i] = K.at<double>(i / 3, i % 3);
+        for (i = 0; i < (int)D.total() && i < UNDISTORTION_MAP_COEFFS; i++)
+            header->distCoeffs[i] = D.ptr<double>()[i];
+    }
+
+    bool sameCalibration(const undistortionMapHeaderType& header) const
+    {
+        return header.width == header_.width && header.height == header_.height &&
+               memcmp(header.cameraMatrix, header_.cameraMatrix, sizeof(header.cameraMatrix)) == 0 &&
+               memcmp(header.distCoeffs, header_.distCoeffs, sizeof(header.distCoeffs)) == 0;
+    }
+
+    bool save(const string& filename) const
+    {
+        FILE *fp = fopen(filename.c_str(), "wb");
+        if (fp == NULL)
+            return false;
+
+        Mat map1 = map1_.isContinuous() ? map1_ : map1_.clone();
+        Mat map2 = map2_.isContinuous() ? map2_ : map2_.clone();
+
+        bool ok = fwrite(&header_, sizeof(header_), 1, fp) == 1 &&
+                  fwrite(map1.data, map1.elemSize(), map1.total(), fp) == map1.total() &&
+                  fwrite(map2.data, map2.elemSize(), map2.total(), fp) == map2.total();
+        fclose(fp);
+        return ok;
+    }
+
+    void release()
+    {
+        map1_.release();
+        map2_.release();
+#ifdef ROS
+        if (mapped_ != NULL)
+            munmap(mapped_, mapped_size_);
+#endif
+        mapped_ = NULL;
+        mapped_size_ = 0;
+    }
+
+    UndistortionService(const UndistortionService&);
+    UndistortionService& operator=(const UndistortionService&);
+
+    undistortionMapHeaderType header_;
+    Mat    map1_, map2_;
+    void  *mapped_;
+    size_t mapped_size_;
+};
+
+/* the calibration written by saveCameraParams(); returns false if there is none */
+static bool readCameraParams(const string& filename, Size& imageSize, Mat& cameraMatrix, Mat& distCoeffs)
+{
+    FileStorage fs(filename, FileStorage::READ);
+
+    if (!fs.isOpened())
+        return false;
+
+    fs["image_Width"]             >> imageSize.width;
+    fs["image_Height"]            >> imageSize.height;
+    fs["Camera_Matrix"]           >> cameraMatrix;
+    fs["Distortion_Coefficients"] >> distCoeffs;
+
+    return imageSize.width > 0 && imageSize.height > 0 &&
+           cameraMatrix.rows == 3 && cameraMatrix.cols == 3 && distCoeffs.total() >= 4;
+}
+
+static string undistortionMapFilename(const string& settings_filename)
+{
+    size_t dot = settings_filename.find_last_of('.');
+    size_t slash = settings_filename.find_last_of('/');
+
+    if (dot != string::npos && (slash == string::npos || dot > slash))
+        return settings_filename.substr(0, dot) + ".udm";
+    return settings_filename + ".udm";
+}
+
+
+/*
+ * Calibration front end for image lists
+ * -------------------------------------
+ * With an image list, all the images are available at the outset, so the calibration pattern is detected in all of 
+ * them concurrently with parallel_for_ rather than one frame at a time, and calibrateCamera() is run once on the 
+ * points collected from the images in which the pattern was found.
+ *
+ * Chessboards are first detected in a copy of the image reduced to at most CALIBRATION_DETECTION_WIDTH pixels wide,
+ * which is much faster than detection at full resolution; the corners are then scaled up and refined with cornerSubPix
+ * in the full-resolution image, which only examines a small window around each corner.  If the reduced image fails,
+ * detection falls back to the full-resolution image.  In headless mode no images are displayed.
+ */
+
+#define CALIBRATION_DETECTION_WIDTH 640
+
+struct patternDetectionType {
+    bool            found;
+    bool            reduced;          // pattern found in the reduced image
+    Size            imageSize;
+    vector<Point2f> pointBuf;
+    double          detection_ms;
+};
+
+static bool findCalibrationPattern(Settings& s, const Mat& view, vector<Point2f>& pointBuf, bool *reduced)
+{
+    bool found;
+
+    *reduced = false;
+
+    switch( s.calibrationPattern )
+    {
+    case Settings::CHESSBOARD:
+        {
+            Mat viewGray;
+            cvtColor(view, viewGray, CV_BGR2GRAY);
+
+            found = false;
+            if( viewGray.cols > CALIBRATION_DETECTION_WIDTH )
+            {
+                Mat small;
+                double scale = (double) CALIBRATION_DETECTION_WIDTH / viewGray.cols;
+                resize(viewGray, small, Size(), scale, scale, INTER_AREA);
+
+                found = findChessboardCorners( small, s.boardSize, pointBuf,
+                    CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
+
+                if( found )
+                {
+                    for( size_t i = 0; i < pointBuf.size(); i++ )
+                        pointBuf[i] *= (float) (1.0 / scale);
+                    *reduced = true;
+                }
+            }
+
+            if( !found )
+                found = findChessboardCorners( viewGray, s.boardSize, pointBuf,
+                    CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
+
+            // improve the found corners' coordinate accuracy at full resolution
+            if( found )
+                cornerSubPix( viewGray, pointBuf, Size(11,11),
+                    Size(-1,-1), TermCriteria( CV_TERMCRIT_EPS+CV_TERMCRIT_ITER, 30, 0.1 ));
+        }
+        break;
+    case Settings::CIRCLES_GRID:
+        found = findCirclesGrid( view, s.boardSize, pointBuf );
+        break;
+    case Settings::ASYMMETRIC_CIRCLES_GRID:
+        found = findCirclesGrid( view, s.boardSize, pointBuf, CALIB_CB_ASYMMETRIC_GRID );
+        break;
+    default:
+        found = false;
+        break;
+    }
+    return found;
+}
+
+class PatternDetectionBody : public ParallelLoopBody
+{
+public:
+    PatternDetectionBody(Settings& s, vector<patternDetectionType>& detections) : s_(s), detections_(detections) {}
+
+    virtual void operator()(const Range& range) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            patternDetectionType& d = detections_[i];
+            int64 start_ticks = getTickCount();
+
+            Mat view = imread(s_.imageList[i], CV_LOAD_IMAGE_COLOR);
+
+            d.found = false;
+            d.reduced = false;
+            if( !view.empty() )
+            {
+                d.imageSize = view.size();
+                if( s_.flipVertical )    flip( view, view, 0 );
+                d.found = findCalibrationPattern(s_, view, d.pointBuf, &d.reduced);
+            }
+            d.detection_ms = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+        }
+    }
+
+private:
+    Settings& s_;
+    vector<patternDetectionType>& detections_;
+};
+
+static int calibrateFromImageList(Settings& s, bool headless, UndistortionService& undistortion, const string& mapFilename)
+{
+    vector<patternDetectionType> detections(s.imageList.size());
+    vector<vector<Point2f> > imagePoints;
+    Mat cameraMatrix, distCoeffs;
+    Size imageSize;
+    const char ESC_KEY = 27;
+    int64 start_ticks;
+    double elapsed_ms, total_detection_ms = 0;
+    int i;
+
+    start_ticks = getTickCount();
+    parallel_for_(Range(0, (int)s.imageList.size()), PatternDetectionBody(s, detections));
+    elapsed_ms = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+
+    for( i = 0; i < (int)detections.size(); i++ )
+    {
+        printf("%-40s %s %8.1f ms\n", s.imageList[i].c_str(),
+               !detections[i].found ? "not found          " :
+               detections[i].reduced ? "found (reduced)    " : "found (full size)  ", detections[i].detection_ms);
+        total_detection_ms += detections[i].detection_ms;
+
+        if( detections[i].found && imagePoints.size() < (unsigned)s.nrFrames )
+        {
+            if( imagePoints.size() > 0 && detections[i].imageSize != imageSize )
+            {
+                printf("%s skipped: image size differs from the first image\n", s.imageList[i].c_str());
+                continue;
+            }
+            imageSize = detections[i].imageSize;
+            imagePoints.push_back(detections[i].pointBuf);
+        }
+    }
+    printf("Pattern detection: %d images, %8.1f ms total detection time, %8.1f ms elapsed with %d threads\n\n",
+           (int)detections.size(), total_detection_ms, elapsed_ms, getNumThreads());
+
+    if( imagePoints.empty() )
+    {
+        cout << "Calibration failed: the pattern was not found in any image" << endl;
+        return -1;
+    }
+
+    if( !runCalibrationAndSave(s, imageSize, cameraMatrix, distCoeffs, imagePoints) )
+        return -1;
+    cout << endl;
+
+    if( !undistortion.prepare(cameraMatrix, distCoeffs, imageSize, mapFilename) )
+        cout << "Could not save the undistortion maps to " << mapFilename << endl;
+
+    if( headless )
+        return 0;
+
+    // -----------------------Show the detected corners and the undistorted image for the image list -------------
+    Mat view, rview;
+
+    for( i = 0; i < (int)s.imageList.size(); i++ )
+    {
+        view = imread(s.imageList[i], 1);
+        if( view.empty() )
+            continue;
+
+        if( s.showUndistorsed && view.size() == imageSize )
+        {
+            undistortion.apply(view, rview);
+        }
+        else
+        {
+            if( s.flipVertical )    flip( view, view, 0 );
+            if( detections[i].found )
+                drawChessboardCorners( view, s.boardSize, Mat(detections[i].pointBuf), true );
+            rview = view;
+        }
+        imshow("Image View", rview);
+        char c = (char)waitKey();
+        if( c  == ESC_KEY || c == 'q' || c == 'Q' )
+            break;
+    }
+
+    return 0;
+}
+
+
+int CameraCalibration( string passed_settings_filename, bool headless )
 {
     Settings s;
     //const string inputSettingsFile = (passed_settings_filename != NULL) ? passed_settings_filename : "default.xml";
@@ -430,13 +1131,32 @@ int CameraCalibration( string passed_settings_filename  )
         return -1;
     }
 
+    UndistortionService undistortion;
+    string mapFilename = undistortionMapFilename(passed_settings_filename);
+
+    if (s.inputType == Settings::IMAGE_LIST)
+        return calibrateFromImageList(s, headless, undistortion, mapFilename);
+
     vector<vector<Point2f> > imagePoints;
     Mat cameraMatrix, distCoeffs;
-    Size imageSize;
-    int mode = s.inputType == Settings::IMAGE_LIST ? CAPTURING : DETECTION;
+    Size imageSize, calibratedSize;
+    int mode = DETECTION;
+
+    /* start from the calibration saved by the previous run, with its undistortion maps; 'g' recalibrates */
+    if (readCameraParams(s.outputFileName, calibratedSize, cameraMatrix, distCoeffs))
+    {
+        int64 start_ticks = getTickCount();
+
+        if (undistortion.prepare(cameraMatrix, distCoeffs, calibratedSize, mapFilename))
+            printf("Calibration read from %s, undistortion maps ready in %.2f ms\n", s.outputFileName.c_str(),
+                   (getTickCount() - start_ticks) * 1000.0 / getTickFrequency());
+        mode = CALIBRATED;
+    }
     clock_t prevTimestamp = 0;
     const Scalar RED(0,0,255), GREEN(0,255,0);
     const char ESC_KEY = 27;
+    IncrementalCalibration incremental(s);
+    bool uncertaintyReached = false;
 
     for(int i = 0;;++i)
     {
@@ -446,9 +1166,16 @@ int CameraCalibration( string passed_settings_filename  )
       view = s.nextImage();
 
       //-----  If no more image, or got enough, then stop calibration and show result -------------
-      if( mode == CAPTURING && imagePoints.size() >= (unsigned)s.nrFrames )
+      if( mode == CAPTURING && (imagePoints.size() >= (unsigned)s.nrFrames || uncertaintyReached) )
       {
-          if( runCalibrationAndSave(s, imageSize,  cameraMatrix, distCoeffs, imagePoints))
+          bool warmStart = incremental.initialised();
+          if( warmStart )
+          {
+              cameraMatrix = incremental.cameraMatrix().clone();   // warm start the final calibration
+              distCoeffs   = incremental.distCoeffs().clone();
+          }
+          uncertaintyReached = false;
+          if( runCalibrationAndSave(s, imageSize,  cameraMatrix, distCoeffs, imagePoints, warmStart))
               mode = CALIBRATED;
           else
               mode = DETECTION;
@@ -462,45 +1189,39 @@ int CameraCalibration( string passed_settings_filename  )
 
 
         imageSize = view.size();  // Format input image.
+        if( mode == CALIBRATED && imagePoints.empty() && imageSize != calibratedSize )
+        {
+            mode = DETECTION;     // the saved calibration is for another image size
+            cameraMatrix.release();
+            distCoeffs.release();
+        }
         if( s.flipVertical )    flip( view, view, 0 );
 
         vector<Point2f> pointBuf;
 
-        bool found;
-        switch( s.calibrationPattern ) // Find feature points on the input format
-        {
-        case Settings::CHESSBOARD:
-            found = findChessboardCorners( view, s.boardSize, pointBuf,
-                CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
-            break;
-        case Settings::CIRCLES_GRID:
-            found = findCirclesGrid( view, s.boardSize, pointBuf );
-            break;
-        case Settings::ASYMMETRIC_CIRCLES_GRID:
-            found = findCirclesGrid( view, s.boardSize, pointBuf, CALIB_CB_ASYMMETRIC_GRID );
-            break;
-        default:
-            found = false;
-            break;
-        }
+        bool reduced;
+        bool found = findCalibrationPattern(s, view, pointBuf, &reduced); // Find feature points on the input format
 
         if ( found )                // If done with success,
         {
-              // improve the found corners' coordinate accuracy for chessboard
-                if( s.calibrationPattern == Settings::CHESSBOARD)
-                {
-                    Mat viewGray;
-                    cvtColor(view, viewGray, CV_BGR2GRAY);
-                    cornerSubPix( viewGray, pointBuf, Size(11,11),
-                        Size(-1,-1), TermCriteria( CV_TERMCRIT_EPS+CV_TERMCRIT_ITER, 30, 0.1 ));
-                }
-
                 if( mode == CAPTURING &&  // For camera only take new samples after delay time
                     (!s.inputCapture.isOpened() || clock() - prevTimestamp > s.delay*1e-3*CLOCKS_PER_SEC) )
                 {
                     imagePoints.push_back(pointBuf);
                     prevTimestamp = clock();
                     blinkOutput = s.inputCapture.isOpened();
+
+                    uncertaintyReached = incremental.addView(pointBuf, imageSize);
+                    if( incremental.initialised() )
+                    {
+                        double sd[4];
+                        incremental.standardDeviations(sd);
+                        printf("View %2d: fx %7.1f (%5.2f) fy %7.1f (%5.2f) cx %6.1f (%5.2f) cy %6.1f (%5.2f)%s\n",
+                               (int)imagePoints.size(),
+                               incremental.cameraMatrix().at<double>(0,0), sd[0], incremental.cameraMatrix().at<double>(1,1), sd[1],
+                               incremental.cameraMatrix().at<double>(0,2), sd[2], incremental.cameraMatrix().at<double>(1,2), sd[3],
+                               uncertaintyReached ? "  uncertainty threshold reached" : "");
+                    }
                 }
 
                 // Draw the corners.
@@ -533,7 +1254,8 @@ int CameraCalibration( string passed_settings_filename  )
         if( mode == CALIBRATED && s.showUndistorsed )
         {
             Mat temp = view.clone();
-            undistort(temp, view, cameraMatrix, distCoeffs);
+            undistortion.prepare(cameraMatrix, distCoeffs, imageSize, mapFilename);
+            undistortion.apply(temp, view);
         }
 
         //------------------------------ Show image and check for input commands -------------------
@@ -550,27 +1272,10 @@ int CameraCalibration( string passed_settings_filename  )
         {
             mode = CAPTURING;
             imagePoints.clear();
-        }
-    }
-
-    // -----------------------Show the undistorted image for the image list ------------------------
-    if( s.inputType == Settings::IMAGE_LIST && s.showUndistorsed )
-    {
-        Mat view, rview, map1, map2;
-        initUndistortRectifyMap(cameraMatrix, distCoeffs, Mat(),
-            getOptimalNewCameraMatrix(cameraMatrix, distCoeffs, imageSize, 1, imageSize, 0),
-            imageSize, CV_16SC2, map1, map2);
-
-        for(int i = 0; i < (int)s.imageList.size(); i++ )
-        {
-            view = imread(s.imageList[i], 1);
-            if(view.empty())
-                continue;
-            remap(view, rview, map1, map2, INTER_LINEAR);
-            imshow("Image View", rview);
-            char c = (char)waitKey();
-            if( c  == ESC_KEY || c == 'q' || c == 'Q' )
-                break;
+            cameraMatrix.release();   // a new calibration, not a refinement of the previous one
+            distCoeffs.release();
+            incremental.reset();
+            uncertaintyReached = false;
         }
     }
 
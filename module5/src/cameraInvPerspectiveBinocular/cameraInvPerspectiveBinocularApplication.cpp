@@ -19,6 +19,14 @@
   After computing the inverse perspective transformation, the user can then interactively select a point in the left image
   and a corresponding point in the right image.  The application then uses the inverse perspective transformation to 
   compute the world x, y, and z coordinates of the selected point.
+
+  If the camera models define an epipolar geometry, the corresponding point in the right image is found automatically
+  by searching along the epipolar line, so the user only needs to click on the left image.
+
+  If the input file has a fifth line, it is the filename of a binary PLY file in the ../data/ directory.
+  A dense reconstruction is then computed first: the images are rectified, a disparity map is computed 
+  by semi-global matching, and the triangulated points are written to the PLY file. The time taken by each 
+  stage is reported as the mean of several runs.
  
 
 
@@ -32,6 +40,18 @@
 
   David Vernon
   2  April 2018
+
+  Audit Trail
+  --------------------
+  Use the batched closed-form triangulation and report the reprojection residual;
+  the SVD solution is still computed for comparison in debug mode
+  16 October 2026
+
+  Find the right image point automatically by epipolar correspondence search
+  16 October 2026
+
+  Added optional dense reconstruction with per-stage timing
+  16 October 2026
 */
 
  
@@ -48,6 +68,7 @@ Mat rightImage;
 
 const char* left_window_name       = "Left Image";
 const char* right_window_name      = "Right Image";
+const char* disparity_window_name  = "Disparity";
 
 int main() {
    
@@ -80,6 +101,26 @@ int main() {
    Mat rightImageCopy;
 
    Point3f world_sample_point;
+   vector<Point2f> left_points;
+   vector<Point2f> right_points;
+   vector<Point3f> world_points;
+   vector<float>   residuals;
+   vector<Point2f> features;
+   Point2f         searched_left_point;
+   Matx33d         F;
+   Mat             left_match_image;
+   Mat             right_match_image;
+   Mat             left_grey_image;
+   bool            epipolar_geometry;
+   float           score;
+   int             number_matched;
+   int64           start_ticks;
+   double          elapsed_ms;
+   char            point_cloud_filename[MAX_FILENAME_LENGTH];
+   bool            dense_reconstruction;
+   Mat             disparity;
+   Mat             disparity_image;
+   denseStereoTimingType timing;
    Point2f text_coordinates; 
 
    Scalar colour(0,255,0);
@@ -140,6 +181,9 @@ int main() {
       prompt_and_exit(1);
    }
 
+   /* an optional fifth line gives the filename for the point cloud computed by the dense reconstruction */
+   dense_reconstruction = fscanf(fp_in, "%s", point_cloud_filename) != EOF;
+
    /* get the left and right camera models */
    strcpy(file_path_and_filename, data_dir);
    strcat(file_path_and_filename, left_camera_model_filename);
@@ -192,6 +236,58 @@ int main() {
       prompt_and_exit(-1);
    }
 
+   /* Dense reconstruction: rectify the images, compute the disparity map by semi-global matching,  */
+   /* and write the triangulated points to a PLY file; the reconstruction is repeated to benchmark it */
+
+   if (dense_reconstruction) {
+      strcpy(file_path_and_filename, data_dir);
+      strcat(file_path_and_filename, point_cloud_filename);
+      strcpy(point_cloud_filename, file_path_and_filename);
+
+      memset(&timing, 0, sizeof(timing));
+
+      for (i=0; i<DENSE_STEREO_BENCHMARK_RUNS; i++) {
+         if (!denseStereoReconstruction(leftImage, rightImage, left_camera_model, right_camera_model, point_cloud_filename, disparity, &timing)) {
+            break;
+         }
+      }
+
+      if (i == DENSE_STEREO_BENCHMARK_RUNS) {
+         printf("\nDense reconstruction of a %d x %d image pair, mean of %d runs\n", leftImage.cols, leftImage.rows, DENSE_STEREO_BENCHMARK_RUNS);
+         printDenseStereoTiming(&timing, DENSE_STEREO_BENCHMARK_RUNS);
+         printf("\n");
+
+         disparity.convertTo(disparity_image, CV_8U, 255.0 / SGM_MAX_DISPARITY);   // invalid disparities (-1) saturate to 0
+         namedWindow(disparity_window_name, CV_WINDOW_AUTOSIZE);
+         imshow(disparity_window_name, disparity_image);
+      }
+   }
+
+   /* If the camera models define an epipolar geometry, the corresponding point in the right image is found automatically  */
+   /* when the user clicks on the left image; otherwise the user must click on the corresponding point in the right image */
+
+   epipolar_geometry = computeFundamentalMatrix(left_camera_model, right_camera_model, F);
+
+   if (epipolar_geometry) {
+      prepareStereoMatchImage(leftImage,  left_match_image);
+      prepareStereoMatchImage(rightImage, right_match_image);
+
+      /* match and triangulate the corner features in the left image to report the throughput */
+
+      left_match_image.convertTo(left_grey_image, CV_8U);
+      goodFeaturesToTrack(left_grey_image, features, MAX_NUMBER_OF_FEATURES, 0.01, 10);
+
+      start_ticks = getTickCount();
+      number_matched = matchAndTriangulate(left_match_image, right_match_image, F, left_camera_model, right_camera_model,
+                                           features, left_points, right_points, world_points, residuals);
+      elapsed_ms = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+
+      printf("%d of %d left image features matched and triangulated in %.2f ms\n\n", number_matched, (int) features.size(), elapsed_ms);
+   }
+   else {
+      printf("The camera models do not define an epipolar geometry: click on the corresponding point in the right image.\n\n");
+   }
+
    /* Create a window for left and display it */
    namedWindow(left_window_name, CV_WINDOW_AUTOSIZE );
    setMouseCallback(left_window_name, getLeftSamplePoint);    // use this callback to get the coordinates of the sample point
@@ -205,11 +301,40 @@ int main() {
    /* now wait for user interaction - mouse click of left and right images */
    number_of_left_sample_points = 0;
    number_of_right_sample_points = 0;
+   searched_left_point = Point2f(-1, -1);
    do {
       waitKey(30);   
+
+      if (epipolar_geometry && number_of_left_sample_points == 1 && number_of_right_sample_points == 0 &&
+          left_sample_point != searched_left_point) {
+
+         searched_left_point = left_sample_point;   // search once for each click
+
+         score = findEpipolarCorrespondence(left_match_image, right_match_image, F, left_sample_point, &right_sample_point);
+
+         if (score >= ZNCC_MIN_SCORE) {
+            number_of_right_sample_points = 1;
+         }
+         else {
+            printf("No corresponding point found (score %4.2f): click on the corresponding point in the right image\n", score);
+         }
+      }
+
       if (number_of_left_sample_points == 1 && number_of_right_sample_points == 1) {
                                                          
-         inversePerspectiveTransformation(left_sample_point, right_sample_point, left_camera_model, right_camera_model, &world_sample_point);
+         left_points.assign(1, left_sample_point);
+         right_points.assign(1, right_sample_point);
+
+         triangulateStereoPoints(left_points, right_points, left_camera_model, right_camera_model, world_points, residuals);
+         world_sample_point = world_points[0];
+
+         printf("(%3d, %3d) (%3d, %3d) -> (%4.1f, %4.1f, %4.1f)  reprojection residual %4.2f pixels\n", 
+                (int) left_sample_point.x, (int) left_sample_point.y, (int) right_sample_point.x, (int) right_sample_point.y,
+                world_sample_point.x, world_sample_point.y, world_sample_point.z, residuals[0]);
+
+         if (debug) {
+            inversePerspectiveTransformation(left_sample_point, right_sample_point, left_camera_model, right_camera_model, &world_sample_point);
+         }
 
          leftImageCopy  = leftImage.clone();
          rightImageCopy = rightImage.clone();
@@ -235,6 +360,7 @@ int main() {
 
    destroyWindow(left_window_name);  
    destroyWindow(right_window_name); 
+   if (dense_reconstruction) destroyWindow(disparity_window_name);
 
    fclose(fp_in);
    fclose(fp_left_camera_model);
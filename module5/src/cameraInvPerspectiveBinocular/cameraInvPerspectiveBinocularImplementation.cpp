@@ -7,6 +7,18 @@
 
   David Vernon
   2 April 2018
+
+  Audit Trail
+  --------------------
+  Added batched triangulation using the closed-form normal equations and Cramer's rule,
+  with the reprojection residual of each point
+  16 October 2026
+
+  Added automatic correspondence search along the epipolar line using ZNCC with sub-pixel peak refinement
+  16 October 2026
+
+  Added dense reconstruction: rectification, semi-global matching, and triangulation to a binary PLY point cloud
+  16 October 2026
 */
  
 #include "module5/cameraInvPerspectiveBinocular.h"
@@ -88,8 +100,8 @@ void inversePerspectiveTransformation(Point2f left_sample_point, Point2f right_s
    float p2, q2, r2, s2;
 
 
-   printf("Left camera model\n");
    if (debug) {
+      printf("Left camera model\n");
       for (i=0; i<3; i++) {
          for (j=0; j<4; j++) {
             printf("%f ", left_camera_model[i][j]);
@@ -210,6 +222,1284 @@ void inversePerspectiveTransformation(Point2f left_sample_point, Point2f right_s
    }
 }
 
+/*=======================================================*/
+/* Batched stereo triangulation                          */ 
+/*=======================================================*/
+
+/*
+ * The linear system X c = y solved by inversePerspectiveTransformation() has four equations in three unknowns.
+ * Its least-squares solution is the solution of the 3x3 normal equations (X^T X) c = X^T y, which is formed here 
+ * in closed form and solved with Cramer's rule, so no matrices are allocated and no SVD is computed.
+ * When the normal equations are (close to) singular, e.g. when the camera models do not constrain z, 
+ * the point is solved with the SVD instead so that the result is the same minimum-norm solution.
+ *
+ * The kernel is written once for a generic arithmetic type so that it is compiled both for scalars (double) and,
+ * when the platform supports it, for two points at a time using OpenCV's universal SIMD intrinsics (v_float64x2).
+ */
+
+#define TRIANGULATION_SINGULARITY_THRESHOLD 1e-10   // |det N| / (N00 N11 N22) below this => solve with the SVD
+
+static inline double triangulation_sqrt(double a)           { return sqrt(a); }
+static inline double triangulation_abs(double a)            { return fabs(a); }
+static inline void   triangulation_setall(double &a, double c) { a = c; }
+
+#if CV_SIMD128_64F
+static inline v_float64x2 triangulation_sqrt(const v_float64x2 &a)      { return v_sqrt(a); }
+static inline v_float64x2 triangulation_abs(const v_float64x2 &a)       { return v_abs(a); }
+static inline void        triangulation_setall(v_float64x2 &a, double c) { a = v_setall_f64(c); }
+#endif
+
+
+/*
+ * reprojection_residual
+ * RMS distance in pixels between the left and right image points and the projection of the world point (x, y, z) 
+ * into the left and right cameras
+ */
+
+template <typename T>
+static inline T reprojection_residual(const T lm[3][4], const T rm[3][4],
+                                      T ul, T vl, T ur, T vr,
+                                      T x, T y, T z) {
+   T w, du, dv, sum;
+   T half;
+
+   triangulation_setall(half, 0.5);
+
+   w   = lm[2][0]*x + lm[2][1]*y + lm[2][2]*z + lm[2][3];
+   du  = (lm[0][0]*x + lm[0][1]*y + lm[0][2]*z + lm[0][3]) / w - ul;
+   dv  = (lm[1][0]*x + lm[1][1]*y + lm[1][2]*z + lm[1][3]) / w - vl;
+   sum = du*du + dv*dv;
+
+   w   = rm[2][0]*x + rm[2][1]*y + rm[2][2]*z + rm[2][3];
+   du  = (rm[0][0]*x + rm[0][1]*y + rm[0][2]*z + rm[0][3]) / w - ur;
+   dv  = (rm[1][0]*x + rm[1][1]*y + rm[1][2]*z + rm[1][3]) / w - vr;
+   sum = sum + du*du + dv*dv;
+
+   return triangulation_sqrt(sum * half);
+}
+
+
+/*
+ * stereo_equations
+ * The rows of X and the vector y of the system X c = y for one (or, for SIMD types, several) correspondences
+ */
+
+template <typename T>
+static inline void stereo_equations(const T lm[3][4], const T rm[3][4],
+                                    T ul, T vl, T ur, T vr,
+                                    T a[4][3], T k[4]) {
+   int i;
+
+   for (i=0; i<3; i++) {
+      a[0][i] = lm[0][i] - ul * lm[2][i];
+      a[1][i] = lm[1][i] - vl * lm[2][i];
+      a[2][i] = rm[0][i] - ur * rm[2][i];
+      a[3][i] = rm[1][i] - vr * rm[2][i];
+   }
+   k[0] = ul * lm[2][3] - lm[0][3];
+   k[1] = vl * lm[2][3] - lm[1][3];
+   k[2] = ur * rm[2][3] - rm[0][3];
+   k[3] = vr * rm[2][3] - rm[1][3];
+}
+
+
+/*
+ * triangulation_kernel
+ * Solve the normal equations with Cramer's rule and compute the reprojection residual
+ * singularity is |det N| / (N00 N11 N22): the point must be solved with the SVD if it is below the threshold
+ */
+
+template <typename T>
+static inline void triangulation_kernel(const T lm[3][4], const T rm[3][4],
+                                        T ul, T vl, T ur, T vr,
+                                        T &x, T &y, T &z, T &residual, T &singularity) {
+   T a[4][3];
+   T k[4];
+   T n00, n01, n02, n11, n12, n22;
+   T b0, b1, b2;
+   T c00, c01, c02, c11, c12, c22;
+   T det, inverse_det;
+   T one;
+
+   triangulation_setall(one, 1.0);
+
+   stereo_equations(lm, rm, ul, vl, ur, vr, a, k);
+
+   /* normal equations N c = b */
+
+   n00 = a[0][0]*a[0][0] + a[1][0]*a[1][0] + a[2][0]*a[2][0] + a[3][0]*a[3][0];
+   n01 = a[0][0]*a[0][1] + a[1][0]*a[1][1] + a[2][0]*a[2][1] + a[3][0]*a[3][1];
+   n02 = a[0][0]*a[0][2] + a[1][0]*a[1][2] + a[2][0]*a[2][2] + a[3][0]*a[3][2];
+   n11 = a[0][1]*a[0][1] + a[1][1]*a[1][1] + a[2][1]*a[2][1] + a[3][1]*a[3][1];
+   n12 = a[0][1]*a[0][2] + a[1][1]*a[1][2] + a[2][1]*a[2][2] + a[3][1]*a[3][2];
+   n22 = a[0][2]*a[0][2] + a[1][2]*a[1][2] + a[2][2]*a[2][2] + a[3][2]*a[3][2];
+
+   b0  = a[0][0]*k[0] + a[1][0]*k[1] + a[2][0]*k[2] + a[3][0]*k[3];
+   b1  = a[0][1]*k[0] + a[1][1]*k[1] + a[2][1]*k[2] + a[3][1]*k[3];
+   b2  = a[0][2]*k[0] + a[1][2]*k[1] + a[2][2]*k[2] + a[3][2]*k[3];
+
+   /* Cramer's rule: c = adj(N) b / det N; N is symmetric so adj(N) is too */
+
+   c00 = n11*n22 - n12*n12;
+   c01 = n02*n12 - n01*n22;
+   c02 = n01*n12 - n11*n02;
+   c11 = n00*n22 - n02*n02;
+   c12 = n01*n02 - n00*n12;
+   c22 = n00*n11 - n01*n01;
+
+   det = n00*c00 + n01*c01 + n02*c02;
+
+   singularity = triangulation_abs(det) / (n00 * n11 * n22);
+   inverse_det = one / det;
+
+   x = (c00*b0 + c01*b1 + c02*b2) * inverse_det;
+   y = (c01*b0 + c11*b1 + c12*b2) * inverse_det;
+   z = (c02*b0 + c12*b1 + c22*b2) * inverse_det;
+
+   residual = reprojection_residual(lm, rm, ul, vl, ur, vr, x, y, z);
+}
+
+
+/*
+ * triangulate_point_svd
+ * Least-squares solution of X c = y with the SVD, i.e. the solution computed by inversePerspectiveTransformation()
+ * The matrices are headers on stack arrays so only the solution is allocated
+ */
+
+static void triangulate_point_svd(const double lm[3][4], const double rm[3][4],
+                                  double ul, double vl, double ur, double vr,
+                                  double &x, double &y, double &z, double &residual) {
+   double a[4][3];
+   double k[4];
+
+   stereo_equations(lm, rm, ul, vl, ur, vr, a, k);
+
+   Mat X(4, 3, CV_64FC1, a);
+   Mat Y(4, 1, CV_64FC1, k);
+   Mat c;
+
+   solve(X, Y, c, DECOMP_SVD);
+
+   x = c.at<double>(0);
+   y = c.at<double>(1);
+   z = c.at<double>(2);
+
+   residual = reprojection_residual(lm, rm, ul, vl, ur, vr, x, y, z);
+}
+
+
+/*
+ * triangulateStereoPoints
+ * Triangulate arrays of corresponding left and right image points 
+ * and return the world points and the reprojection residual (RMS pixel error) of each point.
+ * Returns the number of points that were degenerate and had to be solved with the SVD.
+ */
+
+int triangulateStereoPoints(const vector<Point2f> &left_points, const vector<Point2f> &right_points,
+                            float left_camera_model[][4], float right_camera_model[][4],
+                            vector<Point3f> &world_points, vector<float> &residuals) {
+
+   double lm[3][4], rm[3][4];
+   double x, y, z, residual, singularity;
+   int number_of_points;
+   int number_solved_with_svd = 0;
+   int i, j, n;
+
+   CV_Assert(left_points.size() == right_points.size());
+
+   number_of_points = (int) left_points.size();
+   world_points.resize(number_of_points);
+   residuals.resize(number_of_points);
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         lm[i][j] = left_camera_model[i][j];
+         rm[i][j] = right_camera_model[i][j];
+      }
+   }
+
+   n = 0;
+
+#if CV_SIMD128_64F
+
+   /* two points at a time */
+
+   v_float64x2 vlm[3][4], vrm[3][4];
+   v_float64x2 vx, vy, vz, vresidual, vsingularity;
+   double      sx[2], sy[2], sz[2], sresidual[2], ssingularity[2];
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         vlm[i][j] = v_setall_f64(lm[i][j]);
+         vrm[i][j] = v_setall_f64(rm[i][j]);
+      }
+   }
+
+   for ( ; n + 2 <= number_of_points; n += 2) {
+      triangulation_kernel(vlm, vrm,
+                           v_float64x2(left_points[n].x,  left_points[n+1].x),
+                           v_float64x2(left_points[n].y,  left_points[n+1].y),
+                           v_float64x2(right_points[n].x, right_points[n+1].x),
+                           v_float64x2(right_points[n].y, right_points[n+1].y),
+                           vx, vy, vz, vresidual, vsingularity);
+
+      v_store(sx, vx);
+      v_store(sy, vy);
+      v_store(sz, vz);
+      v_store(sresidual, vresidual);
+      v_store(ssingularity, vsingularity);
+
+      for (i=0; i<2; i++) {
+         if (!(ssingularity[i] > TRIANGULATION_SINGULARITY_THRESHOLD)) {   // also catches NaN
+            triangulate_point_svd(lm, rm, left_points[n+i].x, left_points[n+i].y, right_points[n+i].x, right_points[n+i].y,
+                                  sx[i], sy[i], sz[i], sresidual[i]);
+            number_solved_with_svd++;
+         }
+         world_points[n+i] = Point3f((float) sx[i], (float) sy[i], (float) sz[i]);
+         residuals[n+i]    = (float) sresidual[i];
+      }
+   }
+
+#endif
+
+   /* remaining points, or all points if there is no SIMD support */
+
+   for ( ; n < number_of_points; n++) {
+      triangulation_kernel<double>(lm, rm, left_points[n].x, left_points[n].y, right_points[n].x, right_points[n].y,
+                                   x, y, z, residual, singularity);
+
+      if (!(singularity > TRIANGULATION_SINGULARITY_THRESHOLD)) {
+         triangulate_point_svd(lm, rm, left_points[n].x, left_points[n].y, right_points[n].x, right_points[n].y,
+                               x, y, z, residual);
+         number_solved_with_svd++;
+      }
+      world_points[n] = Point3f((float) x, (float) y, (float) z);
+      residuals[n]    = (float) residual;
+   }
+
+   return number_solved_with_svd;
+}
+
+
+/*=======================================================*/
+/* Epipolar-constrained correspondence search            */ 
+/*=======================================================*/
+
+/*
+ * Instead of asking the user to click the corresponding point in the right image, the point is found automatically.
+ * The left camera centre C is the null vector of the left camera model P and its image in the right camera is the epipole e' = P' C.
+ * The fundamental matrix is F = [e']x P' P+, where P+ is the pseudo-inverse of P, and the epipolar line of left point x is l' = F x.
+ * The right image is searched along l' with zero-mean normalised cross-correlation (ZNCC) of a square window,
+ * the peak is refined to sub-pixel accuracy with a parabola fitted to the scores on either side, 
+ * and the correspondence is then triangulated with triangulateStereoPoints().
+ */
+
+#define ZNCC_HALF_WINDOW 7                          // window size is 2 * ZNCC_HALF_WINDOW + 1
+#define ZNCC_WINDOW      (2 * ZNCC_HALF_WINDOW + 1)
+#define ZNCC_MIN_NORM    1.0f                       // windows with less contrast than this are too uniform to match
+
+
+/*
+ * computeFundamentalMatrix
+ * Fundamental matrix of a pair of 3x4 camera models such that corresponding points satisfy x'^T F x = 0
+ * Returns false if the models do not define an epipolar geometry, e.g. if the left camera centre is at infinity
+ */
+
+bool computeFundamentalMatrix(float left_camera_model[][4], float right_camera_model[][4], Matx33d &F) {
+
+   Matx34d P, Pr;
+   Matx43d P_pseudo_inverse;
+   Matx41d C;
+   Matx31d e;
+   Matx33d e_cross;
+   Mat     w, u, vt;
+   int i, j;
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         P(i, j)  = left_camera_model[i][j];
+         Pr(i, j) = right_camera_model[i][j];
+      }
+   }
+
+   /* camera centre: right singular vector of the smallest singular value */
+
+   SVD::compute(Mat(P), w, u, vt, SVD::FULL_UV);
+   for (i=0; i<4; i++) {
+      C(i) = vt.at<double>(3, i);
+   }
+
+   if (fabs(C(3)) < 1e-12 * norm(C)) {
+      return false;                                 // camera centre at infinity
+   }
+
+   e = Pr * C;
+
+   if (norm(e) < 1e-12) {
+      return false;
+   }
+
+   e_cross = Matx33d(    0, -e(2),  e(1),
+                      e(2),     0, -e(0),
+                     -e(1),  e(0),     0);
+
+   P_pseudo_inverse = P.t() * (P * P.t()).inv();
+
+   F = e_cross * Pr * P_pseudo_inverse;
+
+   return norm(F) > 1e-12;
+}
+
+
+/*
+ * prepareStereoMatchImage
+ * Convert an image to the single-channel float representation used for the correspondence search
+ */
+
+void prepareStereoMatchImage(Mat &image, Mat &match_image) {
+
+   Mat grey;
+
+   if (image.channels() == 3)      cvtColor(image, grey, CV_BGR2GRAY);
+   else if (image.channels() == 4) cvtColor(image, grey, CV_BGRA2GRAY);
+   else                            grey = image;
+
+   grey.convertTo(match_image, CV_32F);
+}
+
+
+/*
+ * zncc_score
+ * ZNCC of the window centred at (u, v) with a zero-mean template of norm template_norm
+ * Since the template has zero mean, sum(t (r - mean r)) = sum(t r) so only sum(t r), sum(r), and sum(r^2) are needed
+ * The window is offset by its centre value, which changes neither the variance nor sum(t r), so that the sums stay
+ * small, and the variance sum(r^2) - sum(r)^2 / n is computed in double to avoid cancellation
+ */
+
+static float zncc_score(const float *template_values, float template_norm, const Mat &image, int u, int v) {
+
+   const double n = (double) (ZNCC_WINDOW * ZNCC_WINDOW);
+   const float offset = image.at<float>(v, u);
+   float  sum = 0, sum_sq = 0, cross = 0;
+   double variance;
+   int r, i;
+
+#if CV_SIMD128
+   v_float32x4 v_offset = v_setall_f32(offset);
+   v_float32x4 v_sum    = v_setzero_f32();
+   v_float32x4 v_sum_sq = v_setzero_f32();
+   v_float32x4 v_cross  = v_setzero_f32();
+#endif
+
+   for (r = 0; r < ZNCC_WINDOW; r++) {
+      const float *row = image.ptr<float>(v - ZNCC_HALF_WINDOW + r) + (u - ZNCC_HALF_WINDOW);
+      const float *t   = template_values + r * ZNCC_WINDOW;
+
+      i = 0;
+
+#if CV_SIMD128
+      for ( ; i + 4 <= ZNCC_WINDOW; i += 4) {
+         v_float32x4 x  = v_load(row + i) - v_offset;
+         v_float32x4 tt = v_load(t + i);
+         v_sum    += x;
+         v_sum_sq += x * x;
+         v_cross  += x * tt;
+      }
+#endif
+
+      for ( ; i < ZNCC_WINDOW; i++) {
+         float x = row[i] - offset;
+         sum    += x;
+         sum_sq += x * x;
+         cross  += x * t[i];
+      }
+   }
+
+#if CV_SIMD128
+   sum    += v_reduce_sum(v_sum);
+   sum_sq += v_reduce_sum(v_sum_sq);
+   cross  += v_reduce_sum(v_cross);
+#endif
+
+   variance = (double) sum_sq - (double) sum * sum / n;
+
+   if (variance < ZNCC_MIN_NORM * ZNCC_MIN_NORM) {
+      return -1;                                    // too uniform, or rounding left the variance at or below zero
+   }
+
+   return (float) (cross / (template_norm * sqrt(variance)));
+}
+
+
+/*
+ * findEpipolarCorrespondence
+ * Search the right image along the epipolar line of a left point for the best ZNCC match
+ * Returns the peak score (-1 if no match could be evaluated) and the sub-pixel right point
+ */
+
+float findEpipolarCorrespondence(const Mat &left_match_image, const Mat &right_match_image, const Matx33d &F,
+                                 Point2f left_point, Point2f *right_point) {
+
+   float  template_values[ZNCC_WINDOW * ZNCC_WINDOW];
+   float  template_norm;
+   float  mean;
+   float  score, best_score, previous_score, next_score;
+   float  offset, denominator;
+   int    best_position;
+   int    u, v, i, r, c;
+   int    first, last;
+   bool   horizontal;
+   double a, b, line_c;
+   Matx31d line;
+
+   u = cvRound(left_point.x);
+   v = cvRound(left_point.y);
+
+   if (u < ZNCC_HALF_WINDOW || v < ZNCC_HALF_WINDOW || 
+       u >= left_match_image.cols - ZNCC_HALF_WINDOW || v >= left_match_image.rows - ZNCC_HALF_WINDOW) {
+      return -1;
+   }
+
+   /* zero-mean template */
+
+   mean = 0;
+   for (r = 0; r < ZNCC_WINDOW; r++) {
+      const float *row = left_match_image.ptr<float>(v - ZNCC_HALF_WINDOW + r) + (u - ZNCC_HALF_WINDOW);
+      for (c = 0; c < ZNCC_WINDOW; c++) {
+         template_values[r * ZNCC_WINDOW + c] = row[c];
+         mean += row[c];
+      }
+   }
+   mean = mean / (ZNCC_WINDOW * ZNCC_WINDOW);
+
+   template_norm = 0;
+   for (i = 0; i < ZNCC_WINDOW * ZNCC_WINDOW; i++) {
+      template_values[i] -= mean;
+      template_norm += template_values[i] * template_values[i];
+   }
+   template_norm = sqrt(template_norm);
+
+   if (template_norm < ZNCC_MIN_NORM) {
+      return -1;
+   }
+
+   /* epipolar line a u' + b v' + c = 0 in the right image */
+
+   line   = F * Matx31d(left_point.x, left_point.y, 1.0);
+   a      = line(0);
+   b      = line(1);
+   line_c = line(2);
+
+   if (fabs(a) + fabs(b) < 1e-12) {
+      return -1;                                    // the left point is the epipole
+   }
+
+   /* step one pixel along whichever image axis the line is closer to */
+
+   horizontal = fabs(b) >= fabs(a);
+
+   if (horizontal) {
+      first = ZNCC_HALF_WINDOW;
+      last  = right_match_image.cols - ZNCC_HALF_WINDOW - 1;
+   }
+   else {
+      first = ZNCC_HALF_WINDOW;
+      last  = right_match_image.rows - ZNCC_HALF_WINDOW - 1;
+   }
+
+   vector<float> scores(last - first + 1, -1.0f);
+
+   best_score    = -1;
+   best_position = -1;
+
+   for (i = first; i <= last; i++) {
+      if (horizontal) {
+         u = i;
+         v = cvRound(-(a * i + line_c) / b);
+         if (v < ZNCC_HALF_WINDOW || v >= right_match_image.rows - ZNCC_HALF_WINDOW) continue;
+      }
+      else {
+         v = i;
+         u = cvRound(-(b * i + line_c) / a);
+         if (u < ZNCC_HALF_WINDOW || u >= right_match_image.cols - ZNCC_HALF_WINDOW) continue;
+      }
+
+      score = zncc_score(template_values, template_norm, right_match_image, u, v);
+      scores[i - first] = score;
+
+      if (score > best_score) {
+         best_score    = score;
+         best_position = i;
+      }
+   }
+
+   if (best_position < 0) {
+      return -1;
+   }
+
+   /* sub-pixel refinement: vertex of the parabola through the peak and its neighbours */
+
+   offset = 0;
+   if (best_position > first && best_position < last) {
+      previous_score = scores[best_position - first - 1];
+      next_score     = scores[best_position - first + 1];
+      denominator    = previous_score - 2 * best_score + next_score;
+      if (previous_score > -1 && next_score > -1 && denominator < 0) {
+         offset = 0.5f * (previous_score - next_score) / denominator;
+      }
+   }
+
+   if (horizontal) {
+      right_point->x = best_position + offset;
+      right_point->y = (float) (-(a * right_point->x + line_c) / b);
+   }
+   else {
+      right_point->y = best_position + offset;
+      right_point->x = (float) (-(b * right_point->y + line_c) / a);
+   }
+
+   return best_score;
+}
+
+
+/*
+ * Parallel body for findStereoCorrespondences: each left feature is searched independently
+ */
+
+class EpipolarSearchBody : public ParallelLoopBody {
+public:
+   EpipolarSearchBody(const Mat &left_match_image, const Mat &right_match_image, const Matx33d &F,
+                      const vector<Point2f> &left_points, vector<Point2f> &right_points, vector<float> &scores) :
+      left_match_image_(left_match_image), right_match_image_(right_match_image), F_(F),
+      left_points_(left_points), right_points_(right_points), scores_(scores) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int i;
+
+      for (i = range.start; i < range.end; i++) {
+         scores_[i] = findEpipolarCorrespondence(left_match_image_, right_match_image_, F_, left_points_[i], &right_points_[i]);
+      }
+   }
+
+private:
+   const Mat             &left_match_image_;
+   const Mat             &right_match_image_;
+   const Matx33d         &F_;
+   const vector<Point2f> &left_points_;
+   vector<Point2f>       &right_points_;
+   vector<float>         &scores_;
+};
+
+
+/*
+ * findStereoCorrespondences
+ * Find the right-image correspondence of every left point, in parallel
+ * The images must have been prepared with prepareStereoMatchImage()
+ * Returns the number of correspondences with a score of at least ZNCC_MIN_SCORE; 
+ * the score of each point is returned so the caller can discard the others
+ */
+
+int findStereoCorrespondences(const Mat &left_match_image, const Mat &right_match_image, const Matx33d &F,
+                              const vector<Point2f> &left_points, vector<Point2f> &right_points, vector<float> &scores) {
+
+   int i;
+   int number_matched = 0;
+
+   right_points.assign(left_points.size(), Point2f(-1, -1));
+   scores.assign(left_points.size(), -1.0f);
+
+   parallel_for_(Range(0, (int) left_points.size()),
+                 EpipolarSearchBody(left_match_image, right_match_image, F, left_points, right_points, scores));
+
+   for (i = 0; i < (int) scores.size(); i++) {
+      if (scores[i] >= ZNCC_MIN_SCORE) number_matched++;
+   }
+
+   return number_matched;
+}
+
+
+/*
+ * matchAndTriangulate
+ * Find the correspondences of the left points and triangulate those with a score of at least ZNCC_MIN_SCORE
+ * Returns the number of world points
+ */
+
+int matchAndTriangulate(const Mat &left_match_image, const Mat &right_match_image, const Matx33d &F,
+                        float left_camera_model[][4], float right_camera_model[][4],
+                        const vector<Point2f> &left_points, 
+                        vector<Point2f> &matched_left_points, vector<Point2f> &matched_right_points,
+                        vector<Point3f> &world_points, vector<float> &residuals) {
+
+   vector<Point2f> right_points;
+   vector<float>   scores;
+   int i;
+
+   findStereoCorrespondences(left_match_image, right_match_image, F, left_points, right_points, scores);
+
+   matched_left_points.clear();
+   matched_right_points.clear();
+
+   for (i = 0; i < (int) left_points.size(); i++) {
+      if (scores[i] >= ZNCC_MIN_SCORE) {
+         matched_left_points.push_back(left_points[i]);
+         matched_right_points.push_back(right_points[i]);
+      }
+   }
+
+   triangulateStereoPoints(matched_left_points, matched_right_points, left_camera_model, right_camera_model, world_points, residuals);
+
+   return (int) world_points.size();
+}
+
+
+/*=======================================================*/
+/* Dense stereo reconstruction                           */ 
+/*=======================================================*/
+
+/*
+ * Dense reconstruction computes a world point for every pixel of the left image that has a reliable correspondence:
+ *
+ * 1. Rectification: the camera models are replaced by two models with the same intrinsic parameters and orientation,
+ *    whose x axis is parallel to the baseline, so that corresponding points lie on the same image row
+ *    (A. Fusiello, E. Trucco, and A. Verri, "A compact algorithm for rectification of stereo pairs", 2000).
+ *    The images are warped with the homographies that map the original image planes to the rectified ones.
+ *
+ * 2. Matching cost: the 5x5 census transform of both images and the Hamming distance for each disparity.
+ *
+ * 3. Semi-global matching (H. Hirschmuller, "Stereo processing by semiglobal matching and mutual information", 2008):
+ *    the cost is aggregated along SGM_NUMBER_OF_DIRECTIONS scanline directions, one direction per thread,
+ *    with the path recurrence vectorised over disparities.
+ *
+ * 4. Disparity selection: winner-take-all with a uniqueness check and sub-pixel parabola refinement.
+ *
+ * 5. Triangulation: the rectified correspondences (u, v) and (u - d, v) are triangulated row by row with 
+ *    triangulateStereoPoints() and streamed to a binary PLY file.
+ */
+
+#define SGM_PIXEL_STRIDE (SGM_MAX_DISPARITY + 2)   // per-pixel path costs are padded at both ends so that d-1 and d+1 can be read
+#define SGM_INFINITE_COST 0xFFFF                   // padding value; saturating additions keep it at this value
+#define CENSUS_MAX_COST   24                       // number of bits in a 5x5 census signature
+
+
+/*
+ * computeRectification
+ * Compute the rectifying homographies of the left and right images and the rectified camera models
+ * Returns false if the camera models cannot be rectified, e.g. if the camera centres coincide or are at infinity
+ */
+
+bool computeRectification(float left_camera_model[][4], float right_camera_model[][4], Size image_size,
+                          Matx33d &left_homography, Matx33d &right_homography,
+                          float rectified_left_model[][4], float rectified_right_model[][4]) {
+
+   Matx34d Pl, Pr, Pnl, Pnr;
+   Matx33d Ql, Qr, K, R, shift;
+   Mat     Kl, Rl, tl, Kr, Rr, tr;
+   Vec3d   cl, cr, v1, v2, v3, z_axis;
+   Matx31d centre_l, centre_r;
+   double  dx, dy, scale;
+   int i, j;
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         Pl(i, j) = left_camera_model[i][j];
+         Pr(i, j) = right_camera_model[i][j];
+      }
+      for (j=0; j<3; j++) {
+         Ql(i, j) = Pl(i, j);
+         Qr(i, j) = Pr(i, j);
+      }
+   }
+
+   if (fabs(determinant(Ql)) < 1e-12 || fabs(determinant(Qr)) < 1e-12) {
+      return false;                                 // camera centre at infinity
+   }
+
+   /* camera centres c = -Q^-1 q */
+
+   Matx31d c;
+   c  = -(Ql.inv() * Matx31d(Pl(0, 3), Pl(1, 3), Pl(2, 3)));
+   cl = Vec3d(c(0), c(1), c(2));
+   c  = -(Qr.inv() * Matx31d(Pr(0, 3), Pr(1, 3), Pr(2, 3)));
+   cr = Vec3d(c(0), c(1), c(2));
+
+   if (norm(cr - cl) < 1e-9) {
+      return false;                                 // no baseline
+   }
+
+   /* intrinsic parameters and optical axis from the decomposition of the models */
+
+   decomposeProjectionMatrix(Mat(Pl), Kl, Rl, tl);
+   decomposeProjectionMatrix(Mat(Pr), Kr, Rr, tr);
+
+   Mat K_mean = (Kl / Kl.at<double>(2, 2) + Kr / Kr.at<double>(2, 2)) * 0.5;
+   K = K_mean;
+   K(0, 1) = 0;                                     // no skew
+
+   z_axis = Vec3d(Rl.at<double>(2, 0), Rl.at<double>(2, 1), Rl.at<double>(2, 2));
+
+   /* new orientation: x axis along the baseline, y axis orthogonal to it and to the old left optical axis */
+
+   v1 = cr - cl;
+   v2 = z_axis.cross(v1);
+   v3 = v1.cross(v2);
+
+   if (norm(v2) < 1e-9) {
+      return false;                                 // baseline along the optical axis
+   }
+
+   v1 = v1 / norm(v1);
+   v2 = v2 / norm(v2);
+   v3 = v3 / norm(v3);
+
+   R = Matx33d(v1[0], v1[1], v1[2],
+               v2[0], v2[1], v2[2],
+               v3[0], v3[1], v3[2]);
+
+   /* rectified models Pn = K [R | -R c] and homographies T = Qn Q^-1 */
+
+   Matx31d tnl = -(R * Matx31d(cl[0], cl[1], cl[2]));
+   Matx31d tnr = -(R * Matx31d(cr[0], cr[1], cr[2]));
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<3; j++) {
+         Pnl(i, j) = R(i, j);
+         Pnr(i, j) = R(i, j);
+      }
+      Pnl(i, 3) = tnl(i);
+      Pnr(i, 3) = tnr(i);
+   }
+   Pnl = K * Pnl;
+   Pnr = K * Pnr;
+
+   left_homography  = Matx33d(Pnl(0,0), Pnl(0,1), Pnl(0,2), Pnl(1,0), Pnl(1,1), Pnl(1,2), Pnl(2,0), Pnl(2,1), Pnl(2,2)) * Ql.inv();
+   right_homography = Matx33d(Pnr(0,0), Pnr(0,1), Pnr(0,2), Pnr(1,0), Pnr(1,1), Pnr(1,2), Pnr(2,0), Pnr(2,1), Pnr(2,2)) * Qr.inv();
+
+   /* shift both images by the same amount so that the centre of the left image stays in the centre; */
+   /* using the same shift for both keeps the rows aligned and the disparities non-negative           */
+
+   centre_l = left_homography  * Matx31d(image_size.width / 2.0, image_size.height / 2.0, 1.0);
+   centre_r = right_homography * Matx31d(image_size.width / 2.0, image_size.height / 2.0, 1.0);
+
+   dx = image_size.width / 2.0  - centre_l(0) / centre_l(2);
+   dy = image_size.height / 2.0 - (centre_l(1) / centre_l(2) + centre_r(1) / centre_r(2)) / 2.0;
+
+   shift = Matx33d(1, 0, dx,
+                   0, 1, dy,
+                   0, 0, 1);
+
+   left_homography  = shift * left_homography;
+   right_homography = shift * right_homography;
+   Pnl = shift * Pnl;
+   Pnr = shift * Pnr;
+
+   /* the models are scaled so that the third row has a unit normal; both have the same scale since they share K and R */
+
+   scale = 1.0 / sqrt(Pnl(2, 0) * Pnl(2, 0) + Pnl(2, 1) * Pnl(2, 1) + Pnl(2, 2) * Pnl(2, 2));
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         rectified_left_model[i][j]  = (float) (Pnl(i, j) * scale);
+         rectified_right_model[i][j] = (float) (Pnr(i, j) * scale);
+      }
+   }
+
+   return true;
+}
+
+
+/*
+ * Parallel body for censusTransform: each row is independent
+ */
+
+class CensusBody : public ParallelLoopBody {
+public:
+   CensusBody(const Mat &grey, Mat &census) : grey_(grey), census_(census) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int x, y, i, j;
+      unsigned int signature;
+      uchar centre;
+
+      for (y = range.start; y < range.end; y++) {
+         unsigned int *census_row = census_.ptr<unsigned int>(y);
+
+         for (x = 0; x < grey_.cols; x++) {
+            if (y < 2 || y >= grey_.rows - 2 || x < 2 || x >= grey_.cols - 2) {
+               census_row[x] = 0;
+               continue;
+            }
+            centre    = grey_.at<uchar>(y, x);
+            signature = 0;
+            for (i = -2; i <= 2; i++) {
+               const uchar *grey_row = grey_.ptr<uchar>(y + i);
+               for (j = -2; j <= 2; j++) {
+                  if (i != 0 || j != 0) {
+                     signature = (signature << 1) | (grey_row[x + j] < centre ? 1 : 0);
+                  }
+               }
+            }
+            census_row[x] = signature;
+         }
+      }
+   }
+
+private:
+   const Mat &grey_;
+   Mat       &census_;
+};
+
+
+/*
+ * censusTransform
+ * 5x5 census transform of an 8-bit greyscale image; each pixel of the CV_32S result is a 24-bit signature
+ */
+
+void censusTransform(const Mat &grey, Mat &census) {
+   census.create(grey.size(), CV_32SC1);
+   parallel_for_(Range(0, grey.rows), CensusBody(grey, census));
+}
+
+
+static inline int census_hamming_distance(unsigned int a, unsigned int b) {
+   unsigned int x = a ^ b;
+
+   x = x - ((x >> 1) & 0x55555555);
+   x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+   return (int) ((((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+}
+
+
+/*
+ * Parallel body for the cost volume: cost(x, y, d) is the Hamming distance between the census signatures
+ * of left pixel (x, y) and right pixel (x - d, y)
+ */
+
+class CostVolumeBody : public ParallelLoopBody {
+public:
+   CostVolumeBody(const Mat &left_census, const Mat &right_census, uchar *cost) : 
+      left_census_(left_census), right_census_(right_census), cost_(cost) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int x, y, d;
+
+      for (y = range.start; y < range.end; y++) {
+         const unsigned int *left_row  = left_census_.ptr<unsigned int>(y);
+         const unsigned int *right_row = right_census_.ptr<unsigned int>(y);
+         uchar *cost_row = cost_ + (size_t) y * left_census_.cols * SGM_MAX_DISPARITY;
+
+         for (x = 0; x < left_census_.cols; x++) {
+            uchar *c = cost_row + (size_t) x * SGM_MAX_DISPARITY;
+            for (d = 0; d < SGM_MAX_DISPARITY; d++) {
+               c[d] = (uchar) (x - d >= 0 ? census_hamming_distance(left_row[x], right_row[x - d]) : CENSUS_MAX_COST);
+            }
+         }
+      }
+   }
+
+private:
+   const Mat &left_census_;
+   const Mat &right_census_;
+   uchar     *cost_;
+};
+
+
+/*
+ * sgm_path_step
+ * One step of the path recurrence for all disparities of a pixel
+ *
+ *    L(p, d) = C(p, d) + min(L(p-r, d), L(p-r, d-1) + P1, L(p-r, d+1) + P1, min_k L(p-r, k) + P2) - min_k L(p-r, k)
+ *
+ * previous and current point to padded per-pixel arrays (index 0 and SGM_MAX_DISPARITY+1 hold SGM_INFINITE_COST);
+ * previous is NULL at the start of a path, when L(p, d) = C(p, d). Returns min_d L(p, d).
+ */
+
+static inline ushort sgm_path_step(const uchar *cost, const ushort *previous, ushort previous_min, ushort *current) {
+
+   int d;
+   ushort current_min = SGM_INFINITE_COST;
+
+   if (previous == NULL) {
+      for (d = 0; d < SGM_MAX_DISPARITY; d++) {
+         current[d + 1] = cost[d];
+         if (cost[d] < current_min) current_min = cost[d];
+      }
+      return current_min;
+   }
+
+   d = 0;
+
+#if CV_SIMD128
+   v_uint16x8 v_p1        = v_setall_u16((ushort) SGM_P1);
+   v_uint16x8 v_jump      = v_setall_u16((ushort) min(previous_min + SGM_P2, SGM_INFINITE_COST));
+   v_uint16x8 v_prev_min  = v_setall_u16(previous_min);
+   v_uint16x8 v_min_cost  = v_setall_u16((ushort) SGM_INFINITE_COST);
+
+   for ( ; d + 8 <= SGM_MAX_DISPARITY; d += 8) {
+      v_uint16x8 same  = v_load(previous + d + 1);
+      v_uint16x8 lower = v_load(previous + d)     + v_p1;     // saturating addition
+      v_uint16x8 upper = v_load(previous + d + 2) + v_p1;
+      v_uint16x8 l     = v_load_expand(cost + d) + (v_min(v_min(same, lower), v_min(upper, v_jump)) - v_prev_min);
+
+      v_store(current + d + 1, l);
+      v_min_cost = v_min(v_min_cost, l);
+   }
+   current_min = v_reduce_min(v_min_cost);
+#endif
+
+   for ( ; d < SGM_MAX_DISPARITY; d++) {
+      int m = min(min((int) previous[d + 1], (int) previous[d] + SGM_P1), min((int) previous[d + 2] + SGM_P1, previous_min + SGM_P2));
+      int l = cost[d] + m - previous_min;
+      current[d + 1] = (ushort) min(l, SGM_INFINITE_COST);
+      if (current[d + 1] < current_min) current_min = current[d + 1];
+   }
+
+   return current_min;
+}
+
+
+/*
+ * Parallel body for the cost aggregation: each task aggregates the cost along one scanline direction (dx, dy)
+ * and adds the path costs of each completed row into the aggregated cost volume under a per-row lock
+ */
+
+static const int sgm_directions[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1} };
+
+class AggregationBody : public ParallelLoopBody {
+public:
+   AggregationBody(const uchar *cost, ushort *aggregated, int width, int height, Mutex *row_locks) :
+      cost_(cost), aggregated_(aggregated), width_(width), height_(height), row_locks_(row_locks) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int direction;
+
+      for (direction = range.start; direction < range.end; direction++) {
+         aggregate(sgm_directions[direction][0], sgm_directions[direction][1]);
+      }
+   }
+
+private:
+   void aggregate(int dx, int dy) const {
+      vector<ushort> previous_row((size_t) width_ * SGM_PIXEL_STRIDE, (ushort) SGM_INFINITE_COST);
+      vector<ushort> current_row((size_t) width_ * SGM_PIXEL_STRIDE, (ushort) SGM_INFINITE_COST);
+      vector<ushort> previous_min(width_, 0);
+      vector<ushort> current_min(width_, 0);
+      int row, column, x, y, px, d;
+      const ushort *predecessor;
+      ushort predecessor_min;
+
+      for (row = 0; row < height_; row++) {
+         y = (dy >= 0) ? row : height_ - 1 - row;
+
+         for (column = 0; column < width_; column++) {
+            x  = (dx >= 0) ? column : width_ - 1 - column;
+            px = x - dx;
+
+            /* the predecessor is in the current row for horizontal paths and in the previous row otherwise */
+
+            predecessor     = NULL;
+            predecessor_min = 0;
+            if (px >= 0 && px < width_) {
+               if (dy == 0) {
+                  predecessor     = &current_row[(size_t) px * SGM_PIXEL_STRIDE];
+                  predecessor_min = current_min[px];
+               }
+               else if (row > 0) {
+                  predecessor     = &previous_row[(size_t) px * SGM_PIXEL_STRIDE];
+                  predecessor_min = previous_min[px];
+               }
+            }
+
+            current_min[x] = sgm_path_step(cost_ + ((size_t) y * width_ + x) * SGM_MAX_DISPARITY,
+                                           predecessor, predecessor_min,
+                                           &current_row[(size_t) x * SGM_PIXEL_STRIDE]);
+         }
+
+         /* accumulate the path costs of this row */
+
+         {
+            AutoLock lock(row_locks_[y]);
+            ushort *s = aggregated_ + (size_t) y * width_ * SGM_MAX_DISPARITY;
+
+            for (x = 0; x < width_; x++) {
+               const ushort *l = &current_row[(size_t) x * SGM_PIXEL_STRIDE + 1];
+               d = 0;
+#if CV_SIMD128
+               for ( ; d + 8 <= SGM_MAX_DISPARITY; d += 8) {
+                  v_store(s + d, v_load(s + d) + v_load(l + d));
+               }
+#endif
+               for ( ; d < SGM_MAX_DISPARITY; d++) {
+                  s[d] = (ushort) min((int) s[d] + l[d], SGM_INFINITE_COST);
+               }
+               s += SGM_MAX_DISPARITY;
+            }
+         }
+
+         current_row.swap(previous_row);
+         current_min.swap(previous_min);
+      }
+   }
+
+   const uchar *cost_;
+   ushort      *aggregated_;
+   int          width_;
+   int          height_;
+   Mutex       *row_locks_;
+};
+
+
+/*
+ * Parallel body for the disparity selection: winner-take-all with uniqueness check and sub-pixel refinement
+ */
+
+class DisparitySelectionBody : public ParallelLoopBody {
+public:
+   DisparitySelectionBody(const ushort *aggregated, Mat &disparity) : aggregated_(aggregated), disparity_(disparity) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int x, y, d, best_d;
+      int best_cost, denominator;
+      bool unique;
+
+      for (y = range.start; y < range.end; y++) {
+         float *disparity_row = disparity_.ptr<float>(y);
+
+         for (x = 0; x < disparity_.cols; x++) {
+            const ushort *s = aggregated_ + ((size_t) y * disparity_.cols + x) * SGM_MAX_DISPARITY;
+
+            best_d    = 0;
+            best_cost = s[0];
+            for (d = 1; d < SGM_MAX_DISPARITY && d <= x; d++) {
+               if (s[d] < best_cost) {
+                  best_cost = s[d];
+                  best_d    = d;
+               }
+            }
+
+            unique = true;
+            for (d = 0; d < SGM_MAX_DISPARITY && d <= x && unique; d++) {
+               if (abs(d - best_d) > 1 && s[d] * (100 - SGM_UNIQUENESS_RATIO) < best_cost * 100) {
+                  unique = false;
+               }
+            }
+
+            if (!unique) {
+               disparity_row[x] = -1;
+            }
+            else if (best_d > 0 && best_d < SGM_MAX_DISPARITY - 1 && best_d < x) {
+               denominator = s[best_d - 1] + s[best_d + 1] - 2 * best_cost;
+               disparity_row[x] = best_d + (denominator > 0 ? (float) (s[best_d - 1] - s[best_d + 1]) / (2 * denominator) : 0);
+            }
+            else {
+               disparity_row[x] = (float) best_d;
+            }
+         }
+      }
+   }
+
+private:
+   const ushort *aggregated_;
+   Mat          &disparity_;
+};
+
+
+static double elapsed_milliseconds(int64 start_ticks) {
+   return (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+}
+
+
+/*
+ * semiGlobalMatching
+ * Disparity map (CV_32F, -1 where there is no reliable match) of a pair of rectified 8-bit greyscale images
+ * The time for each stage is added to timing if it is not NULL
+ */
+
+void semiGlobalMatching(const Mat &left_rectified, const Mat &right_rectified, Mat &disparity, denseStereoTimingType *timing) {
+
+   Mat    left_census, right_census;
+   int64  start_ticks;
+   int    width  = left_rectified.cols;
+   int    height = left_rectified.rows;
+   size_t volume = (size_t) width * height * SGM_MAX_DISPARITY;
+
+   start_ticks = getTickCount();
+   censusTransform(left_rectified,  left_census);
+   censusTransform(right_rectified, right_census);
+   if (timing != NULL) timing->census += elapsed_milliseconds(start_ticks);
+
+   start_ticks = getTickCount();
+   vector<uchar> cost(volume);
+   parallel_for_(Range(0, height), CostVolumeBody(left_census, right_census, &cost[0]));
+   if (timing != NULL) timing->cost += elapsed_milliseconds(start_ticks);
+
+   start_ticks = getTickCount();
+   vector<ushort> aggregated(volume, 0);
+   vector<Mutex>  row_locks(height);
+   parallel_for_(Range(0, SGM_NUMBER_OF_DIRECTIONS), AggregationBody(&cost[0], &aggregated[0], width, height, &row_locks[0]), 
+                 SGM_NUMBER_OF_DIRECTIONS);
+   if (timing != NULL) timing->aggregation += elapsed_milliseconds(start_ticks);
+
+   start_ticks = getTickCount();
+   disparity.create(height, width, CV_32FC1);
+   parallel_for_(Range(0, height), DisparitySelectionBody(&aggregated[0], disparity));
+   if (timing != NULL) timing->disparity += elapsed_milliseconds(start_ticks);
+}
+
+
+/*
+ * writeDisparityPointCloud
+ * Triangulate every valid disparity row by row and stream the coloured points to a binary PLY file
+ * Returns the number of points written, or -1 if the file cannot be written
+ */
+
+#define PLY_HEADER_FORMAT "ply\nformat binary_little_endian 1.0\nelement vertex %010d\n" \
+                          "property float x\nproperty float y\nproperty float z\n"       \
+                          "property uchar red\nproperty uchar green\nproperty uchar blue\nend_header\n"
+
+int writeDisparityPointCloud(char *filename, const Mat &disparity, const Mat &left_colour,
+                             float rectified_left_model[][4], float rectified_right_model[][4]) {
+
+   FILE *fp_ply;
+   vector<Point2f> left_points, right_points;
+   vector<Point3f> world_points;
+   vector<float>   residuals;
+   vector<uchar>   record_buffer;
+   int    number_of_points = 0;
+   int    x, y, i;
+   float  d;
+   uchar  *record;
+   Vec3b  colour;
+
+   if ((fp_ply = fopen(filename, "wb")) == 0) {
+      printf("Error can't open point cloud file %s for output\n", filename);
+      return -1;
+   }
+
+   fprintf(fp_ply, PLY_HEADER_FORMAT, 0);          // rewritten with the number of points at the end
+
+   record_buffer.resize((size_t) disparity.cols * 15);
+
+   for (y = 0; y < disparity.rows; y++) {
+      const float *disparity_row = disparity.ptr<float>(y);
+
+      left_points.clear();
+      right_points.clear();
+
+      for (x = 0; x < disparity.cols; x++) {
+         d = disparity_row[x];
+         if (d > 0) {
+            left_points.push_back(Point2f((float) x, (float) y));
+            right_points.push_back(Point2f(x - d, (float) y));
+         }
+      }
+
+      if (left_points.empty()) continue;
+
+      triangulateStereoPoints(left_points, right_points, rectified_left_model, rectified_right_model, world_points, residuals);
+
+      /* 15-byte records: float x, y, z and uchar red, green, blue */
+
+      record = &record_buffer[0];
+      for (i = 0; i < (int) world_points.size(); i++) {
+         colour = left_colour.at<Vec3b>(y, (int) left_points[i].x);
+         memcpy(record,     &world_points[i].x, sizeof(float));
+         memcpy(record + 4, &world_points[i].y, sizeof(float));
+         memcpy(record + 8, &world_points[i].z, sizeof(float));
+         record[12] = colour[2];
+         record[13] = colour[1];
+         record[14] = colour[0];
+         record += 15;
+      }
+      fwrite(&record_buffer[0], 15, world_points.size(), fp_ply);
+
+      number_of_points += (int) world_points.size();
+   }
+
+   fseek(fp_ply, 0, SEEK_SET);
+   fprintf(fp_ply, PLY_HEADER_FORMAT, number_of_points);
+   fclose(fp_ply);
+
+   return number_of_points;
+}
+
+
+/*
+ * denseStereoReconstruction
+ * Rectify the images, compute the disparity map, and write the point cloud to a binary PLY file
+ * The time for each stage is added to timing if it is not NULL, so that it can be accumulated over several runs
+ * Returns false if the camera models cannot be rectified or the point cloud cannot be written
+ */
+
+bool denseStereoReconstruction(Mat &left_image, Mat &right_image, float left_camera_model[][4], float right_camera_model[][4],
+                               char *ply_filename, Mat &disparity, denseStereoTimingType *timing) {
+
+   Matx33d left_homography, right_homography;
+   float   rectified_left_model[3][4], rectified_right_model[3][4];
+   Mat     left_grey, right_grey, left_colour;
+   Mat     left_rectified, right_rectified, left_colour_rectified;
+   int64   start_ticks;
+   int     number_of_points;
+   bool    debug = true;
+
+   start_ticks = getTickCount();
+
+   if (!computeRectification(left_camera_model, right_camera_model, left_image.size(),
+                             left_homography, right_homography, rectified_left_model, rectified_right_model)) {
+      printf("The camera models cannot be rectified (coincident camera centres or centre at infinity)\n");
+      return false;
+   }
+
+   if (left_image.channels() == 1) cvtColor(left_image, left_colour, CV_GRAY2BGR);
+   else if (left_image.channels() == 4) cvtColor(left_image, left_colour, CV_BGRA2BGR);
+   else left_colour = left_image;
+
+   cvtColor(left_colour, left_grey, CV_BGR2GRAY);
+   if (right_image.channels() == 1) right_grey = right_image;
+   else if (right_image.channels() == 4) cvtColor(right_image, right_grey, CV_BGRA2GRAY);
+   else cvtColor(right_image, right_grey, CV_BGR2GRAY);
+
+   warpPerspective(left_grey,   left_rectified,        Mat(left_homography),  left_image.size());
+   warpPerspective(right_grey,  right_rectified,       Mat(right_homography), left_image.size());
+   warpPerspective(left_colour, left_colour_rectified, Mat(left_homography),  left_image.size());
+
+   if (timing != NULL) timing->rectification += elapsed_milliseconds(start_ticks);
+
+   semiGlobalMatching(left_rectified, right_rectified, disparity, timing);
+
+   start_ticks = getTickCount();
+   number_of_points = writeDisparityPointCloud(ply_filename, disparity, left_colour_rectified, rectified_left_model, rectified_right_model);
+   if (timing != NULL) timing->triangulation += elapsed_milliseconds(start_ticks);
+
+   if (number_of_points < 0) {
+      return false;
+   }
+
+   if (debug) printf("Wrote %d points to %s\n", number_of_points, ply_filename);
+   return true;
+}
+
+
+/*
+ * printDenseStereoTiming
+ * Print the time taken by each stage of the dense reconstruction, divided by the number of runs
+ */
+
+void printDenseStereoTiming(denseStereoTimingType *timing, int number_of_runs) {
+   printf("Rectification  %8.2f ms\n", timing->rectification / number_of_runs);
+   printf("Census         %8.2f ms\n", timing->census        / number_of_runs);
+   printf("Matching cost  %8.2f ms\n", timing->cost          / number_of_runs);
+   printf("Aggregation    %8.2f ms\n", timing->aggregation   / number_of_runs);
+   printf("Disparity      %8.2f ms\n", timing->disparity     / number_of_runs);
+   printf("Triangulation  %8.2f ms\n", timing->triangulation / number_of_runs);
+}
+
+
 /*=======================================================*/
 /* Utility functions                                     */ 
 /*=======================================================*/
@@ -17,12 +17,21 @@
   After computing the inverse perspective transformation, the user can then interactively select a point in the image.
   The application then uses the inverse perspective transformation to compute the world x and y coordinates of the selected point.
   It assumes the z coordinate is zero.
+
+  The inverse perspective transformation for every pixel at this z value is computed once and stored in a ground-plane map
+  (a binary file with the same name as the camera model file and the extension .gpm) so that subsequent runs load it rather 
+  than rebuild it. The map is rebuilt automatically if the camera model or image size changes.
  
  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
   The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
 
   David Vernon
   14 June 2018
+
+  Audit Trail
+  --------------------
+  Use the precomputed ground-plane map to compute the world coordinates of the selected point
+  16 October 2026
 */
 
  
@@ -58,11 +67,16 @@ int main() {
    bool debug = false;
    char camera_model_filename[MAX_FILENAME_LENGTH];
    char image_filename[MAX_FILENAME_LENGTH];
+   char ground_plane_map_filename[MAX_FILENAME_LENGTH];
+   char *extension;
 
    int i, j;
    float z;
 
    Mat imageCopy;
+   Mat ground_plane_map;
+   Point2f world_xy;
+   bool use_map;
 
    Point3f world_sample_point;
    Point2f text_coordinates; 
@@ -139,6 +153,14 @@ int main() {
 
    z = 0; // set the depth value for the inverse perspective transformation
 
+   /* get the ground-plane map for this camera model, z value, and image size */
+   strcpy(ground_plane_map_filename, camera_model_filename);
+   extension = strrchr(ground_plane_map_filename, '.');
+   if (extension != NULL) *extension = '\0';
+   strcat(ground_plane_map_filename, ".gpm");
+
+   use_map = getGroundPlaneMap(ground_plane_map_filename, camera_model, z, image.size(), ground_plane_map);
+
    /* Create a window for image and display it */
    namedWindow(window_name, CV_WINDOW_AUTOSIZE );
    setMouseCallback(window_name, getSamplePoint);    // use this callback to get the coordinates of the sample point
@@ -150,7 +172,17 @@ int main() {
       waitKey(30);   
       if (number_of_sample_points == 1) {
                                                          
-         inversePerspectiveTransformation(image_sample_point, camera_model, z, &world_sample_point);
+         if (use_map) {
+            world_xy = mapPointToGroundPlane(image_sample_point, ground_plane_map);
+            world_sample_point.x = world_xy.x;
+            world_sample_point.y = world_xy.y;
+            world_sample_point.z = z;
+            if (debug) printf("(%3d, %3d) -> (%4.1f, %4.1f, %4.1f)\n", (int) image_sample_point.x, (int) image_sample_point.y,
+                              world_sample_point.x, world_sample_point.y, world_sample_point.z);
+         }
+         else {
+            inversePerspectiveTransformation(image_sample_point, camera_model, z, &world_sample_point);
+         }
 
          text_coordinates.x = image_sample_point.x-7; // offset the graphic text message so that the + character is centred on the image sample point
          text_coordinates.y = image_sample_point.y+4;
@@ -7,6 +7,12 @@
 
   David Vernon
   14 June 2018
+
+  Audit Trail
+  --------------------
+  Added ground-plane mapping: per-pixel lookup map, batch inverse perspective transformation,
+  and mapping of points, contours, and masks to world coordinates
+  16 October 2026
 */
  
 #include "module5/cameraInvPerspectiveMonocular.h"
@@ -94,6 +100,373 @@ void inversePerspectiveTransformation(Point2f image_sample_point,
    }
 }
 
+/*=======================================================*/
+/* Ground-plane mapping                                  */ 
+/*=======================================================*/
+
+/*
+ * For a fixed camera model and a fixed z, the camera model reduces to a 3x3 homography H between the plane z and the image:
+ *
+ *    s (u, v, 1)^T = H (x, y, 1)^T   where  H = [ p00  p01  p02 z + p03 ]
+ *                                               [ p10  p11  p12 z + p13 ]
+ *                                               [ p20  p21  p22 z + p23 ]
+ *
+ * so the inverse perspective transformation of any image point is (x', y', w')^T = H^-1 (u, v, 1)^T, x = x'/w', y = y'/w'.
+ * This is the same solution as inversePerspectiveTransformation() but H^-1 is computed once rather than once per point.
+ * 
+ * The ground-plane map is a CV_32FC2 image of the same size as the camera image in which pixel (u, v) holds 
+ * the world (x, y) coordinates of that pixel on the plane z, so that mapping a set of pixels is a gather from the map.
+ */
+
+
+/*
+ * computeGroundPlaneHomography
+ * Compute the inverse homography H^-1 from image coordinates to world (x, y) coordinates on the plane z
+ * Returns false if the camera model is degenerate for this plane
+ */
+
+bool computeGroundPlaneHomography(float camera_model[][4], float z, double inverse_homography[][3]) {
+
+   double h[3][3];
+   double det;
+   int i, j;
+
+   for (i=0; i<3; i++) {
+      h[i][0] = camera_model[i][0];
+      h[i][1] = camera_model[i][1];
+      h[i][2] = camera_model[i][2] * z + camera_model[i][3];
+   }
+
+   det = h[0][0] * (h[1][1] * h[2][2] - h[1][2] * h[2][1])
+       - h[0][1] * (h[1][0] * h[2][2] - h[1][2] * h[2][0])
+       + h[0][2] * (h[1][0] * h[2][1] - h[1][1] * h[2][0]);
+
+   if (fabs(det) < 1e-12) {
+      return false;
+   }
+
+   /* inverse = adjugate / determinant */
+
+   inverse_homography[0][0] =  (h[1][1] * h[2][2] - h[1][2] * h[2][1]) / det;
+   inverse_homography[0][1] = -(h[0][1] * h[2][2] - h[0][2] * h[2][1]) / det;
+   inverse_homography[0][2] =  (h[0][1] * h[1][2] - h[0][2] * h[1][1]) / det;
+   inverse_homography[1][0] = -(h[1][0] * h[2][2] - h[1][2] * h[2][0]) / det;
+   inverse_homography[1][1] =  (h[0][0] * h[2][2] - h[0][2] * h[2][0]) / det;
+   inverse_homography[1][2] = -(h[0][0] * h[1][2] - h[0][2] * h[1][0]) / det;
+   inverse_homography[2][0] =  (h[1][0] * h[2][1] - h[1][1] * h[2][0]) / det;
+   inverse_homography[2][1] = -(h[0][0] * h[2][1] - h[0][1] * h[2][0]) / det;
+   inverse_homography[2][2] =  (h[0][0] * h[1][1] - h[0][1] * h[1][0]) / det;
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<3; j++) {
+         if (cvIsNaN(inverse_homography[i][j]) || cvIsInf(inverse_homography[i][j])) {
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+
+/*
+ * inversePerspectiveTransformationBatch
+ * Inverse perspective transformation of an arbitrary array of image points onto the plane z
+ * Returns false if the camera model is degenerate for this plane
+ */
+
+bool inversePerspectiveTransformationBatch(const vector<Point2f> &image_points,
+                                           float camera_model[][4],
+                                           float z,
+                                           vector<Point3f> &world_points) {
+
+   double hi[3][3];
+   double w;
+   int i;
+
+   if (!computeGroundPlaneHomography(camera_model, z, hi)) {
+      return false;
+   }
+
+   world_points.resize(image_points.size());
+
+   for (i=0; i<(int)image_points.size(); i++) {
+      w = hi[2][0] * image_points[i].x + hi[2][1] * image_points[i].y + hi[2][2];
+
+      world_points[i].x = (float) ((hi[0][0] * image_points[i].x + hi[0][1] * image_points[i].y + hi[0][2]) / w);
+      world_points[i].y = (float) ((hi[1][0] * image_points[i].x + hi[1][1] * image_points[i].y + hi[1][2]) / w);
+      world_points[i].z = z;
+   }
+
+   return true;
+}
+
+
+/*
+ * Parallel body for buildGroundPlaneMap: each row of the map is independent.
+ * Along a row the homogeneous coordinates are linear in u so they are computed incrementally.
+ */
+
+class GroundPlaneMapBody : public ParallelLoopBody {
+public:
+   GroundPlaneMapBody(Mat &map, double inverse_homography[][3]) : map_(map) {
+      memcpy(hi_, inverse_homography, sizeof(hi_));
+   }
+
+   virtual void operator()(const Range &range) const {
+      int u, v;
+      double xh, yh, wh;
+
+      for (v = range.start; v < range.end; v++) {
+         Vec2f *row = map_.ptr<Vec2f>(v);
+
+         xh = hi_[0][1] * v + hi_[0][2];
+         yh = hi_[1][1] * v + hi_[1][2];
+         wh = hi_[2][1] * v + hi_[2][2];
+
+         for (u = 0; u < map_.cols; u++) {
+            row[u][0] = (float) (xh / wh);
+            row[u][1] = (float) (yh / wh);
+            xh += hi_[0][0];
+            yh += hi_[1][0];
+            wh += hi_[2][0];
+         }
+      }
+   }
+
+private:
+   Mat    &map_;
+   double hi_[3][3];
+};
+
+
+/*
+ * buildGroundPlaneMap
+ * Build the per-pixel ground-plane map (CV_32FC2) for a given camera model, plane z, and image size
+ * Returns false if the camera model is degenerate for this plane
+ */
+
+bool buildGroundPlaneMap(float camera_model[][4], float z, Size image_size, Mat &ground_plane_map) {
+
+   double hi[3][3];
+
+   if (!computeGroundPlaneHomography(camera_model, z, hi)) {
+      return false;
+   }
+
+   ground_plane_map.create(image_size, CV_32FC2);
+
+   parallel_for_(Range(0, image_size.height), GroundPlaneMapBody(ground_plane_map, hi));
+
+   return true;
+}
+
+
+/*
+ * Binary ground-plane map file format
+ *
+ *    char  magic[4]            "GPM1"
+ *    int   width, height
+ *    float z
+ *    float camera_model[3][4]  the model used to build the map
+ *    float map[height][width][2]
+ *
+ * The camera model and z are stored so that a stale map is detected and rebuilt when the camera is recalibrated.
+ */
+
+static const char ground_plane_map_magic[4] = {'G', 'P', 'M', '1'};
+
+
+/*
+ * saveGroundPlaneMap
+ * Write the ground-plane map to a binary file; returns false on failure
+ */
+
+bool saveGroundPlaneMap(char *filename, Mat &ground_plane_map, float camera_model[][4], float z) {
+
+   FILE *fp_map;
+   int width, height;
+   int v;
+   bool ok;
+
+   if ((fp_map = fopen(filename, "wb")) == 0) {
+      printf("Error can't open ground-plane map file %s for output\n", filename);
+      return false;
+   }
+
+   width  = ground_plane_map.cols;
+   height = ground_plane_map.rows;
+
+   ok = fwrite(ground_plane_map_magic, sizeof(char), 4, fp_map) == 4
+     && fwrite(&width, sizeof(int), 1, fp_map) == 1
+     && fwrite(&height, sizeof(int), 1, fp_map) == 1
+     && fwrite(&z, sizeof(float), 1, fp_map) == 1
+     && fwrite(camera_model, sizeof(float), 12, fp_map) == 12;
+
+   for (v = 0; ok && v < height; v++) {
+      ok = fwrite(ground_plane_map.ptr<Vec2f>(v), sizeof(Vec2f), width, fp_map) == (size_t) width;
+   }
+
+   fclose(fp_map);
+
+   if (!ok) {
+      printf("Error writing ground-plane map file %s\n", filename);
+   }
+   return ok;
+}
+
+
+/*
+ * loadGroundPlaneMap
+ * Read a ground-plane map from a binary file
+ * Returns false if the file does not exist, is corrupt, or was built for a different camera model, z, or image size
+ */
+
+bool loadGroundPlaneMap(char *filename, float camera_model[][4], float z, Size image_size, Mat &ground_plane_map) {
+
+   FILE *fp_map;
+   char  magic[4];
+   int   width, height;
+   float file_z;
+   float file_camera_model[3][4];
+   int   v;
+   bool  ok;
+
+   if ((fp_map = fopen(filename, "rb")) == 0) {
+      return false;
+   }
+
+   ok = fread(magic, sizeof(char), 4, fp_map) == 4
+     && memcmp(magic, ground_plane_map_magic, 4) == 0
+     && fread(&width, sizeof(int), 1, fp_map) == 1
+     && fread(&height, sizeof(int), 1, fp_map) == 1
+     && fread(&file_z, sizeof(float), 1, fp_map) == 1
+     && fread(file_camera_model, sizeof(float), 12, fp_map) == 12
+     && width == image_size.width && height == image_size.height
+     && file_z == z
+     && memcmp(file_camera_model, camera_model, sizeof(file_camera_model)) == 0;
+
+   if (ok) {
+      ground_plane_map.create(height, width, CV_32FC2);
+      for (v = 0; ok && v < height; v++) {
+         ok = fread(ground_plane_map.ptr<Vec2f>(v), sizeof(Vec2f), width, fp_map) == (size_t) width;
+      }
+   }
+
+   fclose(fp_map);
+
+   if (!ok) {
+      ground_plane_map.release();
+   }
+   return ok;
+}
+
+
+/*
+ * getGroundPlaneMap
+ * Load the ground-plane map from file if it is valid for this camera model, z, and image size; 
+ * otherwise build it and save it for the next run
+ */
+
+bool getGroundPlaneMap(char *filename, float camera_model[][4], float z, Size image_size, Mat &ground_plane_map) {
+
+   bool debug = true;
+
+   if (loadGroundPlaneMap(filename, camera_model, z, image_size, ground_plane_map)) {
+      if (debug) printf("Loaded ground-plane map %s\n", filename);
+      return true;
+   }
+
+   if (!buildGroundPlaneMap(camera_model, z, image_size, ground_plane_map)) {
+      printf("Error: the camera model is degenerate for the plane z = %f\n", z);
+      return false;
+   }
+
+   if (debug) printf("Built ground-plane map %d x %d for z = %4.1f\n", image_size.width, image_size.height, z);
+
+   saveGroundPlaneMap(filename, ground_plane_map, camera_model, z);
+
+   return true;
+}
+
+
+/*
+ * mapPointToGroundPlane
+ * World (x, y) coordinates of a sub-pixel image point, e.g. a centroid, by bilinear interpolation of the map
+ */
+
+Point2f mapPointToGroundPlane(Point2f image_point, Mat &ground_plane_map) {
+
+   int   u0, v0, u1, v1;
+   float fu, fv;
+   Vec2f p00, p01, p10, p11, p;
+
+   u0 = min(max(cvFloor(image_point.x), 0), ground_plane_map.cols - 1);
+   v0 = min(max(cvFloor(image_point.y), 0), ground_plane_map.rows - 1);
+   u1 = min(u0 + 1, ground_plane_map.cols - 1);
+   v1 = min(v0 + 1, ground_plane_map.rows - 1);
+
+   fu = min(max(image_point.x - u0, 0.0f), 1.0f);
+   fv = min(max(image_point.y - v0, 0.0f), 1.0f);
+
+   p00 = ground_plane_map.at<Vec2f>(v0, u0);
+   p01 = ground_plane_map.at<Vec2f>(v0, u1);
+   p10 = ground_plane_map.at<Vec2f>(v1, u0);
+   p11 = ground_plane_map.at<Vec2f>(v1, u1);
+
+   p = (p00 * (1 - fu) + p01 * fu) * (1 - fv) + (p10 * (1 - fu) + p11 * fu) * fv;
+
+   return Point2f(p[0], p[1]);
+}
+
+
+/*
+ * mapContourToGroundPlane
+ * World (x, y) coordinates of every point in a contour (as returned by findContours) by a gather from the map
+ */
+
+void mapContourToGroundPlane(const vector<Point> &contour, Mat &ground_plane_map, vector<Point2f> &world_contour) {
+
+   int i;
+   Vec2f p;
+
+   world_contour.resize(contour.size());
+
+   for (i=0; i<(int)contour.size(); i++) {
+      p = ground_plane_map.at<Vec2f>(contour[i].y, contour[i].x);
+      world_contour[i].x = p[0];
+      world_contour[i].y = p[1];
+   }
+}
+
+
+/*
+ * mapMaskToGroundPlane
+ * World (x, y) coordinates of every non-zero pixel in a CV_8U mask of the same size as the map
+ */
+
+void mapMaskToGroundPlane(Mat &mask, Mat &ground_plane_map, vector<Point2f> &world_points) {
+
+   int u, v;
+
+   CV_Assert(mask.type() == CV_8UC1 && mask.size() == ground_plane_map.size());
+
+   world_points.clear();
+   world_points.reserve(countNonZero(mask));
+
+   for (v = 0; v < mask.rows; v++) {
+      const uchar *mask_row = mask.ptr<uchar>(v);
+      const Vec2f *map_row  = ground_plane_map.ptr<Vec2f>(v);
+
+      for (u = 0; u < mask.cols; u++) {
+         if (mask_row[u]) {
+            world_points.push_back(Point2f(map_row[u][0], map_row[u][1]));
+         }
+      }
+   }
+}
+
+
 /*=======================================================*/
 /* Utility functions                                     */ 
 /*=======================================================*/
@@ -20,6 +20,24 @@
 
   David Vernon
   9 June 2018
+
+  Audit Trail
+  --------------------
+  Compute the camera model with the normalised DLT and Levenberg-Marquardt refinement and report the RMS error and solve time;
+  the unnormalised DLT is still computed for comparison in debug mode
+  16 October 2026
+
+  Robust estimation: RANSAC over minimal six-point samples followed by a refit to the inliers, so that mis-detected
+  control points are rejected; the outliers are listed and the normalised DLT is used if too few inliers are found
+  16 October 2026
+
+  Control points are read from memory-mapped binary files, converted from the text files when these change, so there
+  is no longer a limit on the number of control points; the camera model is also written in binary format
+  16 October 2026
+
+  The binary camera model is converted from the text file and read back with the memory-mapped reader, so that both
+  files hold the same model; the inlier flags are kept in a vector
+  16 October 2026
 */
  
 #include "module5/cameraModel.h"
@@ -44,6 +62,7 @@ int main() {
 
    int end_of_file;
    bool debug = true;
+   bool robust = true;
    int i, j;
    double u, v, t;
    double x, y, z;
@@ -51,15 +70,26 @@ int main() {
    char worldControlPointsFilename[MAX_FILENAME_LENGTH];
    char cameralModelFilename[MAX_FILENAME_LENGTH];
    FILE *fp_in;
-   FILE *fp_image_control_points;
-   FILE *fp_world_control_points;
    FILE *fp_camera_model;
 
-   imagePointType imagePoints[MAX_NUMBER_OF_CONTROL_POINTS];
-   worldPointType worldPoints[MAX_NUMBER_OF_CONTROL_POINTS];
+   char imageControlPointsBinaryFilename[MAX_FILENAME_LENGTH];
+   char worldControlPointsBinaryFilename[MAX_FILENAME_LENGTH];
+   char cameraModelBinaryFilename[MAX_FILENAME_LENGTH];
+
+   vector<imagePointType> imagePoints;
+   vector<worldPointType> worldPoints;
+   vector<unsigned char> inliers;
+   int           numberOfInliers = 0;
    double        cameraModel[3][4];
    int           numberOfImageControlPoints;
    int           numberOfWorldControlPoints;
+   cameraModelStatisticsType statistics;
+   double        rms_error;
+   double        max_error;
+   double        elapsed_ms;
+   double        reloadedCameraModel[3][4];
+   double        max_difference;
+   int64         start_ticks;
 
    
    #ifdef ROS   
@@ -104,41 +134,51 @@ int main() {
                printf ("%s\n",cameralModelFilename);
             }
 
-            /* read the image control points */
+            /* read the image and world control points from the binary files, converting the text files first if they have changed */
+
             strcpy(file_path_and_filename, data_dir);
             strcat(file_path_and_filename, imageControlPointsFilename);
             strcpy(imageControlPointsFilename, file_path_and_filename);
+            binaryFilename(imageControlPointsFilename, imageControlPointsBinaryFilename);
 
-            if ((fp_image_control_points = fopen(imageControlPointsFilename,"r")) == 0) {
-	            printf("Error can't open input %s\n",imageControlPointsFilename);
-               prompt_and_exit(1);
-            }
             strcpy(file_path_and_filename, data_dir);
             strcat(file_path_and_filename, worldControlPointsFilename);
             strcpy(worldControlPointsFilename, file_path_and_filename);
+            binaryFilename(worldControlPointsFilename, worldControlPointsBinaryFilename);
 
-            if ((fp_world_control_points = fopen(worldControlPointsFilename,"r")) == 0) {
-	            printf("Error can't open input %s\n",worldControlPointsFilename);
-               prompt_and_exit(1);
+            numberOfImageControlPoints = -1;
+            if (binaryFileIsCurrent(imageControlPointsFilename, imageControlPointsBinaryFilename)) {
+               numberOfImageControlPoints = readImageControlPointsBinary(imageControlPointsBinaryFilename, imagePoints);
+            }
+            if (numberOfImageControlPoints < 0) {
+               if (convertImageControlPointsText(imageControlPointsFilename, imageControlPointsBinaryFilename) < 0) {
+	               printf("Error can't convert input %s\n",imageControlPointsFilename);
+                  prompt_and_exit(1);
+               }
+               numberOfImageControlPoints = readImageControlPointsBinary(imageControlPointsBinaryFilename, imagePoints);
             }
 
-            numberOfImageControlPoints = 0;
-            do {
-               end_of_file = fscanf(fp_image_control_points, "%d %d", &(imagePoints[numberOfImageControlPoints].u), &(imagePoints[numberOfImageControlPoints].v));
-               if (end_of_file != EOF) numberOfImageControlPoints++;
-            } while (end_of_file != EOF);
-                  
-            numberOfWorldControlPoints = 0;
-            do {
-               end_of_file = fscanf(fp_world_control_points, "%f %f %f", &(worldPoints[numberOfWorldControlPoints].x), &(worldPoints[numberOfWorldControlPoints].y), &(worldPoints[numberOfWorldControlPoints].z));
-               if (end_of_file != EOF) numberOfWorldControlPoints++;
-            } while (end_of_file != EOF);
-                
+            numberOfWorldControlPoints = -1;
+            if (binaryFileIsCurrent(worldControlPointsFilename, worldControlPointsBinaryFilename)) {
+               numberOfWorldControlPoints = readWorldControlPointsBinary(worldControlPointsBinaryFilename, worldPoints);
+            }
+            if (numberOfWorldControlPoints < 0) {
+               if (convertWorldControlPointsText(worldControlPointsFilename, worldControlPointsBinaryFilename) < 0) {
+	               printf("Error can't convert input %s\n",worldControlPointsFilename);
+                  prompt_and_exit(1);
+               }
+               numberOfWorldControlPoints = readWorldControlPointsBinary(worldControlPointsBinaryFilename, worldPoints);
+            }
+
+            if (numberOfImageControlPoints < 0 || numberOfWorldControlPoints < 0) {
+               printf("Error can't read the binary control point files\n");
+               prompt_and_exit(1);
+            }
 
             if (debug) {
                printf("Number of image control points %d\n", numberOfImageControlPoints);
                for (i=0; i<numberOfImageControlPoints; i++) {
-                  printf("%d %d \n", imagePoints[i].u, imagePoints[i].v);
+                  printf("%.2f %.2f \n", imagePoints[i].u, imagePoints[i].v);
                }
                printf("\n");
 
@@ -153,11 +193,48 @@ int main() {
                printf("Fatal error: number of image and world control points is not same\n");
                prompt_and_exit(0);
             }
+            else if (numberOfImageControlPoints == 0) {
+               printf("Fatal error: there are no control points\n");
+               prompt_and_exit(0);
+            }
             else {
                
                if (debug) printf("\nComputing camera model ... \n\n");
 
-               computeCameraModel(numberOfImageControlPoints, worldPoints, imagePoints, cameraModel);
+               if (debug) {
+                  start_ticks = getTickCount();
+                  computeCameraModel(numberOfImageControlPoints, &worldPoints[0], &imagePoints[0], cameraModel);
+                  elapsed_ms = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+                  rms_error = cameraModelRMSError(numberOfImageControlPoints, &worldPoints[0], &imagePoints[0], cameraModel, &max_error);
+                  printf("Unnormalised DLT:                 RMS error %6.3f pixels, maximum %6.3f pixels, %8.3f ms\n", 
+                         rms_error, max_error, elapsed_ms);
+               }
+
+               if (robust) {
+                  numberOfInliers = computeCameraModelRobust(numberOfImageControlPoints, &worldPoints[0], &imagePoints[0], RANSAC_INLIER_THRESHOLD, 
+                                                             cameraModel, inliers, &statistics);
+                  if (numberOfInliers == 0) {
+                     printf("Robust estimation failed: too few inliers; using all control points\n");
+                  }
+               }
+
+               if (numberOfInliers == 0) {
+                  computeCameraModelNormalised(numberOfImageControlPoints, &worldPoints[0], &imagePoints[0], cameraModel, &statistics);
+               }
+               else {
+                  printf("RANSAC (%d hypotheses):         %d inliers of %d control points\n", 
+                         statistics.ransac_hypotheses, numberOfInliers, numberOfImageControlPoints);
+                  for (i=0; i<numberOfImageControlPoints; i++) {
+                     if (!inliers[i]) {
+                        printf("Outlier: control point %d (%4.1f %4.1f %4.1f) -> (%6.1f %6.1f)\n", 
+                               i, worldPoints[i].x, worldPoints[i].y, worldPoints[i].z, imagePoints[i].u, imagePoints[i].v);
+                     }
+                  }
+               }
+
+               printf("Normalised DLT:                   RMS error %6.3f pixels\n", statistics.initial_rms_error);
+               printf("Levenberg-Marquardt (%2d iterations): RMS error %6.3f pixels, maximum %6.3f pixels, %8.3f ms\n\n", 
+                      statistics.lm_iterations, statistics.rms_error, statistics.max_error, statistics.solve_time_ms);
   
                /* check result */
 
@@ -178,7 +255,7 @@ int main() {
                   printf("\n");
 
                   for (i=0; i<numberOfImageControlPoints; i++) {
-                     printf("Actual:  (%4.1f %4.1f %4.1f) -> (%4d %4d)\n", worldPoints[i].x,  worldPoints[i].y,  worldPoints[i].z, imagePoints[i].u, imagePoints[i].v);
+                     printf("Actual:  (%4.1f %4.1f %4.1f) -> (%6.1f %6.1f)\n", worldPoints[i].x,  worldPoints[i].y,  worldPoints[i].z, imagePoints[i].u, imagePoints[i].v);
                      u = cameraModel[0][0]*worldPoints[i].x + cameraModel[0][1]*worldPoints[i].y + cameraModel[0][2]*worldPoints[i].z + cameraModel[0][3]*(float)1.0;
                      v = cameraModel[1][0]*worldPoints[i].x + cameraModel[1][1]*worldPoints[i].y + cameraModel[1][2]*worldPoints[i].z + cameraModel[1][3]*(float)1.0;
                      t = cameraModel[2][0]*worldPoints[i].x + cameraModel[2][1]*worldPoints[i].y + cameraModel[2][2]*worldPoints[i].z + cameraModel[2][3]*(float)1.0;
@@ -213,6 +290,26 @@ int main() {
                   }
                   fprintf(fp_camera_model,"\n");
                }
+               fclose(fp_camera_model);
+
+               /* convert the text camera model to binary format and check that the other applications get the same model from it */
+
+               binaryFilename(cameralModelFilename, cameraModelBinaryFilename);
+               if (!convertCameraModelText(cameralModelFilename, cameraModelBinaryFilename) ||
+                   !readCameraModelBinary(cameraModelBinaryFilename, reloadedCameraModel)) {
+	               printf("Error can't write output %s\n",cameraModelBinaryFilename);
+                  prompt_and_exit(1);
+               }
+
+               max_difference = 0;
+               for (i=0; i<3; i++) {
+                  for (j=0; j<4; j++) {
+                     max_difference = max(max_difference, fabs(reloadedCameraModel[i][j] - cameraModel[i][j]));
+                  }
+               }
+               if (debug) printf("\nCamera model written to %s and %s (maximum difference %g from the computed model)\n",
+                                 cameralModelFilename, cameraModelBinaryFilename, max_difference);
+
             }
          }
       }
@@ -7,6 +7,12 @@
 
   David Vernon
   27 March 2018
+
+  Audit Trail
+  --------------------
+  Added computeCameraModelNormalised(): normalised DLT accumulated as 11x11 normal equations 
+  with Levenberg-Marquardt refinement of the reprojection error
+  16 October 2026
 */
  
 #include "module5/cameraModel.h"
@@ -16,11 +22,20 @@
 #include <sstream>
 #include <time.h>
 #include <stdio.h>
+#include <float.h>
+#include <sys/stat.h>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/calib3d/calib3d.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#ifdef ROS
+   #include <sys/mman.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
 
 using namespace cv;
 using namespace std;
@@ -129,7 +144,7 @@ void computeCameraModel(int numberOfControlPoints, worldPointType worldPoints[],
       double u, v, t;
       printf("Validation\n");
       for (i=0; i<numberOfControlPoints; i++) {
-          printf("Actual:  (%4.1f %4.1f %4.1f) -> (%4d %4d)\n", worldPoints[i].x,  worldPoints[i].y,  worldPoints[i].z, imagePoints[i].u, imagePoints[i].v);
+          printf("Actual:  (%4.1f %4.1f %4.1f) -> (%6.1f %6.1f)\n", worldPoints[i].x,  worldPoints[i].y,  worldPoints[i].z, imagePoints[i].u, imagePoints[i].v);
           u = (double)(cameraModel[0][0]*worldPoints[i].x + cameraModel[0][1]*worldPoints[i].y + cameraModel[0][2]*worldPoints[i].z + cameraModel[0][3]*(double)1.0);
           v = (double)(cameraModel[1][0]*worldPoints[i].x + cameraModel[1][1]*worldPoints[i].y + cameraModel[1][2]*worldPoints[i].z + cameraModel[1][3]*(double)1.0);
           t = (double)(cameraModel[2][0]*worldPoints[i].x + cameraModel[2][1]*worldPoints[i].y + cameraModel[2][2]*worldPoints[i].z + cameraModel[2][3]*(double)1.0);
@@ -141,6 +156,990 @@ void computeCameraModel(int numberOfControlPoints, worldPointType worldPoints[],
 
 
 
+/*=======================================================*/
+/* Normalised DLT with Levenberg-Marquardt refinement    */ 
+/*=======================================================*/
+
+/*
+ * computeCameraModel() builds the full 2N x 11 system and solves it with the SVD, so its memory grows with N,
+ * and it uses the raw pixel and world coordinates, which makes the system badly conditioned.
+ *
+ * computeCameraModelNormalised() instead
+ *
+ * 1. normalises the image and world coordinates (Hartley normalisation): each set is translated so that its centroid
+ *    is at the origin and scaled so that the RMS distance from the origin is sqrt(2) (image) or sqrt(3) (world);
+ * 2. accumulates the 11x11 normal equations X^T X c = X^T y of the same 11-unknown linear system point by point,
+ *    so memory is independent of the number of control points;
+ * 3. refines the linear solution by Levenberg-Marquardt minimisation of the reprojection error, 
+ *    each iteration again being one pass over the points that accumulates J^T J and J^T r;
+ * 4. removes the normalisation, P = T_image^-1 P' T_world, and scales P so that P[2][3] = 1.
+ *
+ * The normal equations and the LM steps are solved with the SVD so that, as with computeCameraModel(), 
+ * coplanar control points give the minimum-norm solution with a zero z column.
+ */
+
+#define LM_MAX_ITERATIONS   50
+#define LM_INITIAL_LAMBDA   1e-3
+#define LM_MIN_IMPROVEMENT  1e-12   // relative reduction in the sum of squared errors below which the refinement stops
+
+
+/*
+ * normalisationType
+ * Coordinate normalisation: x' = scale (x - mean)
+ */
+
+struct normalisationType {
+   double image_mean[2];
+   double image_scale;
+   double world_mean[3];
+   double world_scale;
+};
+
+
+static void computeNormalisation(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], 
+                                 normalisationType *normalisation) {
+   double image_sum[2]    = {0, 0};
+   double world_sum[3]    = {0, 0, 0};
+   double image_sum_sq    = 0;
+   double world_sum_sq    = 0;
+   double image_variance;
+   double world_variance;
+   double n = numberOfControlPoints;
+   int i;
+
+   /* one pass: the mean squared distance from the centroid is E[|x|^2] - |E[x]|^2 */
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      image_sum[0] += imagePoints[i].u;
+      image_sum[1] += imagePoints[i].v;
+      image_sum_sq += (double) imagePoints[i].u * imagePoints[i].u + (double) imagePoints[i].v * imagePoints[i].v;
+
+      world_sum[0] += worldPoints[i].x;
+      world_sum[1] += worldPoints[i].y;
+      world_sum[2] += worldPoints[i].z;
+      world_sum_sq += (double) worldPoints[i].x * worldPoints[i].x + (double) worldPoints[i].y * worldPoints[i].y 
+                    + (double) worldPoints[i].z * worldPoints[i].z;
+   }
+
+   normalisation->image_mean[0] = image_sum[0] / n;
+   normalisation->image_mean[1] = image_sum[1] / n;
+   normalisation->world_mean[0] = world_sum[0] / n;
+   normalisation->world_mean[1] = world_sum[1] / n;
+   normalisation->world_mean[2] = world_sum[2] / n;
+
+   image_variance = image_sum_sq / n - (normalisation->image_mean[0] * normalisation->image_mean[0] 
+                                      + normalisation->image_mean[1] * normalisation->image_mean[1]);
+   world_variance = world_sum_sq / n - (normalisation->world_mean[0] * normalisation->world_mean[0] 
+                                      + normalisation->world_mean[1] * normalisation->world_mean[1]
+                                      + normalisation->world_mean[2] * normalisation->world_mean[2]);
+
+   normalisation->image_scale = image_variance > 0 ? sqrt(2.0 / image_variance) : 1.0;
+   normalisation->world_scale = world_variance > 0 ? sqrt(3.0 / world_variance) : 1.0;
+}
+
+
+/*
+ * normalise_point
+ * Normalised world coordinates X[0..2] and image coordinates u, v of control point i
+ */
+
+static inline void normalise_point(const normalisationType *normalisation, worldPointType *worldPoint, imagePointType *imagePoint,
+                                   double X[3], double *u, double *v) {
+   X[0] = normalisation->world_scale * (worldPoint->x - normalisation->world_mean[0]);
+   X[1] = normalisation->world_scale * (worldPoint->y - normalisation->world_mean[1]);
+   X[2] = normalisation->world_scale * (worldPoint->z - normalisation->world_mean[2]);
+   *u   = normalisation->image_scale * (imagePoint->u - normalisation->image_mean[0]);
+   *v   = normalisation->image_scale * (imagePoint->v - normalisation->image_mean[1]);
+}
+
+
+/*
+ * accumulate_symmetric
+ * A += r r^T (upper triangle only) and b += r y for one row r of an 11-unknown system
+ */
+
+static inline void accumulate_symmetric(double A[][NUMBER_OF_UNKNOWNS], double b[], const double r[], double y) {
+   int j, k;
+
+   for (j=0; j<NUMBER_OF_UNKNOWNS; j++) {
+      if (r[j] == 0) continue;                      // half of each DLT row is zero
+      for (k=j; k<NUMBER_OF_UNKNOWNS; k++) {
+         A[j][k] += r[j] * r[k];
+      }
+      b[j] += r[j] * y;
+   }
+}
+
+
+/*
+ * solve_symmetric
+ * Solve (A + lambda diag(A)) c = b, where only the upper triangle of A is set, with the SVD (minimum-norm solution)
+ */
+
+static void solve_symmetric(double A[][NUMBER_OF_UNKNOWNS], double b[], double lambda, double c[]) {
+   double full[NUMBER_OF_UNKNOWNS][NUMBER_OF_UNKNOWNS];
+   int j, k;
+
+   for (j=0; j<NUMBER_OF_UNKNOWNS; j++) {
+      for (k=j; k<NUMBER_OF_UNKNOWNS; k++) {
+         full[j][k] = full[k][j] = A[j][k];
+      }
+      full[j][j] = A[j][j] * (1.0 + lambda);
+   }
+
+   Mat N(NUMBER_OF_UNKNOWNS, NUMBER_OF_UNKNOWNS, CV_64FC1, full);
+   Mat B(NUMBER_OF_UNKNOWNS, 1, CV_64FC1, b);
+   Mat C(NUMBER_OF_UNKNOWNS, 1, CV_64FC1, c);   // the solution is written directly into c
+
+   solve(N, B, C, DECOMP_SVD);
+}
+
+
+/*
+ * reprojection_pass
+ * One pass over the control points for the normalised 11-parameter model p (p[11] = 1 implicitly):
+ * returns the sum of squared normalised reprojection errors and, if JtJ is not NULL, accumulates J^T J and J^T r
+ */
+
+static double reprojection_pass(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[],
+                                const normalisationType *normalisation, const double p[],
+                                double JtJ[][NUMBER_OF_UNKNOWNS], double Jtr[]) {
+   double X[3], u, v;
+   double w, u_hat, v_hat, ru, rv;
+   double ju[NUMBER_OF_UNKNOWNS], jv[NUMBER_OF_UNKNOWNS];
+   double sum_sq = 0;
+   int i, j;
+
+   if (JtJ != NULL) {
+      memset(JtJ, 0, sizeof(double) * NUMBER_OF_UNKNOWNS * NUMBER_OF_UNKNOWNS);
+      memset(Jtr, 0, sizeof(double) * NUMBER_OF_UNKNOWNS);
+   }
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      normalise_point(normalisation, &worldPoints[i], &imagePoints[i], X, &u, &v);
+
+      w     =  p[8]*X[0] + p[9]*X[1] + p[10]*X[2] + 1.0;
+      u_hat = (p[0]*X[0] + p[1]*X[1] + p[2]*X[2]  + p[3]) / w;
+      v_hat = (p[4]*X[0] + p[5]*X[1] + p[6]*X[2]  + p[7]) / w;
+      ru    = u_hat - u;
+      rv    = v_hat - v;
+
+      sum_sq += ru*ru + rv*rv;
+
+      if (JtJ != NULL) {
+         for (j=0; j<3; j++) {
+            ju[j]   = X[j] / w;   ju[4+j] = 0;        ju[8+j] = -u_hat * X[j] / w;
+            jv[j]   = 0;          jv[4+j] = X[j] / w; jv[8+j] = -v_hat * X[j] / w;
+         }
+         ju[3] = 1.0 / w;  ju[7] = 0;
+         jv[3] = 0;        jv[7] = 1.0 / w;
+
+         accumulate_symmetric(JtJ, Jtr, ju, ru);
+         accumulate_symmetric(JtJ, Jtr, jv, rv);
+      }
+   }
+
+   return sum_sq;
+}
+
+
+/*
+ * computeCameraModelNormalised
+ * Camera model from any number of control points by normalised DLT and Levenberg-Marquardt refinement
+ * If statistics is not NULL, the RMS reprojection error (pixels) before and after refinement, the maximum error,
+ * the number of LM iterations, and the solve time are returned
+ */
+
+void computeCameraModelNormalised(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], 
+                                  double cameraModel[][4], cameraModelStatisticsType *statistics) {
+
+   normalisationType normalisation;
+   double N[NUMBER_OF_UNKNOWNS][NUMBER_OF_UNKNOWNS];
+   double b[NUMBER_OF_UNKNOWNS];
+   double r[NUMBER_OF_UNKNOWNS];
+   double p[NUMBER_OF_UNKNOWNS];
+   double p_new[NUMBER_OF_UNKNOWNS];
+   double delta[NUMBER_OF_UNKNOWNS];
+   double X[3], u, v;
+   double cost, new_cost, initial_cost;
+   double lambda;
+   double T_image[3][3], T_world[4][4], P[3][4], PT[3][4];
+   int    iteration;
+   int    i, j, k;
+   int64  start_ticks;
+   bool   debug = false;
+
+   start_ticks = getTickCount();
+
+   computeNormalisation(numberOfControlPoints, worldPoints, imagePoints, &normalisation);
+
+   /* linear solution: accumulate the normal equations of the normalised DLT system */
+
+   memset(N, 0, sizeof(N));
+   memset(b, 0, sizeof(b));
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      normalise_point(&normalisation, &worldPoints[i], &imagePoints[i], X, &u, &v);
+
+      r[0] = X[0]; r[1] = X[1]; r[2] = X[2]; r[3] = 1.0; r[4] = 0;    r[5] = 0;    r[6] = 0;    r[7] = 0;
+      r[8] = -u * X[0]; r[9] = -u * X[1]; r[10] = -u * X[2];
+      accumulate_symmetric(N, b, r, u);
+
+      r[0] = 0;    r[1] = 0;    r[2] = 0;    r[3] = 0;   r[4] = X[0]; r[5] = X[1]; r[6] = X[2]; r[7] = 1.0;
+      r[8] = -v * X[0]; r[9] = -v * X[1]; r[10] = -v * X[2];
+      accumulate_symmetric(N, b, r, v);
+   }
+
+   solve_symmetric(N, b, 0.0, p);
+
+   /* Levenberg-Marquardt refinement of the reprojection error */
+
+   lambda       = LM_INITIAL_LAMBDA;
+   cost         = reprojection_pass(numberOfControlPoints, worldPoints, imagePoints, &normalisation, p, N, b);
+   initial_cost = cost;
+
+   for (iteration = 0; iteration < LM_MAX_ITERATIONS; iteration++) {
+
+      for (j=0; j<NUMBER_OF_UNKNOWNS; j++) b[j] = -b[j];
+      solve_symmetric(N, b, lambda, delta);
+      for (j=0; j<NUMBER_OF_UNKNOWNS; j++) b[j] = -b[j];
+
+      for (j=0; j<NUMBER_OF_UNKNOWNS; j++) p_new[j] = p[j] + delta[j];
+
+      new_cost = reprojection_pass(numberOfControlPoints, worldPoints, imagePoints, &normalisation, p_new, NULL, NULL);
+
+      if (new_cost < cost) {
+         memcpy(p, p_new, sizeof(p));
+         lambda = lambda / 10;
+
+         if (cost - new_cost < LM_MIN_IMPROVEMENT * cost) {
+            cost = new_cost;
+            break;
+         }
+
+         cost = reprojection_pass(numberOfControlPoints, worldPoints, imagePoints, &normalisation, p, N, b);
+      }
+      else {
+         lambda = lambda * 10;
+         if (lambda > 1e10) break;
+      }
+
+      if (debug) printf("LM iteration %d: lambda %e, cost %e\n", iteration, lambda, cost);
+   }
+
+   /* remove the normalisation: P = T_image^-1 P' T_world */
+
+   memset(T_image, 0, sizeof(T_image));
+   T_image[0][0] = 1.0 / normalisation.image_scale;  T_image[0][2] = normalisation.image_mean[0];
+   T_image[1][1] = 1.0 / normalisation.image_scale;  T_image[1][2] = normalisation.image_mean[1];
+   T_image[2][2] = 1.0;
+
+   memset(T_world, 0, sizeof(T_world));
+   for (j=0; j<3; j++) {
+      T_world[j][j] = normalisation.world_scale;
+      T_world[j][3] = -normalisation.world_scale * normalisation.world_mean[j];
+   }
+   T_world[3][3] = 1.0;
+
+   PT[0][0] = p[0]; PT[0][1] = p[1]; PT[0][2] = p[2];  PT[0][3] = p[3];
+   PT[1][0] = p[4]; PT[1][1] = p[5]; PT[1][2] = p[6];  PT[1][3] = p[7];
+   PT[2][0] = p[8]; PT[2][1] = p[9]; PT[2][2] = p[10]; PT[2][3] = 1.0;
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         P[i][j] = 0;
+         for (k=0; k<4; k++) P[i][j] += PT[i][k] * T_world[k][j];
+      }
+   }
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         cameraModel[i][j] = 0;
+         for (k=0; k<3; k++) cameraModel[i][j] += T_image[i][k] * P[k][j];
+      }
+   }
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         if (i != 2 || j != 3) cameraModel[i][j] = cameraModel[i][j] / cameraModel[2][3];
+      }
+   }
+   cameraModel[2][3] = 1.0;
+
+   if (statistics != NULL) {
+      statistics->solve_time_ms     = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+      statistics->initial_rms_error = sqrt(initial_cost / numberOfControlPoints) / normalisation.image_scale;
+      statistics->rms_error         = cameraModelRMSError(numberOfControlPoints, worldPoints, imagePoints, cameraModel, &statistics->max_error);
+      statistics->lm_iterations     = iteration;
+      statistics->number_of_inliers = numberOfControlPoints;
+      statistics->ransac_hypotheses = 0;
+   }
+}
+
+
+/*
+ * cameraModelRMSError
+ * RMS reprojection error in pixels of a camera model over the control points; the maximum error is returned in max_error
+ */
+
+double cameraModelRMSError(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], 
+                           double cameraModel[][4], double *max_error) {
+   double u, v, t, du, dv, e;
+   double sum_sq = 0;
+   int i;
+
+   *max_error = 0;
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      u = cameraModel[0][0]*worldPoints[i].x + cameraModel[0][1]*worldPoints[i].y + cameraModel[0][2]*worldPoints[i].z + cameraModel[0][3];
+      v = cameraModel[1][0]*worldPoints[i].x + cameraModel[1][1]*worldPoints[i].y + cameraModel[1][2]*worldPoints[i].z + cameraModel[1][3];
+      t = cameraModel[2][0]*worldPoints[i].x + cameraModel[2][1]*worldPoints[i].y + cameraModel[2][2]*worldPoints[i].z + cameraModel[2][3];
+      du = u/t - imagePoints[i].u;
+      dv = v/t - imagePoints[i].v;
+      e  = du*du + dv*dv;
+      sum_sq += e;
+      if (sqrt(e) > *max_error) *max_error = sqrt(e);
+   }
+
+   return numberOfControlPoints > 0 ? sqrt(sum_sq / numberOfControlPoints) : 0;
+}
+
+
+/*=======================================================*/
+/* Robust camera model estimation (RANSAC)               */ 
+/*=======================================================*/
+
+/*
+ * A single mis-detected control point can corrupt the least-squares camera model.
+ * computeCameraModelRobust() fits models to random minimal samples of six control points (twelve equations 
+ * for the eleven unknowns), scores each model on all the control points with the truncated squared reprojection 
+ * error (MSAC), keeps the best, and then refits the model to its inliers with computeCameraModelNormalised().
+ *
+ * Hypotheses are generated and scored in rounds of RANSAC_HYPOTHESES_PER_ROUND, spread over the available threads,
+ * and the number of rounds adapts to the inlier ratio of the best model found so far: sampling stops once the 
+ * probability of having drawn at least one all-inlier sample exceeds RANSAC_CONFIDENCE.
+ * The scoring loop uses the control points in structure-of-arrays form and OpenCV's universal SIMD intrinsics.
+ */
+
+#define RANSAC_SAMPLE_SIZE          6
+#define RANSAC_HYPOTHESES_PER_ROUND 64
+#define RANSAC_MAX_HYPOTHESES       10000
+#define RANSAC_CONFIDENCE           0.999
+
+
+/*
+ * controlPointArraysType
+ * Control points as separate float arrays for vectorised scoring
+ */
+
+struct controlPointArraysType {
+   vector<float> x, y, z, u, v;
+};
+
+
+/*
+ * minimal_sample_model
+ * Camera model (p[11] = 1 implicitly) from six control points with the SVD; returns false if the sample is degenerate
+ */
+
+static bool minimal_sample_model(worldPointType worldPoints[], imagePointType imagePoints[], const int sample[], double p[]) {
+   double A[2 * RANSAC_SAMPLE_SIZE][NUMBER_OF_UNKNOWNS];
+   double y[2 * RANSAC_SAMPLE_SIZE];
+   double X, Y, Z, u, v;
+   int i, j;
+
+   memset(A, 0, sizeof(A));
+
+   for (i=0; i<RANSAC_SAMPLE_SIZE; i++) {
+      X = worldPoints[sample[i]].x;
+      Y = worldPoints[sample[i]].y;
+      Z = worldPoints[sample[i]].z;
+      u = imagePoints[sample[i]].u;
+      v = imagePoints[sample[i]].v;
+
+      A[2*i][0]   = X;  A[2*i][1]   = Y;  A[2*i][2]   = Z;  A[2*i][3]   = 1;
+      A[2*i][8]   = -u * X;  A[2*i][9]   = -u * Y;  A[2*i][10]   = -u * Z;
+      y[2*i]      = u;
+
+      A[2*i+1][4] = X;  A[2*i+1][5] = Y;  A[2*i+1][6] = Z;  A[2*i+1][7] = 1;
+      A[2*i+1][8] = -v * X;  A[2*i+1][9] = -v * Y;  A[2*i+1][10] = -v * Z;
+      y[2*i+1]    = v;
+   }
+
+   Mat AM(2 * RANSAC_SAMPLE_SIZE, NUMBER_OF_UNKNOWNS, CV_64FC1, A);
+   Mat YM(2 * RANSAC_SAMPLE_SIZE, 1, CV_64FC1, y);
+   Mat PM(NUMBER_OF_UNKNOWNS, 1, CV_64FC1, p);
+
+   solve(AM, YM, PM, DECOMP_SVD);
+
+   for (j=0; j<NUMBER_OF_UNKNOWNS; j++) {
+      if (cvIsNaN(p[j]) || cvIsInf(p[j])) return false;
+   }
+   return true;
+}
+
+
+/*
+ * msac_score
+ * Sum over all control points of min(e^2, threshold^2), where e is the reprojection error of model p
+ */
+
+static double msac_score(const controlPointArraysType &points, const double p[], float threshold) {
+   const float *x = &points.x[0], *y = &points.y[0], *z = &points.z[0], *u = &points.u[0], *v = &points.v[0];
+   int    n = (int) points.x.size();
+   float  threshold_sq = threshold * threshold;
+   double score = 0;
+   float  w, du, dv;
+   int    i = 0;
+
+#if CV_SIMD128
+   v_float32x4 p0 = v_setall_f32((float) p[0]), p1 = v_setall_f32((float) p[1]), p2  = v_setall_f32((float) p[2]),  p3 = v_setall_f32((float) p[3]);
+   v_float32x4 p4 = v_setall_f32((float) p[4]), p5 = v_setall_f32((float) p[5]), p6  = v_setall_f32((float) p[6]),  p7 = v_setall_f32((float) p[7]);
+   v_float32x4 p8 = v_setall_f32((float) p[8]), p9 = v_setall_f32((float) p[9]), p10 = v_setall_f32((float) p[10]), one = v_setall_f32(1.0f);
+   v_float32x4 v_threshold_sq = v_setall_f32(threshold_sq);
+   v_float32x4 v_score = v_setzero_f32();
+
+   for ( ; i + 4 <= n; i += 4) {
+      v_float32x4 vx = v_load(x + i), vy = v_load(y + i), vz = v_load(z + i);
+      v_float32x4 vw  = p8 * vx + p9 * vy + p10 * vz + one;
+      v_float32x4 vdu = (p0 * vx + p1 * vy + p2 * vz + p3) / vw - v_load(u + i);
+      v_float32x4 vdv = (p4 * vx + p5 * vy + p6 * vz + p7) / vw - v_load(v + i);
+      v_score += v_min(vdu * vdu + vdv * vdv, v_threshold_sq);
+   }
+   score = v_reduce_sum(v_score);
+#endif
+
+   for ( ; i < n; i++) {
+      w  = (float) (p[8] * x[i] + p[9] * y[i] + p[10] * z[i] + 1.0);
+      du = (float) ((p[0] * x[i] + p[1] * y[i] + p[2] * z[i] + p[3]) / w) - u[i];
+      dv = (float) ((p[4] * x[i] + p[5] * y[i] + p[6] * z[i] + p[7]) / w) - v[i];
+      score += min(du * du + dv * dv, threshold_sq);
+   }
+
+   return score;
+}
+
+
+/*
+ * count_inliers
+ * Number of control points whose reprojection error under model p is less than the threshold; the mask is set if not NULL
+ */
+
+static int count_inliers(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], 
+                         const double p[], double threshold, unsigned char inliers[]) {
+   double w, du, dv;
+   int i;
+   int number_of_inliers = 0;
+   bool inlier;
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      w  =  p[8] * worldPoints[i].x + p[9] * worldPoints[i].y + p[10] * worldPoints[i].z + p[11];
+      du = (p[0] * worldPoints[i].x + p[1] * worldPoints[i].y + p[2]  * worldPoints[i].z + p[3]) / w - imagePoints[i].u;
+      dv = (p[4] * worldPoints[i].x + p[5] * worldPoints[i].y + p[6]  * worldPoints[i].z + p[7]) / w - imagePoints[i].v;
+      inlier = du * du + dv * dv < threshold * threshold;
+      if (inlier) number_of_inliers++;
+      if (inliers != NULL) inliers[i] = (unsigned char) inlier;
+   }
+   return number_of_inliers;
+}
+
+
+/*
+ * Parallel body for one round of hypotheses: each hypothesis uses its own random number generator, seeded from
+ * the round and hypothesis number so that the result does not depend on the number of threads
+ */
+
+class RansacRoundBody : public ParallelLoopBody {
+public:
+   RansacRoundBody(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[],
+                   const controlPointArraysType &points, float threshold, int round, double *models, double *scores) :
+      numberOfControlPoints_(numberOfControlPoints), worldPoints_(worldPoints), imagePoints_(imagePoints),
+      points_(points), threshold_(threshold), round_(round), models_(models), scores_(scores) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      int hypothesis, i, j;
+      int sample[RANSAC_SAMPLE_SIZE];
+      bool duplicate;
+      double *p;
+
+      for (hypothesis = range.start; hypothesis < range.end; hypothesis++) {
+         RNG rng((uint64) round_ * RANSAC_HYPOTHESES_PER_ROUND + hypothesis + 1);
+
+         for (i=0; i<RANSAC_SAMPLE_SIZE; i++) {
+            do {
+               sample[i] = rng.uniform(0, numberOfControlPoints_);
+               duplicate = false;
+               for (j=0; j<i; j++) {
+                  if (sample[j] == sample[i]) duplicate = true;
+               }
+            } while (duplicate);
+         }
+
+         p = models_ + (size_t) hypothesis * NUMBER_OF_UNKNOWNS;
+
+         if (minimal_sample_model(worldPoints_, imagePoints_, sample, p)) {
+            scores_[hypothesis] = msac_score(points_, p, threshold_);
+         }
+         else {
+            scores_[hypothesis] = DBL_MAX;
+         }
+      }
+   }
+
+private:
+   int                           numberOfControlPoints_;
+   worldPointType               *worldPoints_;
+   imagePointType               *imagePoints_;
+   const controlPointArraysType &points_;
+   float                         threshold_;
+   int                           round_;
+   double                       *models_;
+   double                       *scores_;
+};
+
+
+/*
+ * computeCameraModelRobust
+ * Camera model from control points that may include outliers
+ * threshold is the maximum reprojection error in pixels of an inlier; inliers is resized to the number of control points
+ * and set to 1 for each inlier and 0 for each outlier
+ * Returns the number of inliers (0 if there are too few control points)
+ */
+
+int computeCameraModelRobust(int numberOfControlPoints, worldPointType worldPoints[], imagePointType imagePoints[], 
+                             double threshold, double cameraModel[][4], vector<unsigned char> &inliers, cameraModelStatisticsType *statistics) {
+
+   controlPointArraysType points;
+   double models[RANSAC_HYPOTHESES_PER_ROUND * NUMBER_OF_UNKNOWNS];
+   double scores[RANSAC_HYPOTHESES_PER_ROUND];
+   double best_model[NUMBER_OF_UNKNOWNS + 1];
+   double best_score = DBL_MAX;
+   double required_hypotheses = RANSAC_MAX_HYPOTHESES;
+   double inlier_ratio;
+   int    number_of_hypotheses = 0;
+   int    number_of_inliers = 0;
+   int    round, h, i, j;
+   int64  start_ticks;
+   bool   debug = false;
+
+   inliers.assign(numberOfControlPoints, 0);
+
+   if (numberOfControlPoints < RANSAC_SAMPLE_SIZE) {
+      return 0;
+   }
+
+   start_ticks = getTickCount();
+
+   points.x.resize(numberOfControlPoints);
+   points.y.resize(numberOfControlPoints);
+   points.z.resize(numberOfControlPoints);
+   points.u.resize(numberOfControlPoints);
+   points.v.resize(numberOfControlPoints);
+   for (i=0; i<numberOfControlPoints; i++) {
+      points.x[i] = worldPoints[i].x;
+      points.y[i] = worldPoints[i].y;
+      points.z[i] = worldPoints[i].z;
+      points.u[i] = imagePoints[i].u;
+      points.v[i] = imagePoints[i].v;
+   }
+
+   memset(best_model, 0, sizeof(best_model));
+
+   for (round = 0; number_of_hypotheses < required_hypotheses && number_of_hypotheses < RANSAC_MAX_HYPOTHESES; round++) {
+
+      parallel_for_(Range(0, RANSAC_HYPOTHESES_PER_ROUND), 
+                    RansacRoundBody(numberOfControlPoints, worldPoints, imagePoints, points, (float) threshold, round, models, scores));
+
+      number_of_hypotheses += RANSAC_HYPOTHESES_PER_ROUND;
+
+      for (h = 0; h < RANSAC_HYPOTHESES_PER_ROUND; h++) {
+         if (scores[h] < best_score) {
+            best_score = scores[h];
+            memcpy(best_model, &models[h * NUMBER_OF_UNKNOWNS], sizeof(double) * NUMBER_OF_UNKNOWNS);
+            best_model[NUMBER_OF_UNKNOWNS] = 1.0;
+
+            /* adaptive termination: number of samples needed to draw an all-inlier sample with the required confidence */
+
+            number_of_inliers = count_inliers(numberOfControlPoints, worldPoints, imagePoints, best_model, threshold, NULL);
+            inlier_ratio      = (double) number_of_inliers / numberOfControlPoints;
+
+            if (inlier_ratio >= 1.0) {
+               required_hypotheses = 0;
+            }
+            else if (inlier_ratio > 0) {
+               required_hypotheses = log(1 - RANSAC_CONFIDENCE) / log(1 - pow(inlier_ratio, RANSAC_SAMPLE_SIZE));
+            }
+         }
+      }
+
+      if (debug) printf("RANSAC round %d: %d inliers, %.0f hypotheses required\n", round, number_of_inliers, required_hypotheses);
+   }
+
+   if (number_of_inliers < RANSAC_SAMPLE_SIZE) {
+      return 0;
+   }
+
+   /* refit to the inliers, then recompute the inliers of the refined model */
+
+   count_inliers(numberOfControlPoints, worldPoints, imagePoints, best_model, threshold, &inliers[0]);
+
+   vector<worldPointType> inlierWorldPoints;
+   vector<imagePointType> inlierImagePoints;
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      if (inliers[i]) {
+         inlierWorldPoints.push_back(worldPoints[i]);
+         inlierImagePoints.push_back(imagePoints[i]);
+      }
+   }
+
+   computeCameraModelNormalised((int) inlierWorldPoints.size(), &inlierWorldPoints[0], &inlierImagePoints[0], cameraModel, statistics);
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         best_model[i * 4 + j] = cameraModel[i][j];
+      }
+   }
+   number_of_inliers = count_inliers(numberOfControlPoints, worldPoints, imagePoints, best_model, threshold, &inliers[0]);
+
+   if (statistics != NULL) {
+      statistics->solve_time_ms     = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+      statistics->number_of_inliers = number_of_inliers;
+      statistics->ransac_hypotheses = number_of_hypotheses;
+   }
+
+   if (debug) printf("RANSAC: %d hypotheses, %d inliers of %d control points\n", number_of_hypotheses, number_of_inliers, numberOfControlPoints);
+
+   return number_of_inliers;
+}
+
+
+/*=======================================================*/
+/* Binary control point and camera model files           */ 
+/*=======================================================*/
+
+/*
+ * Control points and camera models can be stored in a compact binary format instead of text, so that they can be
+ * memory-mapped and used without parsing.  Each file has a binaryFileHeaderType header followed by the data:
+ *
+ *   image control points:  count floats u, then count floats v                  (magic BINARY_IMAGE_POINTS_MAGIC)
+ *   world control points:  count floats x, then count floats y, then count floats z (magic BINARY_WORLD_POINTS_MAGIC)
+ *   camera model:          the twelve elements of the 3x4 matrix in row order, as doubles (magic BINARY_CAMERA_MODEL_MAGIC)
+ *
+ * The header records the format version, the number of points, the number of components per point, the size of
+ * each element, and an FNV-1a checksum of the data.  All values are little-endian, as written by the host.
+ */
+
+/*
+ * write_binary_file
+ * Write a header and data block; returns false if the file can't be written
+ */
+
+static bool write_binary_file(const char *filename, const char *magic, int count, int components, int element_size, const void *data) {
+   binaryFileHeaderType header;
+   size_t size = (size_t) count * components * element_size;
+   FILE *fp;
+   bool ok;
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, magic, 4);
+   header.version      = BINARY_FORMAT_VERSION;
+   header.count        = count;
+   header.components   = components;
+   header.element_size = element_size;
+   header.checksum     = fnv1a_checksum((const unsigned char *) data, size);
+
+   if ((fp = fopen(filename, "wb")) == 0) {
+      return false;
+   }
+   ok = fwrite(&header, sizeof(header), 1, fp) == 1 && (size == 0 || fwrite(data, size, 1, fp) == 1);
+   fclose(fp);
+   return ok;
+}
+
+
+/*
+ * mapBinaryFile
+ * Memory-map a binary file and check its header and checksum; returns false if the file is missing or invalid
+ */
+
+bool mapBinaryFile(const char *filename, const char *magic, mappedBinaryFileType *file) {
+   size_t file_size;
+
+   memset(file, 0, sizeof(*file));
+
+#ifdef ROS
+   struct stat st;
+   int fd;
+   void *p;
+
+   if ((fd = open(filename, O_RDONLY)) < 0) {
+      return false;
+   }
+   if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(binaryFileHeaderType)) {
+      close(fd);
+      return false;
+   }
+   file_size = (size_t) st.st_size;
+   p = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (p == MAP_FAILED) {
+      return false;
+   }
+#else
+   FILE *fp;
+   void *p;
+
+   if ((fp = fopen(filename, "rb")) == 0) {
+      return false;
+   }
+   fseek(fp, 0, SEEK_END);
+   file_size = (size_t) ftell(fp);
+   fseek(fp, 0, SEEK_SET);
+   if (file_size < sizeof(binaryFileHeaderType) || (p = malloc(file_size)) == NULL) {
+      fclose(fp);
+      return false;
+   }
+   if (fread(p, file_size, 1, fp) != 1) {
+      free(p);
+      fclose(fp);
+      return false;
+   }
+   fclose(fp);
+#endif
+
+   file->mapping = p;
+   file->size    = file_size;
+   file->header  = (const binaryFileHeaderType *) p;
+   file->data    = (const unsigned char *) p + sizeof(binaryFileHeaderType);
+
+   if (memcmp(file->header->magic, magic, 4) != 0 || 
+       file->header->version != BINARY_FORMAT_VERSION ||
+       file_size != sizeof(binaryFileHeaderType) + (size_t) file->header->count * file->header->components * file->header->element_size ||
+       file->header->checksum != fnv1a_checksum(file->data, file_size - sizeof(binaryFileHeaderType))) {
+      unmapBinaryFile(file);
+      return false;
+   }
+   return true;
+}
+
+
+/*
+ * unmapBinaryFile
+ * Release a file mapped with mapBinaryFile()
+ */
+
+void unmapBinaryFile(mappedBinaryFileType *file) {
+   if (file->mapping != NULL) {
+#ifdef ROS
+      munmap(file->mapping, file->size);
+#else
+      free(file->mapping);
+#endif
+   }
+   memset(file, 0, sizeof(*file));
+}
+
+
+/*
+ * Write image control points, world control points, and camera models in binary format
+ */
+
+bool writeImageControlPointsBinary(const char *filename, int numberOfControlPoints, imagePointType imagePoints[]) {
+   vector<float> data(2 * (size_t) numberOfControlPoints);
+   int i;
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      data[i]                         = imagePoints[i].u;
+      data[numberOfControlPoints + i] = imagePoints[i].v;
+   }
+   return write_binary_file(filename, BINARY_IMAGE_POINTS_MAGIC, numberOfControlPoints, 2, sizeof(float), data.empty() ? NULL : &data[0]);
+}
+
+bool writeWorldControlPointsBinary(const char *filename, int numberOfControlPoints, worldPointType worldPoints[]) {
+   vector<float> data(3 * (size_t) numberOfControlPoints);
+   int i;
+
+   for (i=0; i<numberOfControlPoints; i++) {
+      data[i]                             = worldPoints[i].x;
+      data[numberOfControlPoints + i]     = worldPoints[i].y;
+      data[2 * numberOfControlPoints + i] = worldPoints[i].z;
+   }
+   return write_binary_file(filename, BINARY_WORLD_POINTS_MAGIC, numberOfControlPoints, 3, sizeof(float), data.empty() ? NULL : &data[0]);
+}
+
+bool writeCameraModelBinary(const char *filename, double cameraModel[][4]) {
+   return write_binary_file(filename, BINARY_CAMERA_MODEL_MAGIC, 1, 12, sizeof(double), cameraModel);
+}
+
+
+/*
+ * Read image control points, world control points, and camera models from binary files
+ * The control point readers return the number of points, or -1 if the file is missing or invalid
+ */
+
+int readImageControlPointsBinary(const char *filename, vector<imagePointType> &imagePoints) {
+   mappedBinaryFileType file;
+   const float *u, *v;
+   int i, n;
+
+   if (!mapBinaryFile(filename, BINARY_IMAGE_POINTS_MAGIC, &file) || file.header->components != 2 || file.header->element_size != sizeof(float)) {
+      unmapBinaryFile(&file);
+      return -1;
+   }
+
+   n = file.header->count;
+   u = (const float *) file.data;
+   v = u + n;
+
+   imagePoints.resize(n);
+   for (i=0; i<n; i++) {
+      imagePoints[i].u = u[i];
+      imagePoints[i].v = v[i];
+   }
+
+   unmapBinaryFile(&file);
+   return n;
+}
+
+int readWorldControlPointsBinary(const char *filename, vector<worldPointType> &worldPoints) {
+   mappedBinaryFileType file;
+   const float *x, *y, *z;
+   int i, n;
+
+   if (!mapBinaryFile(filename, BINARY_WORLD_POINTS_MAGIC, &file) || file.header->components != 3 || file.header->element_size != sizeof(float)) {
+      unmapBinaryFile(&file);
+      return -1;
+   }
+
+   n = file.header->count;
+   x = (const float *) file.data;
+   y = x + n;
+   z = y + n;
+
+   worldPoints.resize(n);
+   for (i=0; i<n; i++) {
+      worldPoints[i].x = x[i];
+      worldPoints[i].y = y[i];
+      worldPoints[i].z = z[i];
+   }
+
+   unmapBinaryFile(&file);
+   return n;
+}
+
+bool readCameraModelBinary(const char *filename, double cameraModel[][4]) {
+   mappedBinaryFileType file;
+
+   if (!mapBinaryFile(filename, BINARY_CAMERA_MODEL_MAGIC, &file) || file.header->count != 1 || 
+       file.header->components != 12 || file.header->element_size != sizeof(double)) {
+      unmapBinaryFile(&file);
+      return false;
+   }
+
+   memcpy(cameraModel, file.data, 12 * sizeof(double));
+
+   unmapBinaryFile(&file);
+   return true;
+}
+
+
+/*
+ * Convert the existing text files to binary format
+ * The control point converters return the number of points, or -1 if the text file can't be read or the binary file can't be written
+ */
+
+int convertImageControlPointsText(const char *text_filename, const char *binary_filename) {
+   vector<imagePointType> imagePoints;
+   imagePointType point;
+   FILE *fp;
+
+   if ((fp = fopen(text_filename, "r")) == 0) {
+      return -1;
+   }
+   while (fscanf(fp, "%f %f", &point.u, &point.v) == 2) {
+      imagePoints.push_back(point);
+   }
+   fclose(fp);
+
+   if (!writeImageControlPointsBinary(binary_filename, (int) imagePoints.size(), imagePoints.empty() ? NULL : &imagePoints[0])) {
+      return -1;
+   }
+   return (int) imagePoints.size();
+}
+
+int convertWorldControlPointsText(const char *text_filename, const char *binary_filename) {
+   vector<worldPointType> worldPoints;
+   worldPointType point;
+   FILE *fp;
+
+   if ((fp = fopen(text_filename, "r")) == 0) {
+      return -1;
+   }
+   while (fscanf(fp, "%f %f %f", &point.x, &point.y, &point.z) == 3) {
+      worldPoints.push_back(point);
+   }
+   fclose(fp);
+
+   if (!writeWorldControlPointsBinary(binary_filename, (int) worldPoints.size(), worldPoints.empty() ? NULL : &worldPoints[0])) {
+      return -1;
+   }
+   return (int) worldPoints.size();
+}
+
+bool convertCameraModelText(const char *text_filename, const char *binary_filename) {
+   double cameraModel[3][4];
+   FILE *fp;
+   int i, j;
+
+   if ((fp = fopen(text_filename, "r")) == 0) {
+      return false;
+   }
+   for (i=0; i<3; i++) {
+      for (j=0; j<4; j++) {
+         if (fscanf(fp, "%lf", &cameraModel[i][j]) != 1) {
+            fclose(fp);
+            return false;
+         }
+      }
+   }
+   fclose(fp);
+
+   return writeCameraModelBinary(binary_filename, cameraModel);
+}
+
+
+/*
+ * binaryFilename
+ * Name of the binary file corresponding to a text file: the extension .txt is replaced by BINARY_FILE_EXTENSION
+ */
+
+void binaryFilename(const char *text_filename, char *binary_filename) {
+   const char *dot = strrchr(text_filename, '.');
+   const char *slash = strrchr(text_filename, '/');
+   size_t length = (dot != NULL && (slash == NULL || dot > slash)) ? (size_t) (dot - text_filename) : strlen(text_filename);
+
+   strncpy(binary_filename, text_filename, length);
+   binary_filename[length] = '\0';
+   strcat(binary_filename, BINARY_FILE_EXTENSION);
+}
+
+
+/*
+ * binaryFileIsCurrent
+ * True if the binary file exists and is at least as recent as the text file from which it was converted
+ */
+
+bool binaryFileIsCurrent(const char *text_filename, const char *binary_filename) {
+   struct stat text_stat, binary_stat;
+
+   if (stat(binary_filename, &binary_stat) != 0) return false;
+   if (stat(text_filename, &text_stat) != 0)     return true;   // no text file: the binary file is the only copy
+
+   return binary_stat.st_mtime >= text_stat.st_mtime;
+}
+
+
+
 /*=======================================================*/
 /* Utility functions to prompt user to continue          */ 
 /*=======================================================*/
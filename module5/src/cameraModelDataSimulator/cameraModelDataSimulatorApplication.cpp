@@ -38,6 +38,9 @@
   The fourth filename identifies the output .txt file where the 3D image control point coordinates are written.
   This file will be used by the cameraModel application.
 
+  An optional fifth filename identifies a file of checkerboard poses, one per line: x y z in millimetres and roll, pitch, 
+  and yaw in degrees.  If it is omitted, the checkerboard is placed under the camera, 20 millimetres higher for each view.
+
   Before running this application ensure that the calibration grid is not occluded by the robot. A
   program that moves the robot out of the field of view of the camera is provided as part of module5 of coro_examples
   repository (https://github.com/cognitive-robotics-course/coro_examples) and can be run by the command
@@ -83,6 +86,10 @@
   Abrham Gebreselasie
   13 March 2021
 
+  Automatic mode: all views are captured in one campaign without keypresses, fixed waits, or image files;
+  the corners of each view are detected in memory while the checkerboard is moved to the next pose
+  16 October 2026
+
 
 
 */
@@ -91,6 +98,7 @@
 
 Mat scene_image;
 int imageCount = 0;
+ros::Time scene_image_stamp;
 
 int main(int argc, char** argv) {
    #ifdef ROS
@@ -115,10 +123,13 @@ int main(int argc, char** argv) {
    int calibrationSuccess;
 
    bool debug = false;
+   bool automatic = true;   // capture all views without user interaction
    char configurationPathAndFilename[MAX_FILENAME_LENGTH];
    char controlPointsPathAndFilename[MAX_FILENAME_LENGTH];
    char worldPointsPathAndFilename[MAX_FILENAME_LENGTH];
    char filename[MAX_FILENAME_LENGTH];
+   char posesPathAndFilename[MAX_FILENAME_LENGTH];
+   vector<checkerboardPoseType> poses;
    int i;
    int numberOfViews;
    float cameraX, cameraY, cameraZ;
@@ -141,7 +152,8 @@ int main(int argc, char** argv) {
 
    ros::NodeHandle nh;
    image_transport::ImageTransport it(nh);
-   image_transport::Subscriber sub = it.subscribe("/lynxmotion_al5d/external_vision/image_raw", 1, &imageMessageReceived);
+   image_transport::Subscriber sub = it.subscribe("/lynxmotion_al5d/external_vision/image_raw", 1, 
+                                                  automatic ? &imageMessageReceivedInMemory : &imageMessageReceived);
 
 
    if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
@@ -217,6 +229,30 @@ int main(int argc, char** argv) {
                               printf("Error can't open input %s\n", worldPointsPathAndFilename);
                               prompt_and_exit(1);
                           }
+                          else if (automatic) {
+
+                              /* optional file of checkerboard poses */
+
+                              poses.clear();
+                              if (fscanf(fp_in, "%s", filename) != EOF) {
+                                  strcpy(posesPathAndFilename, data_dir);
+                                  strcat(posesPathAndFilename, filename);
+                                  if (readCheckerboardPoses(posesPathAndFilename, poses) == 0) {
+                                      printf("Error can't read checkerboard poses from %s\n", posesPathAndFilename);
+                                      prompt_and_exit(1);
+                                  }
+                              }
+                              else {
+                                  getDefaultCheckerboardPoses(numberOfViews, cameraX, cameraY, poses);
+                              }
+
+                              if (captureCheckerboardCampaign(checkerboard_sdf_filename, configurationPathAndFilename, poses,
+                                                              fp_control_points, fp_world_points) <= 0) {
+                                  prompt_and_exit(1);
+                              }
+                              fprintf(fp_control_points, "\n");
+                              fprintf(fp_world_points, "\n");
+                          }
                           else {
                               printf("Move the robot if necessary then press return to continue.\n");
                               getchar();
@@ -15,6 +15,9 @@
   Abrham Gebreselasie
   13 March 2021
 
+  Added captureCheckerboardCampaign and the functions it uses to capture all views automatically.
+  16 October 2026
+
 
 */
  
@@ -756,6 +759,309 @@ void getSimulatedWorldControlPoints(int numberOfCornersWidth, int numberOfCorner
    *numberOfControlPoints = numberOfViews * (numberOfCornersHeight * numberOfCornersWidth);
 }
 
+
+/*=======================================================*/
+/* Automated multi-pose capture campaign                 */ 
+/*=======================================================*/
+
+/*
+ * captureCheckerboardCampaign() places the checkerboard at each pose in turn and collects the control points for all
+ * the views in one pass, without keypresses, fixed waits, or image files:
+ *
+ * - the SDF file is read once and the spawn and delete services are called through one pair of persistent clients
+ * - after the board has been placed, the next image message stamped after the placement is used, so there is no
+ *   fixed delay; imageMessageReceivedInMemory() keeps the latest image in memory instead of writing it to disk
+ * - the corners are detected asynchronously on a worker thread while the board is moved to the next pose
+ * - the image and world control points of all views in which the corners were found are written at the end
+ *
+ * The world coordinates of the corners follow from the pose of the board: the corner offsets from the centre of the
+ * board (as in writeWorldCoordinatesToFile) are rotated by roll, pitch, and yaw and added to the board position.
+ */
+
+#define CAMPAIGN_IMAGE_TIMEOUT   5.0      // seconds to wait for a fresh image after placing the board
+#define CAMPAIGN_SERVICE_TIMEOUT 10.0     // seconds to wait for the Gazebo services
+
+extern ros::Time scene_image_stamp;
+
+struct campaignViewType {
+   bool            found;
+   vector<Point2f> corners;
+   double          detection_ms;
+};
+
+
+/*
+ * imageMessageReceivedInMemory
+ * Keep the latest simulator camera image and its time stamp; no image file is written
+ */
+
+void imageMessageReceivedInMemory(const sensor_msgs::ImageConstPtr& msg)
+{
+    cv_bridge::CvImagePtr cv_ptr;
+
+    try
+    {
+        cv_ptr = cv_bridge::toCvCopy(msg, sensor_msgs::image_encodings::BGR8);
+    }
+    catch (cv_bridge::Exception& e)
+    {
+        ROS_ERROR("cv_bridge exception: %s", e.what());
+        return;
+    }
+    scene_image       = cv_ptr->image;
+    scene_image_stamp = msg->header.stamp;
+    imageCount++;
+}
+
+
+/*
+ * getDefaultCheckerboardPoses
+ * One pose per view under the camera, 20 mm higher for each successive view, as in the interactive mode
+ */
+
+void getDefaultCheckerboardPoses(int numberOfViews, float cameraX, float cameraY, vector<checkerboardPoseType> &poses)
+{
+    checkerboardPoseType pose;
+
+    poses.clear();
+    for (int h = 0; h < numberOfViews; h++) {
+        pose.x = cameraX;
+        pose.y = cameraY;
+        pose.z = h * 20.0f;
+        pose.roll = pose.pitch = pose.yaw = 0;
+        poses.push_back(pose);
+    }
+}
+
+
+/*
+ * readCheckerboardPoses
+ * Read poses from a file, one per line: x y z (millimetres) roll pitch yaw (degrees); returns the number of poses
+ */
+
+int readCheckerboardPoses(const char *filename, vector<checkerboardPoseType> &poses)
+{
+    checkerboardPoseType pose;
+    FILE *fp;
+
+    poses.clear();
+    if ((fp = fopen(filename, "r")) == 0) {
+        return 0;
+    }
+    while (fscanf(fp, "%f %f %f %f %f %f", &pose.x, &pose.y, &pose.z, &pose.roll, &pose.pitch, &pose.yaw) == 6) {
+        poses.push_back(pose);
+    }
+    fclose(fp);
+    return (int) poses.size();
+}
+
+
+/*
+ * detect_checkerboard_corners
+ * Corner detection on an image held in memory; runs on a worker thread
+ */
+
+static campaignViewType detect_checkerboard_corners(Mat image, Size boardSize)
+{
+    campaignViewType view;
+    Mat grey;
+    int64 start_ticks = getTickCount();
+
+    cvtColor(image, grey, CV_BGR2GRAY);
+    view.found = findChessboardCorners(grey, boardSize, view.corners,
+                                       CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
+    if (view.found) {
+        cornerSubPix(grey, view.corners, Size(11,11), Size(-1,-1), TermCriteria(CV_TERMCRIT_EPS+CV_TERMCRIT_ITER, 30, 0.1));
+    }
+    view.detection_ms = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+    return view;
+}
+
+
+/*
+ * write_pose_world_coordinates
+ * World coordinates of the inner corners of a board at the given pose; the corners are ordered as in writeWorldCoordinatesToFile
+ */
+
+static void write_pose_world_coordinates(FILE *fp_world_points, const checkerboardPoseType &pose, float boxsize, Size size)
+{
+    float sizeX = (size.width  - 1) * boxsize;
+    float sizeY = (size.height - 1) * boxsize;
+    float dx, dy;
+    double cr = cos(pose.roll  * CV_PI / 180), sr = sin(pose.roll  * CV_PI / 180);
+    double cp = cos(pose.pitch * CV_PI / 180), sp = sin(pose.pitch * CV_PI / 180);
+    double cy = cos(pose.yaw   * CV_PI / 180), sy = sin(pose.yaw   * CV_PI / 180);
+
+    /* R = Rz(yaw) Ry(pitch) Rx(roll), the Gazebo convention; only the first two columns are needed for a planar board */
+
+    double r00 = cy * cp, r01 = cy * sp * sr - sy * cr;
+    double r10 = sy * cp, r11 = sy * sp * sr + cy * cr;
+    double r20 = -sp,     r21 = cp * sr;
+
+    for (int j = 0; j < size.height; j++) {
+        for (int i = 0; i < size.width; i++) {
+            dx = -sizeX / 2 + boxsize * i;
+            dy =  sizeY / 2 - boxsize * j;
+            fprintf(fp_world_points, "%3.4f %3.4f %3.4f\n", 
+                    pose.x + r00 * dx + r01 * dy, pose.y + r10 * dx + r11 * dy, pose.z + r20 * dx + r21 * dy);
+        }
+    }
+}
+
+
+/*
+ * wait_for_fresh_image
+ * Spin until an image stamped after the given time arrives; returns false on timeout
+ */
+
+static bool wait_for_fresh_image(ros::Time placed, int count_at_placement, Mat &image)
+{
+    ros::WallTime deadline = ros::WallTime::now() + ros::WallDuration(CAMPAIGN_IMAGE_TIMEOUT);
+
+    while (ros::ok() && ros::WallTime::now() < deadline) {
+        ros::spinOnce();
+
+        /* some camera plugins do not stamp their images: then skip the image that may have been rendered before the placement */
+
+        if (imageCount > count_at_placement &&
+            (scene_image_stamp > placed || (scene_image_stamp.isZero() && imageCount > count_at_placement + 1))) {
+            image = scene_image.clone();
+            return true;
+        }
+        ros::WallDuration(0.001).sleep();
+    }
+    return false;
+}
+
+
+/*
+ * captureCheckerboardCampaign
+ * Place the checkerboard at each pose, detect the corners, and write the image and world control points of all views
+ * Returns the number of views in which the corners were found, or -1 on error
+ */
+
+int captureCheckerboardCampaign(const char *sdf_filename, string configuration_filename, const vector<checkerboardPoseType> &poses,
+                                FILE *fp_image_points, FILE *fp_world_points)
+{
+    ros::NodeHandle nh;
+    Settings s;
+    FILE *fp_sdf;
+    size_t num_bytes;
+    string sdf_content;
+    vector<future<campaignViewType> > detections;
+    vector<campaignViewType> views;
+    vector<double> capture_ms;
+    gazebo_msgs::SpawnModel spawn_srv;
+    gazebo_msgs::DeleteModel delete_srv;
+    ros::Time placed;
+    Mat image;
+    int64 start_ticks, view_ticks;
+    int numberOfViewsFound = 0;
+    bool spawned = false;
+    size_t k;
+
+    FileStorage fs(configuration_filename, FileStorage::READ);
+    if (!fs.isOpened()) {
+        cout << "Could not open the configuration file: \"" << configuration_filename << "\"" << endl;
+        return -1;
+    }
+    fs["Settings"] >> s;
+    fs.release();
+
+    /* read the SDF once */
+
+    if ((fp_sdf = fopen(sdf_filename, "r")) == NULL) {
+        printf("Could not open %s\n", sdf_filename);
+        return -1;
+    }
+    num_bytes = fsize(fp_sdf);
+    sdf_content.resize(num_bytes);
+    if (num_bytes > 0 && fread(&sdf_content[0], 1, num_bytes, fp_sdf) != num_bytes) {
+        printf("Could not read %s\n", sdf_filename);
+        fclose(fp_sdf);
+        return -1;
+    }
+    fclose(fp_sdf);
+
+    /* one pair of persistent service clients for the whole campaign */
+
+    if (!ros::service::waitForService("/gazebo/spawn_sdf_model", ros::Duration(CAMPAIGN_SERVICE_TIMEOUT)) ||
+        !ros::service::waitForService("/gazebo/delete_model",    ros::Duration(CAMPAIGN_SERVICE_TIMEOUT))) {
+        printf("The Gazebo spawn and delete services are not available\n");
+        return -1;
+    }
+    ros::ServiceClient spawn_client  = nh.serviceClient<gazebo_msgs::SpawnModel>("/gazebo/spawn_sdf_model", true);
+    ros::ServiceClient delete_client = nh.serviceClient<gazebo_msgs::DeleteModel>("/gazebo/delete_model", true);
+
+    spawn_srv.request.model_name  = CHECKERBOARD_MODEL_NAME;
+    spawn_srv.request.model_xml   = sdf_content;
+    delete_srv.request.model_name = CHECKERBOARD_MODEL_NAME;
+
+    start_ticks = getTickCount();
+
+    for (k = 0; k < poses.size(); k++) {
+        view_ticks = getTickCount();
+
+        if (spawned) {
+            delete_client.call(delete_srv);
+        }
+
+        spawn_srv.request.initial_pose.position.x = poses[k].x / 1000;   // SDF poses are in metres
+        spawn_srv.request.initial_pose.position.y = poses[k].y / 1000;
+        spawn_srv.request.initial_pose.position.z = poses[k].z / 1000;
+        spawn_srv.request.initial_pose.orientation = 
+           tf::createQuaternionMsgFromRollPitchYaw(poses[k].roll * CV_PI / 180, poses[k].pitch * CV_PI / 180, poses[k].yaw * CV_PI / 180);
+
+        if (!spawn_client.call(spawn_srv) || !spawn_srv.response.success) {
+            printf("View %2d: could not place the checkerboard\n", (int) k + 1);
+            return -1;
+        }
+        spawned = true;
+        placed = ros::Time::now();
+
+        if (!wait_for_fresh_image(placed, imageCount, image)) {
+            printf("View %2d: no image received\n", (int) k + 1);
+            delete_client.call(delete_srv);
+            return -1;
+        }
+        capture_ms.push_back((getTickCount() - view_ticks) * 1000.0 / getTickFrequency());
+
+        /* detect the corners while the board is moved to the next pose */
+
+        detections.push_back(async(launch::async, detect_checkerboard_corners, image, s.boardSize));
+    }
+
+    if (spawned) {
+        delete_client.call(delete_srv);
+    }
+
+    for (k = 0; k < detections.size(); k++) {
+        views.push_back(detections[k].get());
+    }
+
+    /* write the control points of all views in one pass */
+
+    for (k = 0; k < views.size(); k++) {
+        printf("View %2d at (%6.1f, %6.1f, %6.1f) mm: %s  capture %7.1f ms  detection %7.1f ms\n", (int) k + 1, 
+               poses[k].x, poses[k].y, poses[k].z, views[k].found ? "corners found    " : "corners not found", 
+               capture_ms[k], views[k].detection_ms);
+
+        if (!views[k].found) continue;
+
+        for (size_t i = 0; i < views[k].corners.size(); i++) {
+            fprintf(fp_image_points, "%.3f %.3f\n", views[k].corners[i].x, views[k].corners[i].y);
+        }
+        write_pose_world_coordinates(fp_world_points, poses[k], s.squareSize, s.boardSize);
+        numberOfViewsFound++;
+    }
+
+    printf("%d of %d views captured in %.1f ms\n", numberOfViewsFound, (int) poses.size(), 
+           (getTickCount() - start_ticks) * 1000.0 / getTickFrequency());
+
+    return numberOfViewsFound;
+}
+
+
 /*=======================================================*/
 /* Utility functions to prompt user to continue          */ 
 /*=======================================================*/
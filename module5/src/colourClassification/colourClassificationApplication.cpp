@@ -0,0 +1,250 @@
+/* 
+  Example use of openCV to classify the colours of an image with a trained look-up table
+  --------------------------------------------------------------------------------------
+  
+  This application reads the parameters of the classifier from an input file colourClassificationInput.txt:
+
+  - the filename of the look-up table file
+  - the number of bits per channel of the quantised BGR colour (4, 5, or 6: a 16^3, 32^3, or 64^3 table)
+  - the number of classes, followed by the name of each class; class 0 is the background
+  - the minimum number of training samples for a cell of the table to be assigned a class
+  - the number of cells by which the classes are grown into the untrained cells of the table
+
+  These are followed by a sequence of lines, each beginning with a keyword:
+
+  - mask <image> <mask image> <class>  trains the class with the pixels of the image where the mask image is not zero
+  - click <image>                      trains the classes with points selected interactively in the image
+  - classify <image>                   classifies the image
+
+  The table is compiled from the training samples and written to the look-up table file before the first image is
+  classified.  If there are no training lines, the table is read from the look-up table file instead.
+  Each image is classified into all the classes in a single pass, with and without SIMD, and the label image is displayed.
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/colourClassification.h"
+
+#define BENCHMARK_REPETITIONS 20
+
+int main() {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "colourClassificationInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+   char lut_filename[MAX_FILENAME_LENGTH];
+   char keyword[MAX_STRING_LENGTH];
+   char filename[MAX_FILENAME_LENGTH];
+   char mask_filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   bool trained = false;
+   bool compiled = false;
+   int bits;
+   int number_of_classes;
+   int min_samples;
+   int fill_radius;
+   int class_id;
+   int c, i, n;
+   double ticks;
+   double scalar_time;
+   double simd_time;
+
+   FILE *fp_in;
+
+   colourClassifierType classifier;
+   colourTrainingDataType training;
+   Mat image, mask, labels, simd_labels, label_image;
+
+   const char* input_window_name = "Input Image";
+   const char* label_window_name = "Classified Image";
+   
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input colourClassificationInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Example of how to use openCV to classify the colours of an image with a trained look-up table.\n\n");
+
+   end_of_file = fscanf(fp_in, "%s %d %d", lut_filename, &bits, &number_of_classes);
+
+   if (end_of_file != 3 || bits < MIN_LUT_BITS || bits > MAX_LUT_BITS || number_of_classes < 2 || number_of_classes > MAX_NUMBER_OF_CLASSES) {
+      printf("Error can't read the look-up table filename, bits, and number of classes from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   memset(classifier.names, 0, sizeof(classifier.names));
+   for (c = 0; c < number_of_classes; c++) {
+      if (fscanf(fp_in, "%19s", classifier.names[c]) != 1) {
+         printf("Error can't read the name of class %d from %s\n", c, input_filename);
+         prompt_and_exit(1);
+      }
+   }
+   classifier.number_of_classes = number_of_classes;
+
+   if (fscanf(fp_in, "%d %d", &min_samples, &fill_radius) != 2) {
+      printf("Error can't read the minimum number of samples and the fill radius from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   if (debug) printf("%s, %d bits per channel, %d classes, at least %d samples per cell, fill radius %d\n\n",
+                     lut_filename, bits, number_of_classes, min_samples, fill_radius);
+
+   initialiseTrainingData(&training, bits, number_of_classes);
+
+   strcpy(file_path_and_filename, data_dir);
+   strcat(file_path_and_filename, lut_filename);
+   strcpy(lut_filename, file_path_and_filename);
+
+   do {
+      end_of_file = fscanf(fp_in, "%s %s", keyword, filename);
+
+      if (end_of_file == 2) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         image = imread(file_path_and_filename, CV_LOAD_IMAGE_COLOR);
+         if (image.empty()) {
+            cout << "can not open " << file_path_and_filename << endl;
+            prompt_and_exit(-1);
+         }
+
+         if (strcmp(keyword, "mask") == 0) {
+
+            /* train with a mask image */
+
+            if (fscanf(fp_in, "%s %d", mask_filename, &class_id) != 2 || class_id < 0 || class_id >= number_of_classes) {
+               printf("Error can't read the mask image and class for %s\n", filename);
+               prompt_and_exit(1);
+            }
+
+            strcpy(file_path_and_filename, data_dir);
+            strcat(file_path_and_filename, mask_filename);
+
+            mask = imread(file_path_and_filename, CV_LOAD_IMAGE_GRAYSCALE);
+            if (mask.empty() || mask.size() != image.size()) {
+               cout << "can not open " << file_path_and_filename << " or it is not the size of " << filename << endl;
+               prompt_and_exit(-1);
+            }
+
+            n = addTrainingMask(image, mask, class_id, &training);
+            printf("%s: %d samples of %s\n", filename, n, classifier.names[class_id]);
+            trained = true;
+         }
+         else if (strcmp(keyword, "click") == 0) {
+
+            /* train interactively */
+
+            printf("%s\n", filename);
+            trainFromClicks(image, &classifier, &training);
+            trained = true;
+         }
+         else if (strcmp(keyword, "classify") == 0) {
+
+            /* compile or read the table before the first image is classified */
+
+            if (!compiled) {
+               if (trained) {
+                  ticks = (double) getTickCount();
+                  compileColourLUT(&training, min_samples, fill_radius, &classifier);
+                  printf("Compiled a %d x %d x %d look-up table in %.1f ms\n", 1 << bits, 1 << bits, 1 << bits,
+                         ((double) getTickCount() - ticks) * 1000 / getTickFrequency());
+
+                  if (!writeColourLUT(lut_filename, &classifier)) {
+                     printf("Error can't write %s\n", lut_filename);
+                     prompt_and_exit(1);
+                  }
+               }
+               else if (!readColourLUT(lut_filename, &classifier)) {
+                  printf("Error there are no training samples and %s can't be read\n", lut_filename);
+                  prompt_and_exit(1);
+               }
+               compiled = true;
+            }
+
+            /* classify, timing the scalar and SIMD versions */
+
+            ticks = (double) getTickCount();
+            for (i = 0; i < BENCHMARK_REPETITIONS; i++) {
+               classifyColours(image, &classifier, labels, false);
+            }
+            scalar_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / BENCHMARK_REPETITIONS;
+
+            ticks = (double) getTickCount();
+            for (i = 0; i < BENCHMARK_REPETITIONS; i++) {
+               classifyColours(image, &classifier, simd_labels, true);
+            }
+            simd_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / BENCHMARK_REPETITIONS;
+
+            printf("%s: %d x %d, %.3f ms scalar, %.3f ms SIMD%s\n", filename, image.cols, image.rows, scalar_time, simd_time,
+                   countNonZero(labels != simd_labels) == 0 ? "" : " (the label images differ)");
+
+            for (c = 0; c < classifier.number_of_classes; c++) {
+               printf("   %-12s %5.1f%%\n", classifier.names[c], 100.0 * countNonZero(labels == c) / labels.total());
+            }
+
+            labelsToColourImage(labels, &classifier, label_image);
+
+            namedWindow(input_window_name, CV_WINDOW_AUTOSIZE);
+            namedWindow(label_window_name, CV_WINDOW_AUTOSIZE);
+            imshow(input_window_name, image);
+            imshow(label_window_name, label_image);
+
+            printf("Press any key to continue ...\n");
+            do {
+               waitKey(30);
+            } while (!_kbhit());
+
+            getchar(); // flush the buffer from the keyboard hit
+
+            destroyWindow(input_window_name);
+            destroyWindow(label_window_name);
+         }
+         else {
+            printf("Error unknown keyword %s in %s\n", keyword, input_filename);
+            prompt_and_exit(1);
+         }
+      }
+   } while (end_of_file == 2);
+
+   fclose(fp_in);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
@@ -0,0 +1,471 @@
+/* 
+  Example use of openCV to classify the colours of an image with a trained look-up table
+  --------------------------------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/colourClassification.h"
+
+
+/*=======================================================*/
+/* Training                                              */
+/*=======================================================*/
+
+/*
+ * lutIndex
+ * Cell of the look-up table of a BGR colour quantised to bits per channel
+ */
+
+static inline int lutIndex(const uchar *bgr, int bits) {
+   int shift = 8 - bits;
+
+   return ((bgr[0] >> shift) << (2 * bits)) | ((bgr[1] >> shift) << bits) | (bgr[2] >> shift);
+}
+
+
+/*
+ * initialiseTrainingData
+ */
+
+void initialiseTrainingData(colourTrainingDataType *training, int bits, int number_of_classes) {
+
+   training->bits              = bits;
+   training->number_of_classes = number_of_classes;
+   training->counts.assign((size_t) number_of_classes << (3 * bits), 0);
+   memset(training->sums, 0, sizeof(training->sums));
+}
+
+
+/*
+ * addTrainingMask
+ * Train a class with the pixels of a BGR image where the mask is not zero; returns the number of samples
+ */
+
+int addTrainingMask(const Mat &bgr_image, const Mat &mask, int class_id, colourTrainingDataType *training) {
+
+   unsigned int *counts = &training->counts[(size_t) class_id << (3 * training->bits)];
+   const uchar *bgr, *m;
+   int row, col;
+   int number_of_samples = 0;
+
+   CV_Assert(bgr_image.type() == CV_8UC3 && mask.type() == CV_8UC1 && bgr_image.size() == mask.size());
+
+   for (row = 0; row < bgr_image.rows; row++) {
+      bgr = bgr_image.ptr<uchar>(row);
+      m   = mask.ptr<uchar>(row);
+
+      for (col = 0; col < bgr_image.cols; col++, bgr += 3) {
+         if (m[col] != 0) {
+            counts[lutIndex(bgr, training->bits)]++;
+            training->sums[class_id][0] += bgr[0];
+            training->sums[class_id][1] += bgr[1];
+            training->sums[class_id][2] += bgr[2];
+            number_of_samples++;
+         }
+      }
+   }
+   return number_of_samples;
+}
+
+
+/*
+ * addTrainingClick
+ * Train a class with the pixels around a point selected in a BGR image; returns the number of samples
+ */
+
+int addTrainingClick(const Mat &bgr_image, Point click, int class_id, colourTrainingDataType *training) {
+
+   Mat mask = Mat::zeros(bgr_image.size(), CV_8U);
+
+   rectangle(mask, Point(click.x - SAMPLE_RADIUS, click.y - SAMPLE_RADIUS), Point(click.x + SAMPLE_RADIUS, click.y + SAMPLE_RADIUS),
+             Scalar(255), CV_FILLED);
+
+   return addTrainingMask(bgr_image, mask, class_id, training);
+}
+
+
+/*
+ * compileColourLUT
+ * Assign each cell of the look-up table the class with the most samples in it, if it has at least min_samples.
+ * Cells without enough samples take the majority class of their trained neighbours, growing the classes by up to
+ * fill_radius cells so that colours close to the training samples are classified too; the remaining cells are background.
+ */
+
+void compileColourLUT(colourTrainingDataType *training, int min_samples, int fill_radius, colourClassifierType *classifier) {
+
+   const int offsets[3] = {1, 1 << training->bits, 1 << (2 * training->bits)};   // r, g, b strides
+   const int levels = 1 << training->bits;
+   int cells = 1 << (3 * training->bits);
+   int cell, c, best, neighbour, channel, iteration, coordinate;
+   unsigned int count, best_count;
+   int votes[MAX_NUMBER_OF_CLASSES];
+   vector<uchar> previous;
+   double n;
+
+   classifier->bits              = training->bits;
+   classifier->number_of_classes = training->number_of_classes;
+   classifier->lut.assign(cells, UNASSIGNED);
+
+   /* trained cells */
+
+   for (cell = 0; cell < cells; cell++) {
+      best       = UNASSIGNED;
+      best_count = 0;
+      for (c = 0; c < training->number_of_classes; c++) {
+         count = training->counts[((size_t) c << (3 * training->bits)) + cell];
+         if (count > best_count) {
+            best       = c;
+            best_count = count;
+         }
+      }
+      if (best_count >= (unsigned int) min_samples) {
+         classifier->lut[cell] = (uchar) best;
+      }
+   }
+
+   /* grow the classes into the untrained cells, one layer of cells at a time */
+
+   for (iteration = 0; iteration < fill_radius; iteration++) {
+      previous = classifier->lut;
+
+      for (cell = 0; cell < cells; cell++) {
+         if (previous[cell] != UNASSIGNED) continue;
+
+         memset(votes, 0, sizeof(votes));
+         for (channel = 0; channel < 3; channel++) {
+            coordinate = (cell / offsets[channel]) % levels;
+            if (coordinate > 0) {
+               neighbour = previous[cell - offsets[channel]];
+               if (neighbour != UNASSIGNED) votes[neighbour]++;
+            }
+            if (coordinate < levels - 1) {
+               neighbour = previous[cell + offsets[channel]];
+               if (neighbour != UNASSIGNED) votes[neighbour]++;
+            }
+         }
+
+         best = UNASSIGNED;
+         for (c = 0; c < training->number_of_classes; c++) {
+            if (votes[c] > 0 && (best == UNASSIGNED || votes[c] > votes[best])) best = c;
+         }
+         classifier->lut[cell] = (uchar) best;
+      }
+   }
+
+   for (cell = 0; cell < cells; cell++) {
+      if (classifier->lut[cell] == UNASSIGNED) classifier->lut[cell] = BACKGROUND;
+   }
+
+   /* display colours */
+
+   for (c = 0; c < training->number_of_classes; c++) {
+      n = 0;
+      for (cell = 0; cell < cells; cell++) {
+         n += training->counts[((size_t) c << (3 * training->bits)) + cell];
+      }
+      if (c == BACKGROUND || n == 0) {
+         classifier->display_colours[c] = Vec3b(0, 0, 0);
+      }
+      else {
+         classifier->display_colours[c] = Vec3b(saturate_cast<uchar>(training->sums[c][0] / n),
+                                                saturate_cast<uchar>(training->sums[c][1] / n),
+                                                saturate_cast<uchar>(training->sums[c][2] / n));
+      }
+   }
+}
+
+
+/*=======================================================*/
+/* Classification                                        */
+/*=======================================================*/
+
+/*
+ * classifyColours
+ * Label image with the class of every pixel of a BGR image, all classes in a single pass with one table look-up per pixel.
+ *
+ * With use_simd, the table indices of sixteen pixels at a time are computed with the openCV universal intrinsics
+ * (SSE2 or NEON) when the indices fit in 16 bits, i.e. for up to 32 levels per channel; the look-ups themselves are
+ * scalar, as neither has a byte gather, but the 32 KB table stays in the L1 cache.
+ */
+
+void classifyColours(const Mat &bgr_image, const colourClassifierType *classifier, Mat &labels, bool use_simd) {
+
+   const uchar *lut = &classifier->lut[0];
+   const uchar *bgr;
+   uchar *label;
+   int bits = classifier->bits;
+   int row, col, k;
+
+   CV_Assert(bgr_image.type() == CV_8UC3);
+
+   labels.create(bgr_image.size(), CV_8U);
+
+   for (row = 0; row < bgr_image.rows; row++) {
+      bgr   = bgr_image.ptr<uchar>(row);
+      label = labels.ptr<uchar>(row);
+      col   = 0;
+
+#if CV_SIMD128
+      if (use_simd && bits <= 5) {
+         int shift = 8 - bits;
+         ushort CV_DECL_ALIGNED(16) indices[16];
+         v_uint8x16 b, g, r;
+         v_uint16x8 b0, b1, g0, g1, r0, r1;
+
+         for ( ; col <= bgr_image.cols - 16; col += 16) {
+            v_load_deinterleave(bgr + 3 * col, b, g, r);
+            v_expand(b, b0, b1);
+            v_expand(g, g0, g1);
+            v_expand(r, r0, r1);
+
+            v_store_aligned(indices,     ((b0 >> shift) << (2 * bits)) | ((g0 >> shift) << bits) | (r0 >> shift));
+            v_store_aligned(indices + 8, ((b1 >> shift) << (2 * bits)) | ((g1 >> shift) << bits) | (r1 >> shift));
+
+            for (k = 0; k < 16; k++) {
+               label[col + k] = lut[indices[k]];
+            }
+         }
+      }
+#endif
+
+      for ( ; col < bgr_image.cols; col++) {
+         label[col] = lut[lutIndex(bgr + 3 * col, bits)];
+      }
+   }
+}
+
+
+/*
+ * labelsToColourImage
+ * Paint each pixel with the display colour of its class
+ */
+
+void labelsToColourImage(const Mat &labels, const colourClassifierType *classifier, Mat &colour_image) {
+
+   Mat lut(1, 256, CV_8UC3, Scalar(0, 0, 0));
+   Mat labels_bgr;
+   int c;
+
+   for (c = 0; c < classifier->number_of_classes; c++) {
+      lut.at<Vec3b>(c) = classifier->display_colours[c];
+   }
+
+   cvtColor(labels, labels_bgr, CV_GRAY2BGR);
+   LUT(labels_bgr, lut, colour_image);
+}
+
+
+/*=======================================================*/
+/* Look-up table files                                   */
+/*=======================================================*/
+
+/*
+ * A look-up table file has a colourLUTHeaderType header followed by the class names (CLASS_NAME_LENGTH characters
+ * each), the display colours (three bytes each, BGR), and the 2^(3 bits) class numbers of the table.
+ */
+
+static unsigned int colour_lut_checksum(const colourClassifierType *classifier) {
+   unsigned int hash;
+
+   hash = fnv1a_checksum((const unsigned char *) classifier->names, (size_t) classifier->number_of_classes * CLASS_NAME_LENGTH);
+   hash = fnv1a_checksum((const unsigned char *) classifier->display_colours, (size_t) classifier->number_of_classes * 3, hash);
+   hash = fnv1a_checksum(&classifier->lut[0], classifier->lut.size(), hash);
+   return hash;
+}
+
+
+/*
+ * writeColourLUT
+ * Returns false if the file can't be written
+ */
+
+bool writeColourLUT(const char *filename, const colourClassifierType *classifier) {
+
+   colourLUTHeaderType header;
+   FILE *fp;
+   bool ok;
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, COLOUR_LUT_MAGIC, 4);
+   header.version           = COLOUR_LUT_VERSION;
+   header.bits              = classifier->bits;
+   header.number_of_classes = classifier->number_of_classes;
+   header.checksum          = colour_lut_checksum(classifier);
+
+   if ((fp = fopen(filename, "wb")) == 0) {
+      return false;
+   }
+   ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+        fwrite(classifier->names, CLASS_NAME_LENGTH, classifier->number_of_classes, fp) == (size_t) classifier->number_of_classes &&
+        fwrite(classifier->display_colours, 3, classifier->number_of_classes, fp) == (size_t) classifier->number_of_classes &&
+        fwrite(&classifier->lut[0], classifier->lut.size(), 1, fp) == 1;
+   fclose(fp);
+   return ok;
+}
+
+
+/*
+ * readColourLUT
+ * Returns false if the file is missing or invalid
+ */
+
+bool readColourLUT(const char *filename, colourClassifierType *classifier) {
+
+   colourLUTHeaderType header;
+   FILE *fp;
+   bool ok;
+
+   if ((fp = fopen(filename, "rb")) == 0) {
+      return false;
+   }
+
+   ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+        memcmp(header.magic, COLOUR_LUT_MAGIC, 4) == 0 &&
+        header.version == COLOUR_LUT_VERSION &&
+        header.bits >= MIN_LUT_BITS && header.bits <= MAX_LUT_BITS &&
+        header.number_of_classes >= 1 && header.number_of_classes <= MAX_NUMBER_OF_CLASSES;
+
+   if (ok) {
+      classifier->bits              = header.bits;
+      classifier->number_of_classes = header.number_of_classes;
+      classifier->lut.resize((size_t) 1 << (3 * header.bits));
+
+      ok = fread(classifier->names, CLASS_NAME_LENGTH, header.number_of_classes, fp) == header.number_of_classes &&
+           fread(classifier->display_colours, 3, header.number_of_classes, fp) == header.number_of_classes &&
+           fread(&classifier->lut[0], classifier->lut.size(), 1, fp) == 1 &&
+           colour_lut_checksum(classifier) == header.checksum;
+   }
+   fclose(fp);
+   return ok;
+}
+
+
+/*=======================================================*/
+/* Interactive training                                  */
+/*=======================================================*/
+
+struct clickTrainingType {
+   Mat bgr_image;
+   Mat display_image;
+   int class_id;
+   const colourClassifierType *classifier;
+   colourTrainingDataType *training;
+};
+
+static const char *training_window_name = "Training Image";
+
+static void trainingClick(int event, int x, int y, int, void *data) {
+
+   clickTrainingType *session = (clickTrainingType *) data;
+   int n;
+
+   if (event == EVENT_LBUTTONDOWN) {
+      n = addTrainingClick(session->bgr_image, Point(x, y), session->class_id, session->training);
+      printf("%s: %d samples at (%d, %d)\n", session->classifier->names[session->class_id], n, x, y);
+
+      circle(session->display_image, Point(x, y), SAMPLE_RADIUS + 1, Scalar(255, 255, 255), 1);
+      imshow(training_window_name, session->display_image);
+   }
+}
+
+
+/*
+ * trainFromClicks
+ * Train the classes with points selected with the mouse: a hexadecimal digit key (0-9, a-f) selects the class, a click
+ * adds the pixels around it, and any other key finishes the image
+ */
+
+void trainFromClicks(const Mat &bgr_image, colourClassifierType *classifier, colourTrainingDataType *training) {
+
+   static const char class_keys[] = "0123456789abcdef";    // one key for each of the MAX_NUMBER_OF_CLASSES classes
+
+   clickTrainingType session;
+   const char *class_key;
+   int key, c;
+
+   session.bgr_image     = bgr_image;
+   session.display_image = bgr_image.clone();
+   session.class_id      = 1 < classifier->number_of_classes ? 1 : BACKGROUND;
+   session.classifier    = classifier;
+   session.training      = training;
+
+   for (c = 0; c < classifier->number_of_classes; c++) {
+      printf("   %c: %s\n", class_keys[c], classifier->names[c]);
+   }
+   printf("Press a class key in the image window to select a class, click on the image to add samples of that class,\n");
+   printf("and press any other key when finished with this image.\n");
+   printf("Class %s\n", classifier->names[session.class_id]);
+
+   namedWindow(training_window_name, CV_WINDOW_AUTOSIZE);
+   setMouseCallback(training_window_name, trainingClick, &session);
+   imshow(training_window_name, session.display_image);
+
+   do {
+      key = waitKey(30);
+      class_key = key > 0 && key < 256 ? strchr(class_keys, key) : NULL;
+      if (class_key != NULL && class_key - class_keys < classifier->number_of_classes) {
+         session.class_id = (int) (class_key - class_keys);
+         printf("Class %s\n", classifier->names[session.class_id]);
+         key = -1;
+      }
+   } while (key < 0);
+
+   destroyWindow(training_window_name);
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
@@ -0,0 +1,179 @@
+/* 
+  Example use of openCV to reduce the number of colours in an image
+  -----------------------------------------------------------------
+  
+  This application reads two parameters from an input file colourQuantisationInput.txt:
+
+  - the number of bits per channel to which the images are reduced by uniform quantisation
+  - the number of colours in the palette to which the images are reduced by palette quantisation
+
+  These are followed by a sequence of lines, each containing the filename of an image to be processed.
+
+  Uniform quantisation masks off the low bits of each channel, with pointer access, SIMD, and a thread per block of rows.
+  Palette quantisation computes a palette of the image by mini-batch k-means and replaces each pixel by the nearest
+  palette colour, found with a look-up table.  Each is timed against a version that accesses each pixel with at<>(),
+  and the mean squared error of both quantised images is reported.
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/colourQuantisation.h"
+
+#define BENCHMARK_REPETITIONS 10
+
+int main() {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "colourQuantisationInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   int bits;
+   int palette_size;
+   int i;
+   double ticks;
+   double pointer_time, at_time;
+   double palette_time;
+
+   FILE *fp_in;
+
+   paletteType palette;
+   Mat image, reduced_image, reference_image, palette_image, indices;
+
+   const char* input_window_name   = "Input Image";
+   const char* reduced_window_name = "Uniform Quantisation";
+   const char* palette_window_name = "Palette Quantisation";
+   
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input colourQuantisationInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Example of how to use openCV to reduce the number of colours in an image.\n\n");
+
+   end_of_file = fscanf(fp_in, "%d %d", &bits, &palette_size);
+
+   if (end_of_file != 2 || bits < 1 || bits > 8 || palette_size < 1 || palette_size > MAX_PALETTE_SIZE) {
+      printf("Error can't read the number of bits and the palette size from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   if (debug) printf("%d bits per channel, %d colour palette, %d threads\n\n", bits, palette_size, getNumThreads());
+
+   do {
+      end_of_file = fscanf(fp_in, "%s", filename);
+
+      if (end_of_file != EOF) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         image = imread(file_path_and_filename, CV_LOAD_IMAGE_COLOR);
+         if (image.empty()) {
+            cout << "can not open " << file_path_and_filename << endl;
+            prompt_and_exit(-1);
+         }
+
+         printf("%s: %d x %d\n", filename, image.cols, image.rows);
+
+         /* uniform quantisation */
+
+         ticks = (double) getTickCount();
+         for (i = 0; i < BENCHMARK_REPETITIONS; i++) {
+            changeQuantisationAt(image, reference_image, bits);
+         }
+         at_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / BENCHMARK_REPETITIONS;
+
+         ticks = (double) getTickCount();
+         for (i = 0; i < BENCHMARK_REPETITIONS; i++) {
+            changeQuantisation(image, reduced_image, bits);
+         }
+         pointer_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / BENCHMARK_REPETITIONS;
+
+         printf("   uniform, %d bits:    %8.3f ms at<>(), %8.3f ms pointers (x%.1f)%s, MSE %.1f\n",
+                bits, at_time, pointer_time, at_time / pointer_time,
+                norm(reduced_image, reference_image, NORM_INF) == 0 ? "" : " (the images differ)",
+                meanSquaredError(image, reduced_image));
+
+         /* palette quantisation */
+
+         ticks = (double) getTickCount();
+         computePalette(image, palette_size, &palette);
+         palette_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+         ticks = (double) getTickCount();
+         quantiseToPaletteAt(image, &palette, reference_image);
+         at_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency();
+
+         ticks = (double) getTickCount();
+         for (i = 0; i < BENCHMARK_REPETITIONS; i++) {
+            quantiseToPalette(image, &palette, palette_image, indices);
+         }
+         pointer_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / BENCHMARK_REPETITIONS;
+
+         printf("   palette, %d colours: %8.3f ms at<>() search, %8.3f ms look-up table (x%.1f), MSE %.1f (search %.1f)\n",
+                (int) palette.colours.size(), at_time, pointer_time, at_time / pointer_time,
+                meanSquaredError(image, palette_image), meanSquaredError(image, reference_image));
+         printf("   palette computed in %.1f ms\n\n", palette_time);
+
+         namedWindow(input_window_name,   CV_WINDOW_AUTOSIZE);
+         namedWindow(reduced_window_name, CV_WINDOW_AUTOSIZE);
+         namedWindow(palette_window_name, CV_WINDOW_AUTOSIZE);
+         imshow(input_window_name,   image);
+         imshow(reduced_window_name, reduced_image);
+         imshow(palette_window_name, palette_image);
+
+         printf("Press any key to continue ...\n");
+         do {
+            waitKey(30);
+         } while (!_kbhit());
+
+         getchar(); // flush the buffer from the keyboard hit
+
+         destroyWindow(input_window_name);
+         destroyWindow(reduced_window_name);
+         destroyWindow(palette_window_name);
+      }
+   } while (end_of_file != EOF);
+
+   fclose(fp_in);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
@@ -0,0 +1,368 @@
+/* 
+  Example use of openCV to reduce the number of colours in an image
+  -----------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/colourQuantisation.h"
+
+
+/*=======================================================*/
+/* Uniform quantisation                                  */
+/*=======================================================*/
+
+/*
+ * Parallel body for changeQuantisation: each row is independent.
+ * The low bits of each value are masked off and the value is moved to the centre of its quantisation interval,
+ * sixteen values at a time with the openCV universal intrinsics (SSE2 or NEON).
+ */
+
+class QuantisationBody : public ParallelLoopBody {
+public:
+   QuantisationBody(const Mat &image, Mat &quantised_image, int bits) : image_(image), quantised_image_(quantised_image) {
+      mask_   = (uchar) (0xFF << (8 - bits));
+      offset_ = (uchar) (bits < 8 ? 1 << (7 - bits) : 0);
+   }
+
+   virtual void operator()(const Range &range) const {
+      int row, i;
+      int length = image_.cols * image_.channels();
+
+      for (row = range.start; row < range.end; row++) {
+         const uchar *in  = image_.ptr<uchar>(row);
+         uchar       *out = quantised_image_.ptr<uchar>(row);
+         i = 0;
+
+#if CV_SIMD128
+         v_uint8x16 mask   = v_setall_u8(mask_);
+         v_uint8x16 offset = v_setall_u8(offset_);
+
+         for ( ; i <= length - 16; i += 16) {
+            v_store(out + i, (v_load(in + i) & mask) | offset);
+         }
+#endif
+
+         for ( ; i < length; i++) {
+            out[i] = (uchar) ((in[i] & mask_) | offset_);
+         }
+      }
+   }
+
+private:
+   const Mat &image_;
+   Mat       &quantised_image_;
+   uchar      mask_;
+   uchar      offset_;
+};
+
+
+/*
+ * changeQuantisation
+ * Reduce an 8-bit image with any number of channels to bits per channel, accessing the pixels with pointers
+ */
+
+void changeQuantisation(const Mat &image, Mat &quantised_image, int bits) {
+
+   CV_Assert(image.depth() == CV_8U && bits >= 1 && bits <= 8);
+
+   quantised_image.create(image.size(), image.type());
+   parallel_for_(Range(0, image.rows), QuantisationBody(image, quantised_image, bits));
+}
+
+
+/*
+ * changeQuantisationAt
+ * The same as changeQuantisation() for a colour image, accessing each pixel with at<>(): used as a reference
+ */
+
+void changeQuantisationAt(const Mat &image, Mat &quantised_image, int bits) {
+
+   uchar mask   = (uchar) (0xFF << (8 - bits));
+   uchar offset = (uchar) (bits < 8 ? 1 << (7 - bits) : 0);
+   int row, col, channel;
+
+   CV_Assert(image.type() == CV_8UC3 && bits >= 1 && bits <= 8);
+
+   quantised_image.create(image.size(), image.type());
+
+   for (row=0; row < image.rows; row++) {
+      for (col=0; col < image.cols; col++) {
+         for (channel=0; channel < 3; channel++) {
+            quantised_image.at<Vec3b>(row,col)[channel] = (uchar) ((image.at<Vec3b>(row,col)[channel] & mask) | offset);
+         }
+      }
+   }
+}
+
+
+/*=======================================================*/
+/* Palette quantisation                                  */
+/*=======================================================*/
+
+static inline float squaredDistance(const float *centre, const uchar *bgr) {
+   float db = centre[0] - bgr[0];
+   float dg = centre[1] - bgr[1];
+   float dr = centre[2] - bgr[2];
+
+   return db * db + dg * dg + dr * dr;
+}
+
+static int nearestColour(const vector<Vec3f> &centres, const uchar *bgr) {
+   int c, best = 0;
+   float distance, best_distance = squaredDistance(&centres[0][0], bgr);
+
+   for (c = 1; c < (int) centres.size(); c++) {
+      distance = squaredDistance(&centres[c][0], bgr);
+      if (distance < best_distance) {
+         best          = c;
+         best_distance = distance;
+      }
+   }
+   return best;
+}
+
+
+/*
+ * computePalette
+ * Palette of the image by mini-batch k-means (Sculley 2010): each iteration assigns a random sample of pixels to
+ * their nearest centres and moves each centre towards its samples with a learning rate of one over the number of
+ * samples it has had so far.  The centres are initialised with k-means++ seeding on the first sample.
+ */
+
+void computePalette(const Mat &image, int palette_size, paletteType *palette) {
+
+   RNG rng(0x5EED);
+   vector<Vec3f> centres;
+   vector<int> counts(palette_size, 0);
+   vector<const uchar *> batch(KMEANS_BATCH_SIZE);
+   vector<int> nearest(KMEANS_BATCH_SIZE);
+   vector<double> distances(KMEANS_BATCH_SIZE);
+   double total, target;
+   float eta;
+   int iteration, i, c, channel;
+
+   CV_Assert(image.type() == CV_8UC3 && palette_size >= 1 && palette_size <= MAX_PALETTE_SIZE);
+
+   /* k-means++ seeding: each new centre is a sample chosen with probability proportional to its squared distance to the nearest centre */
+
+   for (i = 0; i < KMEANS_BATCH_SIZE; i++) {
+      batch[i] = image.ptr<uchar>(rng.uniform(0, image.rows)) + 3 * rng.uniform(0, image.cols);
+   }
+
+   centres.push_back(Vec3f(batch[0][0], batch[0][1], batch[0][2]));
+
+   while ((int) centres.size() < palette_size) {
+      total = 0;
+      for (i = 0; i < KMEANS_BATCH_SIZE; i++) {
+         distances[i] = squaredDistance(&centres[nearestColour(centres, batch[i])][0], batch[i]);
+         total += distances[i];
+      }
+      if (total == 0) break;                                  // fewer distinct colours than the palette size
+
+      target = rng.uniform(0.0, total);
+      for (i = 0; i < KMEANS_BATCH_SIZE - 1 && target >= distances[i]; i++) {
+         target -= distances[i];
+      }
+      centres.push_back(Vec3f(batch[i][0], batch[i][1], batch[i][2]));
+   }
+
+   /* mini-batch updates */
+
+   for (iteration = 0; iteration < KMEANS_ITERATIONS; iteration++) {
+      for (i = 0; i < KMEANS_BATCH_SIZE; i++) {
+         batch[i]   = image.ptr<uchar>(rng.uniform(0, image.rows)) + 3 * rng.uniform(0, image.cols);
+         nearest[i] = nearestColour(centres, batch[i]);
+      }
+
+      for (i = 0; i < KMEANS_BATCH_SIZE; i++) {
+         c   = nearest[i];
+         eta = 1.0f / ++counts[c];
+         for (channel = 0; channel < 3; channel++) {
+            centres[c][channel] += eta * (batch[i][channel] - centres[c][channel]);
+         }
+      }
+   }
+
+   palette->colours.resize(centres.size());
+   for (c = 0; c < (int) centres.size(); c++) {
+      palette->colours[c] = Vec3b(saturate_cast<uchar>(centres[c][0]), saturate_cast<uchar>(centres[c][1]), saturate_cast<uchar>(centres[c][2]));
+   }
+
+   buildPaletteLUT(palette);
+}
+
+
+/*
+ * buildPaletteLUT
+ * Index of the nearest palette colour to the centre of each cell of a 32 x 32 x 32 BGR table,
+ * so that quantising a pixel to the palette is one table look-up instead of a search of the palette
+ */
+
+void buildPaletteLUT(paletteType *palette) {
+
+   const int levels = 1 << PALETTE_LUT_BITS;
+   const int shift  = 8 - PALETTE_LUT_BITS;
+   vector<Vec3f> centres(palette->colours.begin(), palette->colours.end());
+   uchar bgr[3];
+   int b, g, r;
+
+   palette->lut.resize((size_t) 1 << (3 * PALETTE_LUT_BITS));
+
+   for (b = 0; b < levels; b++) {
+      for (g = 0; g < levels; g++) {
+         for (r = 0; r < levels; r++) {
+            bgr[0] = (uchar) ((b << shift) | (1 << (shift - 1)));
+            bgr[1] = (uchar) ((g << shift) | (1 << (shift - 1)));
+            bgr[2] = (uchar) ((r << shift) | (1 << (shift - 1)));
+            palette->lut[(b << (2 * PALETTE_LUT_BITS)) | (g << PALETTE_LUT_BITS) | r] = (uchar) nearestColour(centres, bgr);
+         }
+      }
+   }
+}
+
+
+/*
+ * Parallel body for quantiseToPalette: each row is independent
+ */
+
+class PaletteBody : public ParallelLoopBody {
+public:
+   PaletteBody(const Mat &image, const paletteType *palette, Mat &quantised_image, Mat &indices) :
+      image_(image), palette_(palette), quantised_image_(quantised_image), indices_(indices) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      const int shift = 8 - PALETTE_LUT_BITS;
+      const uchar *lut = &palette_->lut[0];
+      const Vec3b *colours = &palette_->colours[0];
+      int row, col, index;
+
+      for (row = range.start; row < range.end; row++) {
+         const uchar *in  = image_.ptr<uchar>(row);
+         Vec3b       *out = quantised_image_.ptr<Vec3b>(row);
+         uchar       *idx = indices_.ptr<uchar>(row);
+
+         for (col = 0; col < image_.cols; col++, in += 3) {
+            index    = lut[((in[0] >> shift) << (2 * PALETTE_LUT_BITS)) | ((in[1] >> shift) << PALETTE_LUT_BITS) | (in[2] >> shift)];
+            idx[col] = (uchar) index;
+            out[col] = colours[index];
+         }
+      }
+   }
+
+private:
+   const Mat         &image_;
+   const paletteType *palette_;
+   Mat               &quantised_image_;
+   Mat               &indices_;
+};
+
+
+/*
+ * quantiseToPalette
+ * Replace each pixel of a colour image by its palette colour, found with the look-up table;
+ * indices is the palette index of each pixel, for histogramming and segmentation of the reduced image
+ */
+
+void quantiseToPalette(const Mat &image, const paletteType *palette, Mat &quantised_image, Mat &indices) {
+
+   CV_Assert(image.type() == CV_8UC3 && !palette->lut.empty());
+
+   quantised_image.create(image.size(), CV_8UC3);
+   indices.create(image.size(), CV_8UC1);
+   parallel_for_(Range(0, image.rows), PaletteBody(image, palette, quantised_image, indices));
+}
+
+
+/*
+ * quantiseToPaletteAt
+ * Replace each pixel by its nearest palette colour, searching the palette for each pixel accessed with at<>(): used as a reference
+ */
+
+void quantiseToPaletteAt(const Mat &image, const paletteType *palette, Mat &quantised_image) {
+
+   vector<Vec3f> centres(palette->colours.begin(), palette->colours.end());
+   Vec3b bgr;
+   int row, col;
+
+   CV_Assert(image.type() == CV_8UC3);
+
+   quantised_image.create(image.size(), CV_8UC3);
+
+   for (row=0; row < image.rows; row++) {
+      for (col=0; col < image.cols; col++) {
+         bgr = image.at<Vec3b>(row,col);
+         quantised_image.at<Vec3b>(row,col) = palette->colours[nearestColour(centres, &bgr[0])];
+      }
+   }
+}
+
+
+/*
+ * meanSquaredError
+ * Mean squared difference per channel between two images of the same size and type
+ */
+
+double meanSquaredError(const Mat &image1, const Mat &image2) {
+
+   double error = norm(image1, image2, NORM_L2);
+
+   return error * error / (image1.total() * image1.channels());
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
@@ -66,7 +66,7 @@ void colourToGreyscale(char *filename) {
 
    // convert to greyscale by explicit access to colour image pixels
    // we do this simply as an example of one way to access individual pixels
-   // see changeQuantisation() for a more efficient method that accesses pixels using pointers
+   // see changeQuantisation() in colourQuantisation for a more efficient method that accesses pixels using pointers
   
    greyscaleImage.create(colourImage.size(), CV_8UC1);
   
@@ -58,7 +58,7 @@ void colourToHIS(char *filename) {
 
    // convert to HIS by explicit access to colour image pixels
    // we do this simply as an example of one way to access individual pixels
-   // see changeQuantisation() for a more efficient method that accesses pixel using pointers
+   // see changeQuantisation() in colourQuantisation for a more efficient method that accesses pixel using pointers
   
    hueImage.create(colourImage.size(), CV_8UC1);
    saturationImage.create(colourImage.size(), CV_8UC1);
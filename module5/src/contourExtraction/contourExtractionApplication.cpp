@@ -25,6 +25,9 @@
   Ported to Ubuntu 16.04 and OpenCV 3.3
   Abrham Gebreselasie
   10 March 2021
+
+  Trackbar events are coalesced and the contours are recomputed once per display loop iteration
+  16 October 2026
   
 
 */
@@ -117,14 +120,16 @@ int main() {
          namedWindow(canny_window_name, CV_WINDOW_AUTOSIZE );
          resizeWindow(canny_window_name,0,0); // this forces the trackbar to be as small as possible (and to fit in the window)
                  
-         createTrackbar( "Std Dev",    canny_window_name, &gaussian_std_dev, max_gaussian_std_dev, ContourExtraction); // same callback
-         createTrackbar( "Threshold:", canny_window_name, &cannyThreshold, max_cannyThreshold,     ContourExtraction );
+         createTrackbar( "Std Dev",    canny_window_name, &gaussian_std_dev, max_gaussian_std_dev, ContourExtractionTrackbar); // same callback
+         createTrackbar( "Threshold:", canny_window_name, &cannyThreshold, max_cannyThreshold,     ContourExtractionTrackbar );
 
          // Show the image
+         reset_contour_cache();                           // new image so discard the cached intermediate images
          ContourExtraction(0, 0);
 
          do{
             waitKey(30);                                  // Must call this to allow openCV to display the images
+            update_contour_extraction();                  // process only the latest trackbar values
          } while (!_kbhit());                             // We call it repeatedly to allow the user to move the windows
                                                           // (if we don't the window process hangs when you try to click and drag
 
@@ -12,14 +12,132 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Cache the greyscale, blurred, and edge images keyed by the parameters that produced them
+  and coalesce trackbar events so that only the latest values are processed
+  16 October 2026
     
 */
  
 #include "module5/contourExtraction.h"
 
+/*
+ * Intermediate result cache
+ *
+ * Each intermediate image is stored together with the parameter values that produced it so that a trackbar
+ * event only recomputes the stages downstream of the parameter that actually changed:
+ *
+ *   greyscale image:  once per input image (invalidated by reset_contour_cache())
+ *   blurred image:    per standard deviation, with a small least-recently-used cache of MAX_CACHED_SIGMAS entries
+ *   edge image:       per (standard deviation, low threshold, high threshold) triple
+ */
+
+#define MAX_CACHED_SIGMAS 4
+
+struct blurCacheEntry {
+   int  std_dev;      // standard deviation used to produce the blurred image; -1 => entry unused
+   long last_used;    // value of the access clock when the entry was last used
+   Mat  blurred;
+};
+
+static bool           grey_valid = false;
+static blurCacheEntry blur_cache[MAX_CACHED_SIGMAS];
+static long           blur_cache_clock = 0;
+static int            edges_std_dev    = -1;  // parameters that produced detected_edges; -1 => invalid
+static int            edges_low        = -1;
+static int            edges_high       = -1;
+
+static bool           update_pending   = false; // set by the trackbar callback, cleared when the contours are recomputed
+
+
+/*
+ * reset_contour_cache
+ * Discard all cached intermediate images; must be called each time a new source image is loaded
+ */
+
+void reset_contour_cache() {
+   int i;
+
+   grey_valid = false;
+
+   for (i = 0; i < MAX_CACHED_SIGMAS; i++) {
+      blur_cache[i].std_dev   = -1;
+      blur_cache[i].last_used = 0;
+      blur_cache[i].blurred.release();
+   }
+   blur_cache_clock = 0;
+
+   edges_std_dev = -1;
+   edges_low     = -1;
+   edges_high    = -1;
+
+   update_pending = false;
+}
+
+
+/*
+ * get_blurred_image
+ * Return the blurred greyscale image for a given standard deviation, computing it only on a cache miss;
+ * on a miss the least recently used entry is replaced
+ */
+
+static Mat get_blurred_image(Mat &grey, int std_dev) {
+   int i;
+   int lru = 0;
+   int filter_size;
+
+   blur_cache_clock++;
+
+   for (i = 0; i < MAX_CACHED_SIGMAS; i++) {
+      if (blur_cache[i].std_dev == std_dev) {
+         blur_cache[i].last_used = blur_cache_clock;
+         return blur_cache[i].blurred;
+      }
+      if (blur_cache[i].last_used < blur_cache[lru].last_used) {
+         lru = i;
+      }
+   }
+
+   filter_size = std_dev * 4 + 1;  // multiplier must be even to ensure an odd filter size as required by OpenCV
+                                   // this places an upper limit on gaussian_std_dev of 7 to ensure the filter size < 31
+                                   // which is the maximum size for the Laplacian operator
+
+   GaussianBlur(grey, blur_cache[lru].blurred, Size(filter_size,filter_size), std_dev);
+   blur_cache[lru].std_dev   = std_dev;
+   blur_cache[lru].last_used = blur_cache_clock;
+
+   return blur_cache[lru].blurred;
+}
+
+
+/*
+ * ContourExtractionTrackbar
+ * Trackbar callback - only records that a parameter has changed
+ *
+ * While the user drags a trackbar, highgui calls this once for every intermediate value; the work is done by
+ * update_contour_extraction() which the display loop calls once per iteration so that only the latest values are used
+ */
+
+void ContourExtractionTrackbar(int, void*) {
+   update_pending = true;
+}
+
+
+/*
+ * update_contour_extraction
+ * Recompute the contours if a trackbar has moved since the last call
+ */
+
+void update_contour_extraction() {
+   if (update_pending) {
+      ContourExtraction(0, 0);
+   }
+}
+
+
 /*
  * ContourExtraction
- * Trackbar callback - Canny hysteresis thresholds input with a ratio 1:3 and Gaussian standard deviation
+ * Canny hysteresis thresholds input with a ratio 1:3 and Gaussian standard deviation
  */
 
 void ContourExtraction(int, void*) {  
@@ -35,19 +153,27 @@ void ContourExtraction(int, void*) {
    bool debug = true;
    int ratio = 3;
    int kernel_size = 3;
-   int filter_size;
    vector <vector<Point> > contours;
 	vector<Vec4i> hierarchy;
    Mat thresholdedImage; 
 
-   filter_size = gaussian_std_dev * 4 + 1;  // multiplier must be even to ensure an odd filter size as required by OpenCV
-                                            // this places an upper limit on gaussian_std_dev of 7 to ensure the filter size < 31
-                                            // which is the maximum size for the Laplacian operator
-   cvtColor(src, src_gray, CV_BGR2GRAY);
+   update_pending = false;
+
+   if (!grey_valid) {
+      cvtColor(src, src_gray, CV_BGR2GRAY);
+      grey_valid = true;
+   }
+
+   if (edges_std_dev != gaussian_std_dev || edges_low != cannyThreshold || edges_high != cannyThreshold*ratio) {
+
+      src_blur = get_blurred_image(src_gray, gaussian_std_dev);
 
-   GaussianBlur(src_gray, src_blur, Size(filter_size,filter_size), gaussian_std_dev);
+      Canny( src_blur, detected_edges, cannyThreshold, cannyThreshold*ratio, kernel_size );
 
-   Canny( src_blur, detected_edges, cannyThreshold, cannyThreshold*ratio, kernel_size );
+      edges_std_dev = gaussian_std_dev;
+      edges_low     = cannyThreshold;
+      edges_high    = cannyThreshold*ratio;
+   }
 
    Mat canny_edge_image_copy = detected_edges.clone();   // clone the edge image because findContours overwrites it
 
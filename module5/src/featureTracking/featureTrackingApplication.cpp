@@ -0,0 +1,194 @@
+/* 
+  Example use of openCV to track corner features in a video or simulator camera stream by sparse optical flow
+  ------------------------------------------------------------------------------------------------------------
+  
+  This application reads the parameters of the tracker from an input file featureTrackingInput.txt:
+
+  - the filename of the output file to which the tracks are written
+  - the corner detector: 0 for Shi-Tomasi, 1 for FAST
+  - the maximum number of tracks and the number of columns and rows of the detection grid
+  - the fraction of the maximum number of tracks below which new corners are detected, and the minimum distance between tracks
+  - the Shi-Tomasi quality level and the FAST threshold
+  - the Lucas-Kanade window size, the number of pyramid levels, and the maximum forward-backward error (0 to disable the check)
+  - 1 to display the tracks, 0 to track without display
+
+  These are followed by a sequence of lines, each containing the filename of a video to be processed or the word simulator
+  for the lynxmotion_al5d_description simulator camera.
+
+  The frames are captured on a separate thread (video) or in the ROS callback (simulator) into a ring buffer from which
+  the tracker takes them.  Corners are detected in the cells of the grid that have lost their tracks and tracked from frame
+  to frame with pyramidal Lucas-Kanade.  For each frame, the identifier, position, and age of each track are written to the
+  output file, one line per track.  A stream ends at the end of the video, when no simulator frame has arrived for a few
+  seconds, or when a key is pressed.  The tracking rate of each stream is then printed.
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/featureTracking.h"
+
+captureRing capture_ring(CAPTURE_RING_CAPACITY);
+
+int main(int argc, char **argv) {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+
+   ros::init(argc, argv, "featureTracking");
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "featureTrackingInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+   char output_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   int display;
+
+   FILE *fp_in;
+   FILE *fp_out;
+
+   featureTrackerType tracker;
+   trackingStatisticsType statistics;
+   VideoCapture video;
+
+   const char* window_name = "Feature Tracks";
+   
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input featureTrackingInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Example of how to use openCV to track corner features by sparse optical flow.\n\n");
+
+   end_of_file = fscanf(fp_in, "%s %d %d %d %d %lf %d %lf %d %d %d %lf %d", output_filename, &tracker.detector,
+                        &tracker.max_tracks, &tracker.grid_columns, &tracker.grid_rows,
+                        &tracker.redetect_fraction, &tracker.min_distance, &tracker.quality_level, &tracker.fast_threshold,
+                        &tracker.window_size, &tracker.pyramid_levels, &tracker.max_backward_error, &display);
+
+   if (end_of_file != 13 || (tracker.detector != SHI_TOMASI && tracker.detector != FAST_CORNERS) ||
+       tracker.max_tracks < 1 || tracker.window_size < 5 || tracker.pyramid_levels < 0) {
+      printf("Error can't read the parameters of the tracker from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   if (debug) printf("%s corners, at most %d tracks on a %d x %d grid, detection below %.0f%%, minimum distance %d\n"
+                     "Lucas-Kanade window %d x %d, %d pyramid levels, forward-backward error %.1f\n\n",
+                     tracker.detector == SHI_TOMASI ? "Shi-Tomasi" : "FAST", tracker.max_tracks,
+                     tracker.grid_columns, tracker.grid_rows, tracker.redetect_fraction * 100, tracker.min_distance,
+                     tracker.window_size, tracker.window_size, tracker.pyramid_levels, tracker.max_backward_error);
+
+   strcpy(file_path_and_filename, data_dir);
+   strcat(file_path_and_filename, output_filename);
+
+   if ((fp_out = fopen(file_path_and_filename, "w")) == 0) {
+      printf("Error can't open output %s\n", output_filename);
+      prompt_and_exit(1);
+   }
+   fprintf(fp_out, "# frame id x y age\n");
+
+   do {
+      end_of_file = fscanf(fp_in, "%s", filename);
+
+      if (end_of_file != EOF) {
+
+         printf("%s: press any key to stop\n", filename);
+         fprintf(fp_out, "# %s\n", filename);
+
+         if (display) namedWindow(window_name, CV_WINDOW_AUTOSIZE);
+
+         capture_ring.reopen();
+
+         if (strcmp(filename, SIMULATOR_STREAM) == 0) {
+
+            /* simulator camera: the callback runs on its own spinner thread and fills the ring */
+
+            ros::NodeHandle nh;
+            ros::CallbackQueue camera_queue;
+            nh.setCallbackQueue(&camera_queue);
+
+            image_transport::ImageTransport it(nh);
+            image_transport::Subscriber sub = it.subscribe(SIMULATOR_TOPIC, 1, imageMessageReceived);
+
+            ros::AsyncSpinner camera_spinner(1, &camera_queue);
+            camera_spinner.start();
+
+            trackStream(&tracker, &capture_ring, fp_out, display ? window_name : NULL, &statistics);
+
+            camera_spinner.stop();
+         }
+         else {
+
+            /* video file: a capture thread decodes the frames into the ring */
+
+            strcpy(file_path_and_filename, data_dir);
+            strcat(file_path_and_filename, filename);
+
+            video.open(file_path_and_filename);
+            if (!video.isOpened()) {
+               cout << "can not open " << file_path_and_filename << endl;
+               prompt_and_exit(-1);
+            }
+
+            std::thread capture(captureVideo, &video, &capture_ring);
+
+            trackStream(&tracker, &capture_ring, fp_out, display ? window_name : NULL, &statistics);
+
+            capture.join();
+            video.release();
+         }
+
+         if (display) destroyWindow(window_name);
+
+         if (statistics.number_of_frames > 0) {
+            printf("%s: %ld frames of %d x %d, %.1f tracks per frame, corners detected in %ld frames\n", filename,
+                   statistics.number_of_frames, tracker.grey.cols, tracker.grey.rows,
+                   statistics.total_tracks / statistics.number_of_frames, tracker.number_of_detections);
+            printf("   tracking %.2f ms per frame (%.1f frames per second), stream %.1f frames per second, %ld frames dropped\n\n",
+                   statistics.tracking_time * 1000 / statistics.number_of_frames, statistics.number_of_frames / statistics.tracking_time,
+                   statistics.elapsed_time > 0 ? statistics.number_of_frames / statistics.elapsed_time : 0.0, statistics.dropped_frames);
+         }
+         else {
+            printf("%s: no frames\n\n", filename);
+         }
+      }
+   } while (end_of_file != EOF);
+
+   fclose(fp_in);
+   fclose(fp_out);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
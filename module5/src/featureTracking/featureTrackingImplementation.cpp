@@ -0,0 +1,399 @@
+/* 
+  Example use of openCV to track corner features in a video or simulator camera stream by sparse optical flow
+  ------------------------------------------------------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/featureTracking.h"
+
+extern captureRing capture_ring;
+
+
+/*=======================================================*/
+/* Feature tracker                                       */
+/*=======================================================*/
+
+/*
+ * initialiseFeatureTracker
+ * Start a new stream: the tracks are cleared but the images and pyramids keep their allocation
+ */
+
+void initialiseFeatureTracker(featureTrackerType *tracker) {
+
+   if (tracker->grid_columns < 1) tracker->grid_columns = 1;
+   if (tracker->grid_rows    < 1) tracker->grid_rows    = 1;
+   while (tracker->grid_columns * tracker->grid_rows > MAX_GRID_CELLS) {
+      if (tracker->grid_columns >= tracker->grid_rows) tracker->grid_columns--;
+      else                                             tracker->grid_rows--;
+   }
+
+   tracker->tracks.clear();
+   tracker->tracks.reserve(tracker->max_tracks);
+   tracker->next_id              = 0;
+   tracker->number_of_frames     = 0;
+   tracker->number_of_detections = 0;
+}
+
+
+/*
+ * detectCorners
+ * Start new tracks in the grid cells that have fewer than their share of max_tracks, keeping min_distance from every
+ * other track; the corners are detected in those cells only, so that a frame in which a few tracks are lost costs a
+ * few small detections rather than one over the whole image.  Returns the number of new tracks.
+ */
+
+static bool compareResponse(const KeyPoint &a, const KeyPoint &b) {
+   return a.response > b.response;
+}
+
+int detectCorners(featureTrackerType *tracker) {
+
+   int cell_tracks[MAX_GRID_CELLS];
+   int number_of_cells = tracker->grid_columns * tracker->grid_rows;
+   int quota = (tracker->max_tracks + number_of_cells - 1) / number_of_cells;
+   int width  = tracker->grey.cols;
+   int height = tracker->grey.rows;
+   int cell, column, row, needed, added;
+   size_t i;
+   Rect roi;
+   Point2f corner;
+   trackType track;
+
+   /* tracks in each cell, and the mask excluding the neighbourhood of each track */
+
+   tracker->detection_mask.create(tracker->grey.size(), CV_8UC1);
+   tracker->detection_mask.setTo(Scalar(255));
+
+   for (cell = 0; cell < number_of_cells; cell++) {
+      cell_tracks[cell] = 0;
+   }
+
+   for (i = 0; i < tracker->tracks.size(); i++) {
+      column = min((int) tracker->tracks[i].point.x * tracker->grid_columns / width,  tracker->grid_columns - 1);
+      row    = min((int) tracker->tracks[i].point.y * tracker->grid_rows    / height, tracker->grid_rows - 1);
+      cell_tracks[row * tracker->grid_columns + column]++;
+      circle(tracker->detection_mask, tracker->tracks[i].point, tracker->min_distance, Scalar(0), -1);
+   }
+
+   added = 0;
+
+   for (cell = 0; cell < number_of_cells; cell++) {
+      needed = quota - cell_tracks[cell];
+      if (needed <= 0) continue;
+
+      column = cell % tracker->grid_columns;
+      row    = cell / tracker->grid_columns;
+      roi = Rect(column * width / tracker->grid_columns, row * height / tracker->grid_rows, 0, 0);
+      roi.width  = (column + 1) * width  / tracker->grid_columns - roi.x;
+      roi.height = (row + 1)    * height / tracker->grid_rows    - roi.y;
+
+      tracker->corners.clear();
+
+      if (tracker->detector == SHI_TOMASI) {
+         goodFeaturesToTrack(tracker->grey(roi), tracker->corners, needed, tracker->quality_level, tracker->min_distance,
+                             tracker->detection_mask(roi));
+      }
+      else {
+
+         /* strongest FAST corners first, skipping those too close to a track or to a corner already accepted */
+
+         FAST(tracker->grey(roi), tracker->keypoints, tracker->fast_threshold, true);
+         std::sort(tracker->keypoints.begin(), tracker->keypoints.end(), compareResponse);
+
+         for (i = 0; i < tracker->keypoints.size() && (int) tracker->corners.size() < needed; i++) {
+            corner = tracker->keypoints[i].pt + Point2f((float) roi.x, (float) roi.y);
+            if (tracker->detection_mask.at<uchar>(cvRound(corner.y), cvRound(corner.x)) != 0) {
+               tracker->corners.push_back(corner - Point2f((float) roi.x, (float) roi.y));
+               circle(tracker->detection_mask, corner, tracker->min_distance, Scalar(0), -1);
+            }
+         }
+      }
+
+      for (i = 0; i < tracker->corners.size(); i++) {
+         track.id             = tracker->next_id++;
+         track.point          = tracker->corners[i] + Point2f((float) roi.x, (float) roi.y);
+         track.previous_point = track.point;
+         track.age            = 1;
+         tracker->tracks.push_back(track);
+
+         if (tracker->detector == SHI_TOMASI) {
+            circle(tracker->detection_mask, track.point, tracker->min_distance, Scalar(0), -1);  // for the neighbouring cells
+         }
+         added++;
+      }
+   }
+
+   tracker->number_of_detections++;
+   return added;
+}
+
+
+/*
+ * trackFeatures
+ * Track the features of the previous frame into this one with pyramidal Lucas-Kanade and detect new corners when too
+ * few tracks remain.
+ *
+ * The pyramid of each frame is built once, with its derivatives, and used both as the next image for the previous
+ * frame and as the previous image for the next frame; the two pyramids are swapped rather than copied and
+ * buildOpticalFlowPyramid() reuses their levels when the frame size does not change.
+ */
+
+void trackFeatures(featureTrackerType *tracker, const Mat &bgr_image) {
+
+   Size window(tracker->window_size, tracker->window_size);
+   TermCriteria criteria(TermCriteria::COUNT + TermCriteria::EPS, 20, 0.03);
+   size_t i, n, kept;
+   bool valid;
+
+   if (bgr_image.channels() == 3) cvtColor(bgr_image, tracker->grey, CV_BGR2GRAY);
+   else                           bgr_image.copyTo(tracker->grey);
+
+   buildOpticalFlowPyramid(tracker->grey, tracker->pyramid, window, tracker->pyramid_levels, true);
+
+   if (tracker->previous_pyramid.empty() || tracker->previous_pyramid[0].size() != tracker->grey.size()) {
+      tracker->tracks.clear();
+   }
+
+   n = tracker->tracks.size();
+
+   if (n > 0) {
+      tracker->previous_points.resize(n);
+      for (i = 0; i < n; i++) {
+         tracker->previous_points[i] = tracker->tracks[i].point;
+      }
+
+      calcOpticalFlowPyrLK(tracker->previous_pyramid, tracker->pyramid, tracker->previous_points, tracker->points,
+                           tracker->status, tracker->error, window, tracker->pyramid_levels, criteria);
+
+      /* forward-backward check: a feature tracked back from this frame must return to where it started */
+
+      if (tracker->max_backward_error > 0) {
+         tracker->backward_points = tracker->previous_points;
+         calcOpticalFlowPyrLK(tracker->pyramid, tracker->previous_pyramid, tracker->points, tracker->backward_points,
+                              tracker->backward_status, tracker->error, window, tracker->pyramid_levels, criteria,
+                              OPTFLOW_USE_INITIAL_FLOW);
+      }
+
+      /* keep the tracks that were found, in place and in order */
+
+      kept = 0;
+
+      for (i = 0; i < n; i++) {
+         valid = tracker->status[i] && tracker->points[i].x >= 0 && tracker->points[i].x < tracker->grey.cols &&
+                                         tracker->points[i].y >= 0 && tracker->points[i].y < tracker->grey.rows;
+         if (valid && tracker->max_backward_error > 0) {
+            valid = tracker->backward_status[i] &&
+                    norm(tracker->backward_points[i] - tracker->previous_points[i]) <= tracker->max_backward_error;
+         }
+
+         if (valid) {
+            tracker->tracks[kept]                = tracker->tracks[i];
+            tracker->tracks[kept].previous_point = tracker->previous_points[i];
+            tracker->tracks[kept].point          = tracker->points[i];
+            tracker->tracks[kept].age++;
+            kept++;
+         }
+      }
+      tracker->tracks.resize(kept);
+   }
+
+   if ((double) tracker->tracks.size() < tracker->redetect_fraction * tracker->max_tracks) {
+      detectCorners(tracker);
+   }
+
+   std::swap(tracker->pyramid, tracker->previous_pyramid);
+   tracker->number_of_frames++;
+}
+
+
+/*=======================================================*/
+/* Capture and tracking stages                           */
+/*=======================================================*/
+
+/*
+ * captureVideo
+ * Capture thread for a video file: every frame is passed to the tracker, waiting while the ring is full
+ */
+
+void captureVideo(VideoCapture *video, captureRing *ring) {
+
+   Mat frame;   // reused by read() for every frame
+
+   while (video->read(frame)) {
+      if (!ring->push(frame)) break;    // the tracker has stopped
+   }
+   ring->close();
+}
+
+
+/*
+ * imageMessageReceived
+ * Simulator camera callback: the latest frame replaces the oldest one if the tracker falls behind
+ */
+
+void imageMessageReceived(const sensor_msgs::ImageConstPtr& msg) {
+
+   cv_bridge::CvImageConstPtr cv_ptr;
+
+   try {
+      cv_ptr = cv_bridge::toCvShare(msg, sensor_msgs::image_encodings::BGR8);  // the ring makes the copy
+   }
+   catch (cv_bridge::Exception& e) {
+      ROS_ERROR("cv_bridge exception: %s", e.what());
+      return;
+   }
+
+   capture_ring.pushLatest(cv_ptr->image);
+}
+
+
+/*
+ * trackStream
+ * Track the features in each frame taken from the ring until the stream ends or a key is pressed, writing the tracks
+ * to fp_out (if not NULL) and displaying them in window_name (if not NULL)
+ */
+
+void trackStream(featureTrackerType *tracker, captureRing *ring, FILE *fp_out, const char *window_name, trackingStatisticsType *statistics) {
+
+   Mat frame;   // swapped with a ring slot for each frame, so no image is allocated once the stream has started
+   double start_ticks = 0;
+   double ticks;
+
+   initialiseFeatureTracker(tracker);
+
+   statistics->number_of_frames = 0;
+   statistics->tracking_time    = 0;
+   statistics->elapsed_time     = 0;
+   statistics->total_tracks     = 0;
+
+   while (ring->pop(frame, CAPTURE_TIMEOUT)) {
+
+      ticks = (double) getTickCount();
+      if (statistics->number_of_frames == 0) start_ticks = ticks;
+
+      trackFeatures(tracker, frame);
+
+      statistics->tracking_time += ((double) getTickCount() - ticks) / getTickFrequency();
+      statistics->total_tracks  += tracker->tracks.size();
+      statistics->number_of_frames++;
+
+      if (fp_out != NULL) {
+         writeTrackFrame(fp_out, statistics->number_of_frames - 1, tracker->tracks);
+      }
+
+      if (window_name != NULL) {
+         drawTracks(frame, tracker->tracks);
+         imshow(window_name, frame);
+         waitKey(1);
+      }
+
+      if (_kbhit()) {
+         getchar(); // flush the buffer from the keyboard hit
+         break;
+      }
+   }
+
+   ring->close();   // stops a capture thread that is waiting for room in the ring
+
+   if (statistics->number_of_frames > 0) {
+      statistics->elapsed_time = ((double) getTickCount() - start_ticks) / getTickFrequency();
+   }
+   statistics->dropped_frames = ring->dropped();
+}
+
+
+/*=======================================================*/
+/* Output                                                */
+/*=======================================================*/
+
+/*
+ * writeTrackFrame
+ * One line for each track: frame number, track identifier, x, y, and age
+ */
+
+void writeTrackFrame(FILE *fp_out, long frame_number, const vector<trackType> &tracks) {
+
+   size_t i;
+
+   for (i = 0; i < tracks.size(); i++) {
+      fprintf(fp_out, "%ld %d %.2f %.2f %d\n", frame_number, tracks[i].id, tracks[i].point.x, tracks[i].point.y, tracks[i].age);
+   }
+}
+
+
+/*
+ * drawTracks
+ * New tracks in red, the others in green with their motion since the previous frame
+ */
+
+void drawTracks(Mat &image, const vector<trackType> &tracks) {
+
+   size_t i;
+
+   for (i = 0; i < tracks.size(); i++) {
+      if (tracks[i].age == 1) {
+         circle(image, tracks[i].point, 3, Scalar(0, 0, 255), 1);
+      }
+      else {
+         line(image, tracks[i].previous_point, tracks[i].point, Scalar(0, 255, 0), 1);
+         circle(image, tracks[i].point, 2, Scalar(0, 255, 0), -1);
+      }
+   }
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
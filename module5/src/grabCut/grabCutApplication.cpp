@@ -12,6 +12,10 @@
   by clicking on the top-left corner and dragging the cursor.
   
   The user can also interactively specify the number of iterations of the grabCut algorithm to apply.
+
+  In multi-resolution mode (selected with the Multi-res trackbar; off by default) the segmentation is initialized on a downsampled
+  image and refined at full resolution in a narrow band around the object boundary. Increasing the number
+  of iterations then continues the previous solution instead of restarting it.
   
   For a more sophisticated example, see http://docs.opencv.org/trunk/de/dd0/grabcut_8cpp-example.html
 
@@ -30,6 +34,9 @@
   Ported to Ubuntu 16.04 and OpenCV 3.3
   Abrham Gebreselasie
   10 March 2021
+
+  Added multi-resolution mode trackbar
+  16 October 2026
   
 
 */
@@ -41,6 +48,7 @@
 Mat inputImage;
 int numberOfIterations        = 1; // default number of iterations
 int number_of_control_points  = 0;
+int multiresolution           = 0; // 1 => initialize on a downsampled image and retain the models between iterations
 
 const char* input_window_name       = "Input Image";
 const char* grabcut_window_name     = "GrabCut Image";
@@ -115,6 +123,7 @@ int main() {
          resizeWindow(grabcut_window_name,0,0); // this forces the trackbar to be as small as possible (and to fit in the window)
          numberOfIterations       = 1;          // reset each time
          createTrackbar( "Iterations", grabcut_window_name, &numberOfIterations, max_iterations, performGrabCut);
+         createTrackbar( "Multi-res",  grabcut_window_name, &multiresolution,    1,              performGrabCut);
 
          Mat blankImage(inputImage.size(),CV_8UC3,cv::Scalar(255,255,255));
          imshow(input_window_name,inputImage);  
@@ -122,6 +131,7 @@ int main() {
 
          // process the image
          number_of_control_points = 0; // don't segment until the region in interest is specified
+         reset_grabcut_model();        // don't continue the solution from the previous image
          performGrabCut(0, 0);
 
          do{
@@ -12,6 +12,11 @@
   --------------------
   Added _kbhit
   18 February 2021
+
+  Added multi-resolution mode: initialize on a downsampled image, refine a boundary band at full resolution,
+  and retain the mask and models so that more iterations continue with GC_EVAL.
+  Removed the busy wait for the control points; the mouse callback triggers the segmentation instead.
+  16 October 2026
     
 */
  
@@ -24,45 +29,185 @@ Point2i control_points[4];
 Rect    rect;
 bool    rectState = false; // true => draw the rectangle as the mouse moves and flag the fact that the rectangle is defined
 
+/* 
+ * Multi-resolution GrabCut state
+ *
+ * In multi-resolution mode the segmentation is first computed on a downsampled level of the image pyramid
+ * and then refined at full resolution only in a narrow band around the object boundary.
+ * The mask and the colour models are kept between calls so that increasing the number of iterations 
+ * continues the existing solution with GC_EVAL rather than restarting from the rectangle.
+ */
+
+#define GRABCUT_PYRAMID_MAX_WIDTH 320   // downsample the image until it is no wider than this
+#define GRABCUT_BAND_WIDTH        8     // half-width in pixels of the boundary band refined at full resolution
+
+Mat  gc_mask;                // full-resolution mask: GC_BGD, GC_FGD, GC_PR_BGD, GC_PR_FGD
+Mat  gc_bgModel, gc_fgModel; // background and foreground GMMs, reused across calls
+Rect gc_rect;                // rectangle used to initialize the current model
+int  gc_iterations = 0;      // number of iterations already applied; 0 => no model
+
+
+/*
+ * reset_grabcut_model
+ * Discard the retained mask and models; must be called each time a new image is loaded
+ */
+
+void reset_grabcut_model() {
+   gc_mask.release();
+   gc_bgModel.release();
+   gc_fgModel.release();
+   gc_iterations = 0;
+}
+
+
+/*
+ * refine_boundary_band
+ * Continue the GrabCut iterations at full resolution, restricted to a band around the current boundary.
+ * Pixels more than GRABCUT_BAND_WIDTH from the boundary are fixed as definite foreground or background 
+ * and only the bounding rectangle of the band is passed to grabCut
+ */
+
+void refine_boundary_band(Mat &image, int iterations) {
+   Mat foreground;
+   Mat inner;
+   Mat outer;
+   Mat band;
+   Mat element;
+   Mat mask_roi;
+   Rect roi;
+
+   bitwise_and(gc_mask, Scalar(1), foreground);   // GC_FGD and GC_PR_FGD are the odd labels
+
+   element = getStructuringElement(MORPH_RECT, Size(2 * GRABCUT_BAND_WIDTH + 1, 2 * GRABCUT_BAND_WIDTH + 1));
+   erode(foreground, inner, element);
+   dilate(foreground, outer, element);
+   band = outer - inner;
+
+   if (countNonZero(band) == 0) return;           // no boundary to refine
+
+   gc_mask.setTo(GC_BGD, outer == 0);
+   gc_mask.setTo(GC_FGD, inner);
+   gc_mask.setTo(GC_PR_BGD, band & (foreground == 0));
+   gc_mask.setTo(GC_PR_FGD, band & foreground);
+
+   roi = boundingRect(band);
+   mask_roi = gc_mask(roi);                       // shares data with gc_mask so the result is written in place
+
+   grabCut(image(roi), mask_roi, Rect(), gc_bgModel, gc_fgModel, iterations, GC_EVAL);
+}
+
+
+/*
+ * multiresolution_grabcut
+ * Initialize the segmentation on a downsampled image and refine it at full resolution
+ */
+
+void multiresolution_grabcut(Mat &image, Rect region, int iterations) {
+   Mat small_image;
+   Mat small_mask;
+   Mat temp;
+   Rect small_rect;
+   int scale = 1;
+
+   small_image = image;
+   while (small_image.cols > GRABCUT_PYRAMID_MAX_WIDTH) {
+      pyrDown(small_image, temp);
+      small_image = temp.clone();
+      scale = scale * 2;
+   }
+
+   small_rect = Rect(region.x / scale, region.y / scale, region.width / scale, region.height / scale)
+                & Rect(0, 0, small_image.cols, small_image.rows);
+
+   if (small_rect.width < 2 || small_rect.height < 2) {
+      small_image = image;                        // rectangle too small to downsample: solve at full resolution
+      small_rect  = region & Rect(0, 0, image.cols, image.rows);
+      scale       = 1;
+   }
+
+   gc_bgModel.release();
+   gc_fgModel.release();
+
+   grabCut(small_image, small_mask, small_rect, gc_bgModel, gc_fgModel, iterations, GC_INIT_WITH_RECT);
+
+   if (scale == 1) {
+      gc_mask = small_mask;
+   }
+   else {
+      resize(small_mask, gc_mask, image.size(), 0, 0, INTER_NEAREST);
+      refine_boundary_band(image, 1);
+   }
+}
+
+
 /*
  * function grabCut
  * Trackbar callback - number of iterations user input
 */
 
 void performGrabCut(int, void*) {  
-
    extern Mat   inputImage; 
    extern int   numberOfIterations; 
    extern int   number_of_control_points;
+   extern int   multiresolution;
    extern char* grabcut_window_name;
+
    Mat result;          // segmentation result 
    Mat bgModel,fgModel; // the models (hard constraints)
 
+   static int previous_multiresolution = 0;
+
    if (numberOfIterations < 1)  // the trackbar has a lower value of 0 which is invalid
       numberOfIterations = 1;
 
-   /* get two control points (top left and bottom right) and rectangle */
-   do { 
-      waitKey(30); 
-   } while (number_of_control_points < 2);
-
-    /* GrabCut segmentation                                                                           */
-    /* see: http://docs.opencv.org/2.4/modules/imgproc/doc/miscellaneous_transformations.html#grabcut */
-    grabCut(inputImage,         // input image
-            result,             // segmentation result (4 values); can also be used as an input mask providing constraints
-            rect,               // rectangle containing foreground 
-            bgModel,fgModel,    // for internal use ... allows continuation of iterative solution on subsequent calls
-            numberOfIterations, // number of iterations
-            GC_INIT_WITH_RECT); // use rectangle
+   /* don't segment until the two control points (top left and bottom right) and the rectangle are specified */
+   /* the mouse callback calls this function again when the rectangle is complete                          */
+   if (number_of_control_points < 2 || rect.width < 2 || rect.height < 2) {
+      return;
+   }
+
+   if (multiresolution) {
+
+      /* restart if the rectangle or the mode changed, or if fewer iterations are requested than already applied */
+      if (gc_iterations == 0 || rect != gc_rect || !previous_multiresolution || numberOfIterations < gc_iterations) {
+         gc_rect = rect;
+         multiresolution_grabcut(inputImage, rect, numberOfIterations);
+         gc_iterations = numberOfIterations;
+      }
+      else if (numberOfIterations > gc_iterations) {
+         refine_boundary_band(inputImage, numberOfIterations - gc_iterations);
+         gc_iterations = numberOfIterations;
+      }
+
+      /* Get the pixels marked as foreground: the band refinement fixes the interior as definite foreground */
+      bitwise_and(gc_mask, Scalar(1), result);    // GC_FGD and GC_PR_FGD are the odd labels
+      result = result * 255;
+   }
+   else {
+
+      /* GrabCut segmentation                                                                           */
+      /* see: http://docs.opencv.org/2.4/modules/imgproc/doc/miscellaneous_transformations.html#grabcut */
+
+      grabCut(inputImage,         // input image
+              result,             // segmentation result (4 values); can also be used as an input mask providing constraints
+              rect,               // rectangle containing foreground 
+              bgModel,fgModel,    // for internal use ... allows continuation of iterative solution on subsequent calls
+              numberOfIterations, // number of iterations
+              GC_INIT_WITH_RECT); // use rectangle
     
-    /* Get the pixels marked as likely foreground */
-    compare(result,GC_PR_FGD,result,CMP_EQ);
+      /* Get the pixels marked as likely foreground */
+      compare(result,GC_PR_FGD,result,CMP_EQ);
 
-    /* Generate output image */
-    Mat foreground(inputImage.size(),CV_8UC3,cv::Scalar(255,255,255));
-    inputImage.copyTo(foreground,result); // use result to mask out the background pixels 
+      gc_iterations = 0;
+   }
+
+   previous_multiresolution = multiresolution;
+
+   /* Generate output image */
+   Mat foreground(inputImage.size(),CV_8UC3,cv::Scalar(255,255,255));
+   inputImage.copyTo(foreground,result); // use result to mask out the background pixels 
  
-    imshow(grabcut_window_name, foreground);
+   imshow(grabcut_window_name, foreground);
 }
 
 /* Simple callback to highlight a region of interest by drawing a green rectangle                                 */
@@ -118,6 +263,8 @@ void getControlPoints(int event, int x, int y, int, void* ) {
        rectangle(imageCopy, Point( rect.x, rect.y ), Point(rect.x + rect.width, rect.y + rect.height ), Scalar(0, 255, 0), 1); // green
        imshow(input_window_name, imageCopy); 
 
+       performGrabCut(0, 0); // the rectangle is complete: segment
+
        break;
 
     case EVENT_MOUSEMOVE:
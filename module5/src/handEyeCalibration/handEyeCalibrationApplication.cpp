@@ -0,0 +1,170 @@
+/*
+  Example use of openCV to compute the hand-eye calibration of a robot and a camera
+  ---------------------------------------------------------------------------------
+
+  handEyeCalibrationApplication reads four lines from an input file handEyeCalibrationInput.txt.
+
+  The first line is the filename of an input file that contains the pose pairs.  Each pose pair is the robot pose, i.e.
+  the sixteen elements of the Frame passed to move(), row by row, followed by the pose of the calibration grid seen by
+  the camera at that robot pose, i.e. the three elements of the rotation vector and the three elements of the translation
+  vector (in mm) returned by solvePnP().  The pose pairs are not recorded by any application in this package: they must
+  be collected with the robot and camera being calibrated.  The sample file handEyePosePairs.txt contains twelve synthetic
+  pose pairs for a camera looking down on the workspace, generated in the same way as the benchmark data (configuration 0).
+
+  The second line is the configuration: 0 if the camera is fixed and the gripper holds the calibration grid, as in the
+  simulator, and 1 if the camera is mounted on the gripper and the calibration grid is fixed.
+
+  The third line is the filename of an output file to which the two 4x4 transforms are written:
+  X, the pose of the calibration grid in the gripper frame (configuration 0) or the pose of the camera in the gripper frame (configuration 1),
+  and Z, the pose of the camera in the robot base frame (configuration 0) or the pose of the calibration grid in the robot base frame (configuration 1).
+  The pose of the camera in the robot base frame is the transform needed to map the pose of an object seen by the camera
+  to the Frame used to pick it up.  Other applications load the two transforms with readHandEyeTransform().
+
+  The fourth line is the number of pose pairs used to benchmark the solver on synthetic data with a known solution.
+
+  The transforms are computed in closed form with the method of Tsai and Lenz and then refined by Levenberg-Marquardt
+  minimisation.  The benchmark is run first; if the pose pair file does not exist, only the benchmark is run.
+
+  It is assumed that the input files are located in a data directory given by the path ../data/
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/handEyeCalibration.h"
+
+int main() {
+
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif
+
+   const char input_filename[MAX_FILENAME_LENGTH] = "handEyeCalibrationInput.txt";
+   char input_path_and_filename[MAX_FILENAME_LENGTH];
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+
+   int end_of_file;
+   bool debug = true;
+   int i, j;
+   char posePairsFilename[MAX_FILENAME_LENGTH];
+   char transformFilename[MAX_FILENAME_LENGTH];
+   int  configuration;
+   int  numberOfBenchmarkPoses;
+   int  numberOfPosePairs;
+   FILE *fp_in;
+
+   vector<Matx44d> robotPoses;
+   vector<Matx44d> cameraPoses;
+   Matx44d X, Z;
+   handEyeStatisticsType statistics;
+   bool solved;
+
+
+   #ifdef ROS
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input handEyeCalibrationInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   printf("Computing the hand-eye calibration\n\n");
+
+   end_of_file = fscanf(fp_in, "%s %d %s %d", posePairsFilename, &configuration, transformFilename, &numberOfBenchmarkPoses);
+
+   if (end_of_file != 4) {
+      printf("Error can't read the filenames, configuration, and number of benchmark poses from %s\n", input_filename);
+      prompt_and_exit(1);
+   }
+
+   if (debug) {
+      printf("%s\n%d\n%s\n%d\n\n", posePairsFilename, configuration, transformFilename, numberOfBenchmarkPoses);
+   }
+
+   /* benchmark on synthetic data with a known solution */
+
+   benchmarkHandEye(numberOfBenchmarkPoses, configuration);
+
+   /* calibration from the pose pairs */
+
+   strcpy(file_path_and_filename, data_dir);
+   strcat(file_path_and_filename, posePairsFilename);
+
+   numberOfPosePairs = readHandEyePosePairs(file_path_and_filename, robotPoses, cameraPoses);
+
+   if (numberOfPosePairs < 0) {
+      printf("Can't open %s: no pose pairs to calibrate\n", file_path_and_filename);
+   }
+   else {
+      printf("Number of pose pairs %d\n\n", numberOfPosePairs);
+
+      if (configuration == EYE_TO_HAND) {
+         solved = solveRobotWorldHandEye(robotPoses, cameraPoses, X, Z, &statistics);
+      }
+      else {
+         solved = solveHandEye(robotPoses, cameraPoses, X, Z, &statistics);
+      }
+
+      if (!solved) {
+         printf("Fatal error: at least %d pose pairs with rotations about different axes are needed\n", HAND_EYE_MIN_POSES);
+         prompt_and_exit(1);
+      }
+
+      printf("X\n");
+      for (i=0; i<4; i++) {
+         for (j=0; j<4; j++) {
+            printf("%10.4f ", X(i, j));
+         }
+         printf("\n");
+      }
+      printf("\nZ\n");
+      for (i=0; i<4; i++) {
+         for (j=0; j<4; j++) {
+            printf("%10.4f ", Z(i, j));
+         }
+         printf("\n");
+      }
+
+      printf("\nTsai-Lenz:  RMS error %6.3f degrees %7.3f mm in %.2f ms\n",
+             statistics.initial_rotation_error, statistics.initial_translation_error, statistics.tsai_lenz_time_ms);
+      printf("Refinement: RMS error %6.3f degrees %7.3f mm in %.2f ms (%d iterations)\n\n",
+             statistics.rotation_error, statistics.translation_error, statistics.refinement_time_ms, statistics.lm_iterations);
+
+      strcpy(file_path_and_filename, data_dir);
+      strcat(file_path_and_filename, transformFilename);
+
+      if (!writeHandEyeTransform(file_path_and_filename, X, Z)) {
+         printf("Error can't open output %s\n", file_path_and_filename);
+         prompt_and_exit(1);
+      }
+   }
+
+   fclose(fp_in);
+
+   if (debug) prompt_and_continue();
+
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+
+   return 0;
+}
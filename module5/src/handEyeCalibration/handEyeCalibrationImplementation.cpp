@@ -0,0 +1,737 @@
+/*
+  Example use of openCV to compute the hand-eye calibration of a robot and a camera
+  ---------------------------------------------------------------------------------
+
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/handEyeCalibration.h"
+
+#include <math.h>
+#include <float.h>
+
+
+/*
+ * Notation
+ * --------
+ *
+ * A_i  robot pose: the pose of the gripper in the robot base frame, i.e. the Frame passed to move()
+ * B_i  camera pose: the pose of the calibration grid in the camera frame, i.e. the rvec and tvec returned by solvePnP()
+ *
+ * EYE_TO_HAND: the camera is fixed and the gripper holds the calibration grid, so that
+ *
+ *    A_i X = Z B_i        X = pose of the grid in the gripper frame, Z = pose of the camera in the robot base frame
+ *
+ * EYE_IN_HAND: the camera is mounted on the gripper and the calibration grid is fixed, so that
+ *
+ *    A_i X B_i = Z        X = pose of the camera in the gripper frame, Z = pose of the grid in the robot base frame
+ *
+ * In both cases the relative motion between two poses i and j eliminates Z and gives AX = XB, which is solved in closed
+ * form with the method of Tsai and Lenz:
+ *
+ *    EYE_TO_HAND:   (A_j^-1 A_i) X = X (B_j^-1 B_i)
+ *    EYE_IN_HAND:   (A_j^-1 A_i) X = X (B_j B_i^-1)
+ *
+ * Z then follows from X by averaging over the poses, and X and Z are refined together by Levenberg-Marquardt
+ * minimisation of the rotation and translation errors of the equation for each pose.
+ */
+
+
+/*=======================================================*/
+/* Rotations and poses                                   */
+/*=======================================================*/
+
+static Matx33d skew(const Vec3d &v) {
+   return Matx33d(   0, -v[2],  v[1],
+                  v[2],     0, -v[0],
+                 -v[1],  v[0],     0);
+}
+
+static Matx33d rotation_part(const Matx44d &T) {
+   return T.get_minor<3, 3>(0, 0);
+}
+
+static Vec3d translation_part(const Matx44d &T) {
+   return Vec3d(T(0, 3), T(1, 3), T(2, 3));
+}
+
+static Matx44d make_pose(const Matx33d &R, const Vec3d &t) {
+   return Matx44d(R(0, 0), R(0, 1), R(0, 2), t[0],
+                  R(1, 0), R(1, 1), R(1, 2), t[1],
+                  R(2, 0), R(2, 1), R(2, 2), t[2],
+                  0,       0,       0,       1);
+}
+
+/* rotation matrix from a rotation vector (Rodrigues' formula) */
+
+static Matx33d rotation_matrix(const Vec3d &r) {
+   double theta = norm(r);
+   Matx33d K;
+
+   if (theta < 1e-12) {
+      return Matx33d::eye() + skew(r);
+   }
+   K = skew(r * (1.0 / theta));
+   return Matx33d::eye() + K * sin(theta) + K * K * (1 - cos(theta));
+}
+
+/* rotation vector from a rotation matrix; cv::Rodrigues() does the same but is slower for single 3x3 matrices */
+
+static Vec3d rotation_vector(const Matx33d &R) {
+   double c = (R(0, 0) + R(1, 1) + R(2, 2) - 1) / 2;
+   double theta;
+   Vec3d  w(R(2, 1) - R(1, 2), R(0, 2) - R(2, 0), R(1, 0) - R(0, 1));
+   Vec3d  n;
+   int    k;
+
+   c = c > 1 ? 1 : (c < -1 ? -1 : c);
+   theta = acos(c);
+
+   if (theta < 1e-6) {
+      return w * 0.5;
+   }
+
+   if (theta > CV_PI - 1e-4) {
+
+      /* the axis is the column of (R + I) / 2 = n n^T with the largest diagonal element */
+
+      k = 0;
+      if (R(1, 1) > R(k, k)) k = 1;
+      if (R(2, 2) > R(k, k)) k = 2;
+
+      n = Vec3d(R(0, k), R(1, k), R(2, k));
+      n[k] += 1;
+      n = n * (1.0 / norm(n));
+      if (n.dot(w) < 0) n = -n;
+      return n * theta;
+   }
+
+   return w * (theta / (2 * sin(theta)));
+}
+
+Matx44d poseFromRotationTranslation(const Vec3d &rvec, const Vec3d &tvec) {
+   return make_pose(rotation_matrix(rvec), tvec);
+}
+
+Matx44d invertPose(const Matx44d &T) {
+   Matx33d Rt = rotation_part(T).t();
+
+   return make_pose(Rt, -(Rt * translation_part(T)));
+}
+
+
+/*=======================================================*/
+/* Tsai-Lenz closed-form solution of AX = XB             */
+/*=======================================================*/
+
+/*
+ * A and B are corresponding relative motions.  With the modified Rodrigues vector P = 2 sin(theta/2) n of each rotation,
+ * the rotation of X satisfies skew(P_A + P_B) P' = P_B - P_A for every motion, where P' = P_X / sqrt(4 - |P_X|^2); the
+ * translation then satisfies (R_A - I) t_X = R_X t_B - t_A.  Both are solved in the least-squares sense by accumulating
+ * the 3x3 normal equations, so the cost is linear in the number of motions.
+ */
+
+bool solveHandEyeTsaiLenz(const vector<Matx44d> &A, const vector<Matx44d> &B, Matx44d &X) {
+
+   Matx33d StS = Matx33d::zeros();
+   Vec3d   Std(0, 0, 0);
+   Matx33d CtC = Matx33d::zeros();
+   Vec3d   Ctd(0, 0, 0);
+   Matx33d S, C, R_X;
+   Vec3d   r_A, r_B, P_A, P_B, P_prime, P_X, t_X;
+   double  theta_A, theta_B, n2;
+   double  min_rotation = HAND_EYE_MIN_ROTATION * CV_PI / 180;
+   vector<bool> used(A.size(), false);
+   int     number_used = 0;
+   size_t  k;
+
+   if (A.size() != B.size()) {
+      return false;
+   }
+
+   /* rotation */
+
+   for (k = 0; k < A.size(); k++) {
+      r_A = rotation_vector(rotation_part(A[k]));
+      r_B = rotation_vector(rotation_part(B[k]));
+      theta_A = norm(r_A);
+      theta_B = norm(r_B);
+
+      if (theta_A < min_rotation || theta_B < min_rotation) {
+         continue;
+      }
+
+      P_A = r_A * (2 * sin(theta_A / 2) / theta_A);
+      P_B = r_B * (2 * sin(theta_B / 2) / theta_B);
+
+      S = skew(P_A + P_B);
+      StS += S.t() * S;
+      Std += S.t() * (P_B - P_A);
+
+      used[k] = true;
+      number_used++;
+   }
+
+   if (number_used < 2 || fabs(determinant(StS)) < DBL_EPSILON) {
+      return false;                                   // all rotation axes are parallel
+   }
+
+   P_prime = StS.solve(Std, DECOMP_CHOLESKY);
+   P_X = P_prime * (2 / sqrt(1 + P_prime.dot(P_prime)));
+   n2  = P_X.dot(P_X);
+   R_X = Matx33d::eye() * (1 - n2 / 2) + (P_X * P_X.t() + skew(P_X) * sqrt(4 - n2)) * 0.5;
+
+   /* translation */
+
+   for (k = 0; k < A.size(); k++) {
+      if (!used[k]) continue;
+
+      C = rotation_part(A[k]) - Matx33d::eye();
+      CtC += C.t() * C;
+      Ctd += C.t() * (R_X * translation_part(B[k]) - translation_part(A[k]));
+   }
+
+   t_X = CtC.solve(Ctd, DECOMP_SVD);
+
+   X = make_pose(R_X, t_X);
+
+   return true;
+}
+
+
+/*=======================================================*/
+/* AX = XB and AX = ZB                                   */
+/*=======================================================*/
+
+/* relative motions between all pairs of poses (see the notation above) */
+
+static void relative_motions(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, int configuration,
+                             vector<Matx44d> &A, vector<Matx44d> &B) {
+
+   vector<Matx44d> robotInverses(robotPoses.size());
+   vector<Matx44d> cameraInverses(cameraPoses.size());
+   size_t i, j;
+
+   for (i = 0; i < robotPoses.size(); i++) {
+      robotInverses[i]  = invertPose(robotPoses[i]);
+      cameraInverses[i] = invertPose(cameraPoses[i]);
+   }
+
+   A.clear();
+   B.clear();
+
+   for (i = 0; i < robotPoses.size(); i++) {
+      for (j = i + 1; j < robotPoses.size(); j++) {
+         A.push_back(robotInverses[j] * robotPoses[i]);
+         if (configuration == EYE_TO_HAND) {
+            B.push_back(cameraInverses[j] * cameraPoses[i]);
+         }
+         else {
+            B.push_back(cameraPoses[j] * cameraInverses[i]);
+         }
+      }
+   }
+}
+
+/* the two sides of the equation for pose i: A_i X and Z B_i, or A_i X B_i and Z */
+
+static void equation_sides(const Matx44d &A, const Matx44d &B, int configuration, const Matx44d &X, const Matx44d &Z,
+                           Matx44d &left, Matx44d &right) {
+   if (configuration == EYE_TO_HAND) {
+      left  = A * X;
+      right = Z * B;
+   }
+   else {
+      left  = A * X * B;
+      right = Z;
+   }
+}
+
+/* Z from X: the rotations are averaged by projecting their sum onto the nearest rotation */
+
+static Matx44d average_z(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, int configuration,
+                         const Matx44d &X) {
+
+   Matx33d sum_R = Matx33d::zeros();
+   Vec3d   sum_t(0, 0, 0);
+   Matx44d Z_i;
+   Matx33d U, Vt, D = Matx33d::eye();
+   Matx31d w;
+   size_t  i;
+
+   for (i = 0; i < robotPoses.size(); i++) {
+      if (configuration == EYE_TO_HAND) {
+         Z_i = robotPoses[i] * X * invertPose(cameraPoses[i]);
+      }
+      else {
+         Z_i = robotPoses[i] * X * cameraPoses[i];
+      }
+      sum_R += rotation_part(Z_i);
+      sum_t += translation_part(Z_i);
+   }
+
+   SVD::compute(sum_R, w, U, Vt);
+   if (determinant(U * Vt) < 0) {
+      D(2, 2) = -1;
+   }
+
+   return make_pose(U * D * Vt, sum_t * (1.0 / robotPoses.size()));
+}
+
+/* residuals of the equation for each pose: weighted rotation vector of the rotation error and the translation error */
+
+static void hand_eye_residuals(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, int configuration,
+                               const Matx44d &X, const Matx44d &Z, vector<double> &r) {
+
+   Matx44d left, right;
+   Vec3d   r_R, r_t;
+   size_t  i;
+
+   r.resize(6 * robotPoses.size());
+
+   for (i = 0; i < robotPoses.size(); i++) {
+      equation_sides(robotPoses[i], cameraPoses[i], configuration, X, Z, left, right);
+
+      r_R = rotation_vector(rotation_part(left) * rotation_part(right).t()) * HAND_EYE_ROTATION_WEIGHT;
+      r_t = translation_part(left) - translation_part(right);
+
+      r[6*i + 0] = r_R[0];
+      r[6*i + 1] = r_R[1];
+      r[6*i + 2] = r_R[2];
+      r[6*i + 3] = r_t[0];
+      r[6*i + 4] = r_t[1];
+      r[6*i + 5] = r_t[2];
+   }
+}
+
+/* X and Z updated by the parameter increments p: rotation increments are applied on the left, translations are added */
+
+static void update_poses(const Matx44d &X, const Matx44d &Z, const double p[12], Matx44d &X_new, Matx44d &Z_new) {
+   X_new = make_pose(rotation_matrix(Vec3d(p[0], p[1], p[2])) * rotation_part(X),
+                     translation_part(X) + Vec3d(p[3], p[4], p[5]));
+   Z_new = make_pose(rotation_matrix(Vec3d(p[6], p[7], p[8])) * rotation_part(Z),
+                     translation_part(Z) + Vec3d(p[9], p[10], p[11]));
+}
+
+static double sum_of_squares(const vector<double> &r) {
+   double sum = 0;
+
+   for (size_t i = 0; i < r.size(); i++) {
+      sum += r[i] * r[i];
+   }
+   return sum;
+}
+
+/* Levenberg-Marquardt refinement of X and Z with a forward-difference Jacobian; returns the number of iterations */
+
+static int refine_hand_eye(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, int configuration,
+                           Matx44d &X, Matx44d &Z) {
+
+   const double h = 1e-7;
+   vector<double> r, r_h;
+   vector< vector<double> > J(12);
+   Matx<double, 12, 12> JtJ, N;
+   Vec<double, 12>      Jtr, delta;
+   double  p[12];
+   double  cost, new_cost;
+   double  lambda = 1e-3;
+   Matx44d X_new, Z_new;
+   int     iteration, j, k;
+   size_t  i;
+
+   hand_eye_residuals(robotPoses, cameraPoses, configuration, X, Z, r);
+   cost = sum_of_squares(r);
+
+   for (iteration = 0; iteration < HAND_EYE_MAX_ITERATIONS; iteration++) {
+
+      /* Jacobian and normal equations */
+
+      for (j = 0; j < 12; j++) {
+         for (k = 0; k < 12; k++) p[k] = 0;
+         p[j] = h;
+         update_poses(X, Z, p, X_new, Z_new);
+         hand_eye_residuals(robotPoses, cameraPoses, configuration, X_new, Z_new, r_h);
+
+         J[j].resize(r.size());
+         for (i = 0; i < r.size(); i++) {
+            J[j][i] = (r_h[i] - r[i]) / h;
+         }
+      }
+
+      for (j = 0; j < 12; j++) {
+         for (k = j; k < 12; k++) {
+            double sum = 0;
+            for (i = 0; i < r.size(); i++) sum += J[j][i] * J[k][i];
+            JtJ(j, k) = JtJ(k, j) = sum;
+         }
+         double sum = 0;
+         for (i = 0; i < r.size(); i++) sum += J[j][i] * r[i];
+         Jtr[j] = sum;
+      }
+
+      /* damped step: increase the damping until the cost decreases */
+
+      do {
+         N = JtJ;
+         for (j = 0; j < 12; j++) N(j, j) += lambda * (JtJ(j, j) + DBL_EPSILON);
+
+         delta = N.solve(-Jtr, DECOMP_CHOLESKY);
+         for (k = 0; k < 12; k++) p[k] = delta[k];
+
+         update_poses(X, Z, p, X_new, Z_new);
+         hand_eye_residuals(robotPoses, cameraPoses, configuration, X_new, Z_new, r_h);
+         new_cost = sum_of_squares(r_h);
+
+         if (new_cost < cost) break;
+         lambda *= 10;
+      } while (lambda < 1e10);
+
+      if (new_cost >= cost) {
+         break;                                        // no further improvement
+      }
+
+      X = X_new;
+      Z = Z_new;
+      r = r_h;
+      lambda = lambda / 10 < 1e-10 ? 1e-10 : lambda / 10;
+
+      if (cost - new_cost < 1e-12 * cost || norm(delta) < 1e-12) {
+         cost = new_cost;
+         iteration++;
+         break;
+      }
+      cost = new_cost;
+   }
+
+   return iteration;
+}
+
+void handEyeError(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, int configuration,
+                  const Matx44d &X, const Matx44d &Z, double *rotation_error, double *translation_error) {
+
+   Matx44d left, right;
+   double  sum_R = 0, sum_t = 0;
+   double  angle;
+   size_t  i;
+
+   for (i = 0; i < robotPoses.size(); i++) {
+      equation_sides(robotPoses[i], cameraPoses[i], configuration, X, Z, left, right);
+
+      angle  = norm(rotation_vector(rotation_part(left) * rotation_part(right).t())) * 180 / CV_PI;
+      sum_R += angle * angle;
+      sum_t += norm(translation_part(left) - translation_part(right), NORM_L2SQR);
+   }
+
+   *rotation_error    = sqrt(sum_R / robotPoses.size());
+   *translation_error = sqrt(sum_t / robotPoses.size());
+}
+
+static bool solve_hand_eye(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, int configuration,
+                           Matx44d &X, Matx44d &Z, handEyeStatisticsType *statistics) {
+
+   vector<Matx44d> A, B;
+   handEyeStatisticsType s;
+   int64 start_ticks;
+
+   if (robotPoses.size() != cameraPoses.size() || robotPoses.size() < HAND_EYE_MIN_POSES) {
+      return false;
+   }
+
+   start_ticks = getTickCount();
+
+   relative_motions(robotPoses, cameraPoses, configuration, A, B);
+
+   if (!solveHandEyeTsaiLenz(A, B, X)) {
+      return false;
+   }
+   Z = average_z(robotPoses, cameraPoses, configuration, X);
+
+   s.tsai_lenz_time_ms = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+   s.number_of_motions = (int) A.size();
+   handEyeError(robotPoses, cameraPoses, configuration, X, Z, &s.initial_rotation_error, &s.initial_translation_error);
+
+   start_ticks = getTickCount();
+
+   s.lm_iterations = refine_hand_eye(robotPoses, cameraPoses, configuration, X, Z);
+
+   s.refinement_time_ms = (getTickCount() - start_ticks) * 1000.0 / getTickFrequency();
+   handEyeError(robotPoses, cameraPoses, configuration, X, Z, &s.rotation_error, &s.translation_error);
+
+   if (statistics != NULL) {
+      *statistics = s;
+   }
+
+   return true;
+}
+
+/* camera on the gripper: X is the camera pose in the gripper frame, Z the calibration grid pose in the base frame */
+
+bool solveHandEye(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, Matx44d &X, Matx44d &Z,
+                  handEyeStatisticsType *statistics) {
+   return solve_hand_eye(robotPoses, cameraPoses, EYE_IN_HAND, X, Z, statistics);
+}
+
+/* fixed camera: X is the calibration grid pose in the gripper frame, Z the camera pose in the base frame */
+
+bool solveRobotWorldHandEye(const vector<Matx44d> &robotPoses, const vector<Matx44d> &cameraPoses, Matx44d &X, Matx44d &Z,
+                            handEyeStatisticsType *statistics) {
+   return solve_hand_eye(robotPoses, cameraPoses, EYE_TO_HAND, X, Z, statistics);
+}
+
+
+/*=======================================================*/
+/* Pose pair and transform files                         */
+/*=======================================================*/
+
+/*
+ * Each pose pair is the sixteen elements of the robot Frame, row by row, as written by writeFrameToFile() in the
+ * robotCameraModelDataSimulator application, followed by the rotation vector and the translation (mm) of the calibration
+ * grid returned by solvePnP().  Returns the number of pose pairs, or -1 if the file can't be opened.
+ */
+
+int readHandEyePosePairs(const char *filename, vector<Matx44d> &robotPoses, vector<Matx44d> &cameraPoses) {
+
+   FILE   *fp;
+   Matx44d A;
+   double  c[6];
+   bool    complete;
+   int     i, j;
+
+   if ((fp = fopen(filename, "r")) == NULL) {
+      return -1;
+   }
+
+   robotPoses.clear();
+   cameraPoses.clear();
+
+   do {
+      complete = true;
+      for (i = 0; i < 4 && complete; i++) {
+         for (j = 0; j < 4 && complete; j++) {
+            complete = fscanf(fp, "%lf", &A(i, j)) == 1;
+         }
+      }
+      for (i = 0; i < 6 && complete; i++) {
+         complete = fscanf(fp, "%lf", &c[i]) == 1;
+      }
+
+      if (complete) {
+         robotPoses.push_back(A);
+         cameraPoses.push_back(poseFromRotationTranslation(Vec3d(c[0], c[1], c[2]), Vec3d(c[3], c[4], c[5])));
+      }
+   } while (complete);
+
+   fclose(fp);
+
+   return (int) robotPoses.size();
+}
+
+/* X and then Z, each as four rows of four elements */
+
+bool writeHandEyeTransform(const char *filename, const Matx44d &X, const Matx44d &Z) {
+
+   FILE *fp;
+   int   i, j;
+
+   if ((fp = fopen(filename, "w")) == NULL) {
+      return false;
+   }
+
+   for (i = 0; i < 4; i++) {
+      for (j = 0; j < 4; j++) {
+         fprintf(fp, "%f ", X(i, j));
+      }
+      fprintf(fp, "\n");
+   }
+   fprintf(fp, "\n");
+   for (i = 0; i < 4; i++) {
+      for (j = 0; j < 4; j++) {
+         fprintf(fp, "%f ", Z(i, j));
+      }
+      fprintf(fp, "\n");
+   }
+
+   fclose(fp);
+   return true;
+}
+
+bool readHandEyeTransform(const char *filename, Matx44d &X, Matx44d &Z) {
+
+   FILE *fp;
+   bool  complete = true;
+   int   i, j;
+
+   if ((fp = fopen(filename, "r")) == NULL) {
+      return false;
+   }
+
+   for (i = 0; i < 4 && complete; i++) {
+      for (j = 0; j < 4 && complete; j++) {
+         complete = fscanf(fp, "%lf", &X(i, j)) == 1;
+      }
+   }
+   for (i = 0; i < 4 && complete; i++) {
+      for (j = 0; j < 4 && complete; j++) {
+         complete = fscanf(fp, "%lf", &Z(i, j)) == 1;
+      }
+   }
+
+   fclose(fp);
+   return complete;
+}
+
+
+/*=======================================================*/
+/* Benchmark                                             */
+/*=======================================================*/
+
+/*
+ * Random gripper poses in the working envelope, pointing down and tilted by up to 25 degrees about each axis, and the
+ * corresponding camera poses for the given X and Z, perturbed by Gaussian noise (rotation_noise in degrees,
+ * translation_noise in mm) to model the error of the calibration grid pose estimated by the camera
+ */
+
+void generateSyntheticPosePairs(int numberOfPoses, int configuration, const Matx44d &X, const Matx44d &Z,
+                                double rotation_noise, double translation_noise, RNG &rng,
+                                vector<Matx44d> &robotPoses, vector<Matx44d> &cameraPoses) {
+
+   double  tilt  = 25 * CV_PI / 180;
+   double  sigma = rotation_noise * CV_PI / 180;
+   Matx33d down  = rotation_matrix(Vec3d(0, CV_PI, 0));
+   Matx44d A, B, noise;
+   int     i;
+
+   robotPoses.clear();
+   cameraPoses.clear();
+
+   for (i = 0; i < numberOfPoses; i++) {
+      A = make_pose(down * rotation_matrix(Vec3d(rng.uniform(-tilt, tilt), rng.uniform(-tilt, tilt), rng.uniform(-tilt, tilt))),
+                    Vec3d(rng.uniform(-100.0, 100.0), rng.uniform(120.0, 280.0), rng.uniform(40.0, 200.0)));
+
+      if (configuration == EYE_TO_HAND) {
+         B = invertPose(Z) * A * X;
+      }
+      else {
+         B = invertPose(A * X) * Z;
+      }
+
+      noise = make_pose(rotation_matrix(Vec3d(rng.gaussian(sigma), rng.gaussian(sigma), rng.gaussian(sigma))),
+                        Vec3d(rng.gaussian(translation_noise), rng.gaussian(translation_noise), rng.gaussian(translation_noise)));
+
+      robotPoses.push_back(A);
+      cameraPoses.push_back(B * noise);
+   }
+}
+
+/* errors of an estimated pose with respect to the true pose: rotation angle in degrees and translation distance in mm */
+
+static void pose_difference(const Matx44d &estimate, const Matx44d &truth, double *rotation, double *translation) {
+   *rotation    = norm(rotation_vector(rotation_part(estimate) * rotation_part(truth).t())) * 180 / CV_PI;
+   *translation = norm(translation_part(estimate) - translation_part(truth));
+}
+
+void benchmarkHandEye(int numberOfPoses, int configuration) {
+
+   vector<Matx44d> robotPoses, cameraPoses;
+   Matx44d X_true, Z_true, X, Z;
+   handEyeStatisticsType statistics;
+   double  rotation_X, translation_X, rotation_Z, translation_Z;
+   RNG     rng(0x5eed);
+   bool    solved;
+
+   if (configuration == EYE_TO_HAND) {
+      X_true = poseFromRotationTranslation(Vec3d(0, 0, 0.3),      Vec3d(10, 0, 40));     // grid in the gripper
+      Z_true = poseFromRotationTranslation(Vec3d(CV_PI, 0, 0),    Vec3d(0, 170, 750));   // camera looking down on the workspace
+   }
+   else {
+      X_true = poseFromRotationTranslation(Vec3d(0, 0, CV_PI / 2), Vec3d(0, 40, 30));     // camera on the gripper
+      Z_true = poseFromRotationTranslation(Vec3d(0, 0, 0.1),       Vec3d(0, 200, 0));     // grid on the table
+   }
+
+   generateSyntheticPosePairs(numberOfPoses, configuration, X_true, Z_true, 0.1, 0.5, rng, robotPoses, cameraPoses);
+
+   if (configuration == EYE_TO_HAND) {
+      solved = solveRobotWorldHandEye(robotPoses, cameraPoses, X, Z, &statistics);
+   }
+   else {
+      solved = solveHandEye(robotPoses, cameraPoses, X, Z, &statistics);
+   }
+
+   printf("Benchmark: %s, %d pose pairs, noise 0.1 degrees and 0.5 mm\n",
+          configuration == EYE_TO_HAND ? "camera fixed (AX = ZB)" : "camera on gripper (AX = XB)", numberOfPoses);
+
+   if (!solved) {
+      printf("   no solution\n\n");
+      return;
+   }
+
+   pose_difference(X, X_true, &rotation_X, &translation_X);
+   pose_difference(Z, Z_true, &rotation_Z, &translation_Z);
+
+   printf("   Tsai-Lenz:  %6.2f ms for %d motions, RMS error %6.3f degrees %7.3f mm\n",
+          statistics.tsai_lenz_time_ms, statistics.number_of_motions,
+          statistics.initial_rotation_error, statistics.initial_translation_error);
+   printf("   refinement: %6.2f ms for %d iterations, RMS error %6.3f degrees %7.3f mm\n",
+          statistics.refinement_time_ms, statistics.lm_iterations,
+          statistics.rotation_error, statistics.translation_error);
+   printf("   total:      %6.2f ms\n", statistics.tsai_lenz_time_ms + statistics.refinement_time_ms);
+   printf("   error in X: %6.3f degrees %7.3f mm\n", rotation_X, translation_X);
+   printf("   error in Z: %6.3f degrees %7.3f mm\n\n", rotation_Z, translation_Z);
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
@@ -0,0 +1,146 @@
+/* 
+  Example use of openCV to perform mathematical morphology with large rectangular structuring elements
+  ----------------------------------------------------------------------------------------------------
+ 
+  This application reads a sequence lines from an input file morphologyInput.txt.
+  Each line contains a filename of an image to be processed. 
+
+  Each image is converted to greyscale and eroded, dilated, opened, closed, or transformed with the morphological
+  gradient, the top-hat, or the black-hat transform, selected with the Operation trackbar (0 to 6, in that order),
+  using a square structuring element of size 2 r + 1, with r selected with the Radius trackbar.
+
+  Erosion and dilation use the algorithm of van Herk and Gil-Werman, whose cost does not depend on the size of the
+  structuring element.  Before the image is displayed, erosion and opening are timed with structuring elements from
+  3 x 3 to 101 x 101 and compared with openCV erode() and morphologyEx().
+
+  It is assumed that the input file is located in a data directory given by the path ../data/ 
+  defined relative to the location of executable for this application.
+
+  (This is the application file: it contains the client code that calls dedicated functions to implement the application.
+  The code for these functions is defined in the implementation file. The functions are declared in the interface file.)
+
+  16 October 2026
+*/
+
+#include "module5/morphology.h"
+
+
+// Global variables to allow access by the display window callback functions
+
+Mat inputImage;
+int operation                 = OPENING; // default operation
+int kernelRadius              = 2;       // default structuring element 5 x 5
+
+const char* input_window_name      = "Input Image";
+const char* morphology_window_name = "Morphology";
+
+
+int main() {
+   
+   #ifdef ROS
+      // Turn off canonical terminal mode and character echoing
+      static const int STDIN = 0;
+      termios term, old_term;
+      tcgetattr(STDIN, &old_term);
+      tcgetattr(STDIN, &term);
+      term.c_lflag &= ~(ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+   #endif 
+    
+   const char input_filename[MAX_FILENAME_LENGTH] = "morphologyInput.txt";    
+   char input_path_and_filename[MAX_FILENAME_LENGTH];    
+   char data_dir[MAX_FILENAME_LENGTH];
+   char file_path_and_filename[MAX_FILENAME_LENGTH];
+     
+   int end_of_file;
+   bool debug = true;
+   char filename[MAX_FILENAME_LENGTH];
+   Mat greyscaleImage;
+
+   int const max_operation = NUMBER_OF_OPERATIONS - 1;
+   int const max_radius    = MAX_KERNEL_SIZE / 2;
+
+   FILE *fp_in;
+
+   printf("Example use of openCV to perform mathematical morphology.\n\n");
+
+   
+   #ifdef ROS   
+      strcpy(data_dir, ros::package::getPath(ROS_PACKAGE_NAME).c_str()); // get the package directory
+   #else
+      strcpy(data_dir, "..");
+   #endif
+   
+   strcat(data_dir, "/data/");
+   strcpy(input_path_and_filename, data_dir);
+   strcat(input_path_and_filename, input_filename);
+   
+
+   if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
+	  printf("Error can't open input file morphologyInput.txt\n");
+     prompt_and_exit(1);
+   }
+
+   do {
+
+      end_of_file = fscanf(fp_in, "%s", filename);
+      
+      if (end_of_file != EOF) {
+         strcpy(file_path_and_filename, data_dir);
+         strcat(file_path_and_filename, filename);
+
+         inputImage = imread(file_path_and_filename, CV_LOAD_IMAGE_UNCHANGED);
+         if(inputImage.empty()) {
+            cout << "can not open " << filename << endl;
+            prompt_and_exit(-1);
+         }
+
+         if (debug) {
+            if (inputImage.type() == CV_8UC3) { // colour image
+               cvtColor(inputImage, greyscaleImage, CV_BGR2GRAY);
+            }
+            else {
+               greyscaleImage = inputImage;
+            }
+
+            printf("%s: %d x %d\n", filename, greyscaleImage.cols, greyscaleImage.rows);
+            benchmarkMorphology(greyscaleImage);
+            printf("\n");
+         }
+          
+         printf("Press any key to continue ...\n");
+
+         // Create a window for input and display it
+         namedWindow(input_window_name, CV_WINDOW_AUTOSIZE );
+         imshow(input_window_name, inputImage);
+ 
+         // Create a window
+         namedWindow(morphology_window_name, CV_WINDOW_AUTOSIZE );
+         resizeWindow(morphology_window_name,0,0); // this forces the trackbar to be as small as possible (and to fit in the window)
+
+         createTrackbar( "Operation", morphology_window_name, &operation, max_operation, morphology);
+         createTrackbar( "Radius", morphology_window_name, &kernelRadius, max_radius, morphology);
+
+         // Show the image
+         morphology(0, 0);
+
+         do{
+            waitKey(30);                                  // Must call this to allow openCV to display the images
+         } while (!_kbhit());                             // We call it repeatedly to allow the user to move the windows
+                                                          // (if we don't the window process hangs when you try to click and drag
+
+         getchar(); // flush the buffer from the keyboard hit
+
+         destroyWindow(input_window_name);  
+         destroyWindow(morphology_window_name); 
+      }
+   } while (end_of_file != EOF);
+
+   fclose(fp_in);
+    
+   #ifdef ROS
+      // Reset terminal
+      tcsetattr(STDIN, TCSANOW, &old_term);
+   #endif
+   return 0;
+}
@@ -0,0 +1,397 @@
+/* 
+  Example use of openCV to perform mathematical morphology with large rectangular structuring elements
+  ----------------------------------------------------------------------------------------------------
+    
+  (This is the implementation file: it contains the code for dedicated functions to implement the application.
+  These functions are called by client code in the application file. The functions are declared in the interface file.) 
+
+  16 October 2026
+*/
+ 
+#include "module5/morphology.h"
+
+
+/*=======================================================*/
+/* van Herk / Gil-Werman erosion and dilation            */
+/*=======================================================*/
+
+/*
+ * Erosion and dilation with a k-pixel line are computed with the algorithm of van Herk and of Gil and Werman.
+ * The padded signal is divided into blocks of k pixels; g is the running minimum from the start of each block and
+ * h the running minimum from its end.  Every window of k pixels spans at most two blocks, so its minimum is
+ * min(h[x], g[x + k - 1]): three comparisons per pixel whatever the value of k.
+ * A rectangle is separable: a horizontal pass along each row followed by a vertical pass down each column.
+ * The image is padded with the border value of openCV erode() and dilate(), so that the border has no effect.
+ */
+
+struct minimumOperation {
+   enum { border = 255 };
+   uchar      operator()(uchar a, uchar b) const                   { return a < b ? a : b; }
+   v_uint8x16 operator()(const v_uint8x16 &a, const v_uint8x16 &b) const { return v_min(a, b); }
+};
+
+struct maximumOperation {
+   enum { border = 0 };
+   uchar      operator()(uchar a, uchar b) const                   { return a > b ? a : b; }
+   v_uint8x16 operator()(const v_uint8x16 &a, const v_uint8x16 &b) const { return v_max(a, b); }
+};
+
+
+/*
+ * Parallel body for the horizontal pass: each row is independent
+ */
+
+template <class Operation>
+class HorizontalPassBody : public ParallelLoopBody {
+public:
+   HorizontalPassBody(const Mat &image, Mat &result, int size) : image_(image), result_(result), size_(size) {
+   }
+
+   virtual void operator()(const Range &range) const {
+      Operation op;
+      int radius = size_ / 2;
+      int length = ((image_.cols + 2 * radius + size_ - 1) / size_) * size_;   // padded to a whole number of blocks
+      vector<uchar> f(length, Operation::border), g(length), h(length);
+      int row, i, j, block;
+
+      for (row = range.start; row < range.end; row++) {
+         const uchar *in  = image_.ptr<uchar>(row);
+         uchar       *out = result_.ptr<uchar>(row);
+
+         memcpy(&f[radius], in, image_.cols);
+
+         for (block = 0; block < length; block += size_) {
+            g[block] = f[block];
+            for (i = block + 1; i < block + size_; i++) {
+               g[i] = op(g[i - 1], f[i]);
+            }
+
+            j = block + size_ - 1;
+            h[j] = f[j];
+            for (i = j - 1; i >= block; i--) {
+               h[i] = op(h[i + 1], f[i]);
+            }
+         }
+
+         for (i = 0; i < image_.cols; i++) {
+            out[i] = op(h[i], g[i + size_ - 1]);
+         }
+      }
+   }
+
+private:
+   const Mat &image_;
+   Mat       &result_;
+   int        size_;
+};
+
+
+/*
+ * Parallel body for the vertical pass: each band of columns is independent and sixteen columns are processed at a time with SIMD
+ */
+
+template <class Operation>
+class VerticalPassBody : public ParallelLoopBody {
+public:
+   VerticalPassBody(const Mat &image, Mat &result, int size, Mat &forward, Mat &backward) :
+      image_(image), result_(result), size_(size), forward_(forward), backward_(backward), border_(image.cols, Operation::border) {
+   }
+
+   /* row i of the padded image */
+
+   const uchar *paddedRow(int i) const {
+      int row = i - size_ / 2;
+      return row >= 0 && row < image_.rows ? image_.ptr<uchar>(row) : &border_[0];
+   }
+
+   /* out = op(a, b) for columns start to end */
+
+   void combine(const uchar *a, const uchar *b, uchar *out, int start, int end) const {
+      Operation op;
+      int col = start;
+
+#if CV_SIMD128
+      for ( ; col <= end - 16; col += 16) {
+         v_store(out + col, op(v_load(a + col), v_load(b + col)));
+      }
+#endif
+      for ( ; col < end; col++) {
+         out[col] = op(a[col], b[col]);
+      }
+   }
+
+   virtual void operator()(const Range &range) const {
+      int start = range.start * COLUMN_BAND_WIDTH;
+      int end   = min(range.end * COLUMN_BAND_WIDTH, image_.cols);
+      int length = forward_.rows;
+      int i, block, row;
+
+      for (block = 0; block < length; block += size_) {
+         memcpy(forward_.ptr<uchar>(block) + start, paddedRow(block) + start, end - start);
+         for (i = block + 1; i < block + size_; i++) {
+            combine(forward_.ptr<uchar>(i - 1), paddedRow(i), forward_.ptr<uchar>(i), start, end);
+         }
+
+         i = block + size_ - 1;
+         memcpy(backward_.ptr<uchar>(i) + start, paddedRow(i) + start, end - start);
+         for (i = i - 1; i >= block; i--) {
+            combine(backward_.ptr<uchar>(i + 1), paddedRow(i), backward_.ptr<uchar>(i), start, end);
+         }
+      }
+
+      for (row = 0; row < image_.rows; row++) {
+         combine(backward_.ptr<uchar>(row), forward_.ptr<uchar>(row + size_ - 1), result_.ptr<uchar>(row), start, end);
+      }
+   }
+
+private:
+   const Mat    &image_;
+   Mat          &result_;
+   int           size_;
+   Mat          &forward_;
+   Mat          &backward_;
+   vector<uchar> border_;
+};
+
+
+/*
+ * rectangleFilter
+ * Separable van Herk / Gil-Werman erosion or dilation of an 8-bit image; the result may be the input image
+ */
+
+template <class Operation>
+static void rectangleFilter(const Mat &image, Mat &result, Size kernel_size, morphologyWorkspaceType *workspace) {
+
+   int length;
+
+   CV_Assert(image.type() == CV_8UC1 && kernel_size.width % 2 == 1 && kernel_size.height % 2 == 1);
+
+   workspace->intermediate.create(image.size(), CV_8UC1);
+
+   if (kernel_size.width > 1) {
+      parallel_for_(Range(0, image.rows), HorizontalPassBody<Operation>(image, workspace->intermediate, kernel_size.width));
+   }
+   else {
+      image.copyTo(workspace->intermediate);
+   }
+
+   result.create(image.size(), CV_8UC1);
+
+   if (kernel_size.height > 1) {
+      length = ((image.rows + kernel_size.height - 1 + kernel_size.height - 1) / kernel_size.height) * kernel_size.height;
+      workspace->forward.create(length, image.cols, CV_8UC1);
+      workspace->backward.create(length, image.cols, CV_8UC1);
+
+      parallel_for_(Range(0, (image.cols + COLUMN_BAND_WIDTH - 1) / COLUMN_BAND_WIDTH),
+                    VerticalPassBody<Operation>(workspace->intermediate, result, kernel_size.height, workspace->forward, workspace->backward));
+   }
+   else {
+      workspace->intermediate.copyTo(result);
+   }
+}
+
+
+void erodeRectangle(const Mat &image, Mat &eroded_image, Size kernel_size, morphologyWorkspaceType *workspace) {
+   rectangleFilter<minimumOperation>(image, eroded_image, kernel_size, workspace);
+}
+
+void dilateRectangle(const Mat &image, Mat &dilated_image, Size kernel_size, morphologyWorkspaceType *workspace) {
+   rectangleFilter<maximumOperation>(image, dilated_image, kernel_size, workspace);
+}
+
+
+/*=======================================================*/
+/* Compositions                                          */
+/*=======================================================*/
+
+/*
+ * Each composition keeps its first result in the stage buffer of the workspace, so that no image is allocated
+ * once the workspace has been used with an image of the same size
+ */
+
+void openRectangle(const Mat &image, Mat &opened_image, Size kernel_size, morphologyWorkspaceType *workspace) {
+   erodeRectangle(image, workspace->stage, kernel_size, workspace);
+   dilateRectangle(workspace->stage, opened_image, kernel_size, workspace);
+}
+
+void closeRectangle(const Mat &image, Mat &closed_image, Size kernel_size, morphologyWorkspaceType *workspace) {
+   dilateRectangle(image, workspace->stage, kernel_size, workspace);
+   erodeRectangle(workspace->stage, closed_image, kernel_size, workspace);
+}
+
+/* dilation minus erosion */
+
+void morphologicalGradient(const Mat &image, Mat &gradient_image, Size kernel_size, morphologyWorkspaceType *workspace) {
+   dilateRectangle(image, workspace->stage, kernel_size, workspace);
+   erodeRectangle(image, gradient_image, kernel_size, workspace);
+   subtract(workspace->stage, gradient_image, gradient_image);
+}
+
+/* image minus its opening: bright details smaller than the structuring element */
+
+void topHat(const Mat &image, Mat &top_hat_image, Size kernel_size, morphologyWorkspaceType *workspace) {
+   erodeRectangle(image, workspace->stage, kernel_size, workspace);
+   dilateRectangle(workspace->stage, workspace->stage, kernel_size, workspace);
+   subtract(image, workspace->stage, top_hat_image);
+}
+
+/* closing minus the image: dark details smaller than the structuring element */
+
+void blackHat(const Mat &image, Mat &black_hat_image, Size kernel_size, morphologyWorkspaceType *workspace) {
+   dilateRectangle(image, workspace->stage, kernel_size, workspace);
+   erodeRectangle(workspace->stage, workspace->stage, kernel_size, workspace);
+   subtract(workspace->stage, image, black_hat_image);
+}
+
+
+/*
+ * applyMorphology
+ * One of EROSION, DILATION, OPENING, CLOSING, GRADIENT, TOP_HAT, and BLACK_HAT
+ */
+
+void applyMorphology(const Mat &image, Mat &result_image, int operation, Size kernel_size, morphologyWorkspaceType *workspace) {
+
+   switch (operation) {
+   case EROSION:   erodeRectangle(image, result_image, kernel_size, workspace);        break;
+   case DILATION:  dilateRectangle(image, result_image, kernel_size, workspace);       break;
+   case OPENING:   openRectangle(image, result_image, kernel_size, workspace);         break;
+   case CLOSING:   closeRectangle(image, result_image, kernel_size, workspace);        break;
+   case GRADIENT:  morphologicalGradient(image, result_image, kernel_size, workspace); break;
+   case TOP_HAT:   topHat(image, result_image, kernel_size, workspace);                break;
+   case BLACK_HAT: blackHat(image, result_image, kernel_size, workspace);              break;
+   }
+}
+
+
+/*
+ * benchmarkMorphology
+ * Time erosion and opening with square structuring elements from 3 x 3 to 101 x 101, against openCV erode() and morphologyEx()
+ */
+
+void benchmarkMorphology(const Mat &image) {
+
+   const int sizes[] = {3, 5, 7, 11, 15, 21, 31, 41, 51, 75, 101};
+   const int repetitions = 5;
+   morphologyWorkspaceType workspace;
+   Mat result, reference, element;
+   double ticks, time, opencv_time, open_time, opencv_open_time;
+   unsigned int s;
+   int i;
+   bool same;
+
+   printf("   size     erode: van Herk   openCV      open: van Herk   openCV\n");
+
+   for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      element = getStructuringElement(MORPH_RECT, Size(sizes[s], sizes[s]));
+
+      erodeRectangle(image, result, Size(sizes[s], sizes[s]), &workspace);    // allocate the workspace
+
+      ticks = (double) getTickCount();
+      for (i = 0; i < repetitions; i++) erodeRectangle(image, result, Size(sizes[s], sizes[s]), &workspace);
+      time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / repetitions;
+
+      ticks = (double) getTickCount();
+      for (i = 0; i < repetitions; i++) erode(image, reference, element);
+      opencv_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / repetitions;
+
+      same = norm(result, reference, NORM_INF) == 0;
+
+      ticks = (double) getTickCount();
+      for (i = 0; i < repetitions; i++) openRectangle(image, result, Size(sizes[s], sizes[s]), &workspace);
+      open_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / repetitions;
+
+      ticks = (double) getTickCount();
+      for (i = 0; i < repetitions; i++) morphologyEx(image, reference, MORPH_OPEN, element);
+      opencv_open_time = ((double) getTickCount() - ticks) * 1000 / getTickFrequency() / repetitions;
+
+      same = same && norm(result, reference, NORM_INF) == 0;
+
+      printf("   %3d x %-3d      %8.3f ms %8.3f ms       %8.3f ms %8.3f ms%s\n", sizes[s], sizes[s],
+             time, opencv_time, open_time, opencv_open_time, same ? "" : "   (the results differ)");
+   }
+}
+
+
+/*=======================================================*/
+/* Trackbar callback                                     */
+/*=======================================================*/
+
+/*
+ * function morphology
+ * Trackbar callback - operation and structuring element size user input
+*/
+
+void morphology(int, void*) {
+
+   extern Mat inputImage;
+   extern int operation;
+   extern int kernelRadius;
+   extern char* morphology_window_name;
+   static morphologyWorkspaceType workspace;
+   Mat greyscaleImage;
+   Mat resultImage;
+
+   if (inputImage.type() == CV_8UC3) { // colour image
+      cvtColor(inputImage, greyscaleImage, CV_BGR2GRAY);
+   }
+   else {
+      greyscaleImage = inputImage;
+   }
+
+   applyMorphology(greyscaleImage, resultImage, operation, Size(2 * kernelRadius + 1, 2 * kernelRadius + 1), &workspace);
+
+   imshow(morphology_window_name, resultImage);
+}
+
+
+/*=======================================================*/
+/* Utility functions                                     */ 
+/*=======================================================*/
+
+void prompt_and_exit(int status) {
+   printf("Press any key to continue and close terminal ... \n");
+   getchar();
+
+   #ifdef ROS
+      // Reset terminal to canonical mode
+      static const int STDIN = 0;
+      termios term;
+      tcgetattr(STDIN, &term);
+      term.c_lflag |= (ICANON | ECHO);
+      tcsetattr(STDIN, TCSANOW, &term);
+      exit(status);
+   #endif
+
+   exit(status);
+}
+
+void prompt_and_continue() {
+   printf("Press any key to continue ... \n");
+   getchar();
+}
+
+
+#ifdef ROS
+/**
+ Linux (POSIX) implementation of _kbhit().
+ Morgan McGuire, morgan@cs.brown.edu
+ */
+int _kbhit() {
+    static const int STDIN = 0;
+    static bool initialized = false;
+
+    if (! initialized) {
+        // Use termios to turn off line buffering
+        termios term;
+        tcgetattr(STDIN, &term);
+        term.c_lflag &= ~ICANON;
+        tcsetattr(STDIN, TCSANOW, &term);
+        setbuf(stdin, NULL);
+        initialized = true;
+    }
+
+    int bytesWaiting;
+    ioctl(STDIN, FIONREAD, &bytesWaiting);
+    return bytesWaiting;
+}
+#endif
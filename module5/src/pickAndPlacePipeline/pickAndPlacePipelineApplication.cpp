@@ -0,0 +1,163 @@
+/*******************************************************************************************************************
+*   Vision-guided pick-and-place pipeline for a LynxMotion AL5D robot arm
+*   ---------------------------------------------------------------------
+*
+*   This application finds coloured bricks with the lynxmotion_al5d_description simulator camera and picks and places
+*   them with the simulator robot, without reading the brick poses from a file.
+*
+*   The camera, perception, and the arm run as separate stages connected by bounded queues, so that the next brick is
+*   found while the current one is being picked (see pickAndPlacePipelineImplementation.cpp).  The perception stage
+*   segments the bricks by colour, computes the centroid and orientation of each one from its moments with the detector
+*   of the brickDetection application, and maps them to the ground plane (z = 0) with the camera model computed by the
+*   cameraModel application, as in the cameraInvPerspectiveMonocular application.  When the pipeline stops,
+*   the latency percentiles of each stage and end-to-end are printed.
+*
+*   The input file pickAndPlacePipelineInput.txt contains
+*
+*   - the robot configuration filename
+*   - the camera model filename
+*   - the number of bricks to pick and place (0 to continue until no more bricks are found)
+*   - the minimum and maximum area of a brick in pixels
+*   - the minimum and maximum aspect ratio of a brick, i.e. the ratio of its length to its width
+*   - the z coordinate of the bricks passed to pickAndPlace()
+*   - the number of brick colours, followed by one line for each colour with the colour name, the minimum and maximum
+*     hue (0 to 180; the range wraps through 0 if the minimum is greater than the maximum), the minimum saturation,
+*     and the x, y, z, and phi of the destination for bricks of that colour
+*
+*   16 October 2026
+*
+*******************************************************************************************************************/
+
+#include <module5/pickAndPlacePipeline.h>
+
+Mat scene_image;
+pipelineType pipeline;
+
+int main(int argc, char ** argv) {
+
+   ros::init(argc, argv, "pickAndPlacePipeline"); // Initialize the ROS system
+
+   extern robotConfigurationDataType robotConfigurationData;
+
+   bool debug = true;
+
+   FILE *fp_in;
+   FILE *fp_camera_model;
+   char robot_configuration_filename[MAX_FILENAME_LENGTH];
+   char camera_model_filename[MAX_FILENAME_LENGTH];
+   char filename[MAX_FILENAME_LENGTH] = {};
+   char directory[MAX_FILENAME_LENGTH] = {};
+   double inverse_homography[3][3];
+   int  max_bricks;
+   int  c, i, j;
+   double start_time;
+   brickColourType *colour;
+   BrickPose *destination;
+
+   strcat(directory, (ros::package::getPath(ROS_PACKAGE_NAME) + "/data/").c_str());
+
+   strcpy(filename, directory);
+   strcat(filename, "pickAndPlacePipelineInput.txt"); // Input filename matches the application name
+   if ((fp_in = fopen(filename, "r")) == 0) {
+      printf("Error can't open input pickAndPlacePipelineInput.txt\n");
+      prompt_and_exit(1);
+   }
+
+   if (fscanf(fp_in, "%s %s %d %d %d %lf %lf %f %d", robot_configuration_filename, camera_model_filename, &max_bricks,
+              &pipeline.detector.min_area, &pipeline.detector.max_area,
+              &pipeline.detector.min_aspect_ratio, &pipeline.detector.max_aspect_ratio,
+              &pipeline.object_z, &pipeline.detector.number_of_colours) != 9 ||
+       pipeline.detector.number_of_colours < 1 || pipeline.detector.number_of_colours > MAX_NUMBER_OF_COLOURS) {
+      printf("Error reading pickAndPlacePipelineInput.txt\n");
+      prompt_and_exit(1);
+   }
+
+   for (c = 0; c < pipeline.detector.number_of_colours; c++) {
+      colour      = &pipeline.detector.colours[c];
+      destination = &pipeline.destinations[c];
+      if (fscanf(fp_in, "%19s %d %d %d %f %f %f %f", colour->name, &colour->hue_min, &colour->hue_max, &colour->saturation_min,
+                 &destination->x, &destination->y, &destination->z, &destination->phi) != 8) {
+         printf("Error reading colour %d from pickAndPlacePipelineInput.txt\n", c + 1);
+         prompt_and_exit(1);
+      }
+      pipeline.number_placed[c] = 0;
+
+      if (debug) printf("%-8s hue %3d to %3d, saturation >= %3d, destination (%6.1f, %6.1f, %6.1f) phi %6.1f\n",
+                        colour->name, colour->hue_min, colour->hue_max, colour->saturation_min,
+                        destination->x, destination->y, destination->z, destination->phi);
+   }
+   fclose(fp_in);
+
+   buildColourLUT(&pipeline.detector);
+
+
+   /* get the robot configuration data and the camera model */
+   /* ----------------------------------------------------- */
+
+   strcpy(filename, directory);
+   strcat(filename, robot_configuration_filename);
+   readRobotConfigurationData(filename);
+
+   strcpy(filename, directory);
+   strcat(filename, camera_model_filename);
+   if ((fp_camera_model = fopen(filename, "r")) == 0) {
+      printf("Error can't open camera model for input %s\n", filename);
+      prompt_and_exit(1);
+   }
+
+   for (i = 0; i < 3; i++) {
+      for (j = 0; j < 4; j++) {
+         if (fscanf(fp_camera_model, "%f ", &(pipeline.camera_model[i][j])) != 1) {
+            printf("Error can't read the camera model %s\n", filename);
+            prompt_and_exit(1);
+         }
+      }
+   }
+   fclose(fp_camera_model);
+
+   if (!computeGroundPlaneHomography(pipeline.camera_model, 0, inverse_homography)) {
+      printf("Error the camera model can't be inverted for the ground plane\n");
+      prompt_and_exit(1);
+   }
+
+   pipeline.frames_received  = 0;
+   pipeline.frames_processed = 0;
+
+
+   /* start the stages: the camera on its own callback queue, perception on its own thread, and the arm on this one */
+   /* ------------------------------------------------------------------------------------------------------------- */
+
+   printf("Moving robot out of field of view\n");
+   leave_field_of_view();
+
+   ros::NodeHandle nh;
+   ros::CallbackQueue camera_queue;
+   nh.setCallbackQueue(&camera_queue);
+
+   image_transport::ImageTransport it(nh);
+   image_transport::Subscriber sub = it.subscribe("/lynxmotion_al5d/external_vision/image_raw", 1, imageMessageReceived);
+
+   ros::AsyncSpinner camera_spinner(1, &camera_queue);
+   camera_spinner.start();
+
+   start_time = pipelineTime();
+
+   std::thread perception(perceptionStage, &pipeline);
+
+   executionStage(&pipeline, max_bricks);
+
+
+   /* stop the stages and report */
+   /* -------------------------- */
+
+   camera_spinner.stop();
+   pipeline.frames.close();
+   pipeline.poses.close();
+   perception.join();
+
+   printPipelineReport(&pipeline, pipelineTime() - start_time);
+
+   leave_field_of_view();
+
+   return 0;
+}
@@ -0,0 +1,593 @@
+/*******************************************************************************************************************
+*   Vision-guided pick-and-place pipeline for a LynxMotion AL5D robot arm
+*
+*   Implementation file
+*
+*   16 October 2026
+*
+********************************************************************************************************************/
+
+#include <module5/pickAndPlacePipeline.h>
+
+
+/*
+ * Pipeline
+ * --------
+ *
+ *   camera callback  --frames-->  perception thread  --poses-->  arm executor (main thread)
+ *
+ * - the camera callback runs on its own spinner thread and callback queue, so images keep arriving while the arm moves;
+ *   the frame queue holds the latest FRAME_QUEUE_CAPACITY images and drops the oldest, so perception always works on
+ *   a recent image
+ * - the perception thread segments the bricks by colour, computes the centroid and principal-axis orientation of each
+ *   blob from its moments, as in the brickDetection application, and maps them to the ground plane with the inverse
+ *   homography of the camera model, as in the cameraInvPerspectiveMonocular application; a brick
+ *   is handed to the arm once it has been seen at the same place in STABLE_FRAMES successive frames, so that bricks
+ *   that are moving, e.g. while being carried, are ignored
+ * - the arm executor picks each brick and places it at the destination for its colour; while it does so, perception
+ *   of the next brick continues, and the pose queue applies back-pressure if the arm falls POSE_QUEUE_CAPACITY bricks
+ *   behind
+ *
+ * The latency of each stage and end-to-end is recorded and reported as percentiles at the end.
+ */
+
+extern pipelineType pipeline;
+
+
+double pipelineTime() {
+    return (double) getTickCount() / getTickFrequency();
+}
+
+
+/***************************************************************************************************************************
+
+   Brick detector: copied from brickDetectionImplementation.cpp
+
+****************************************************************************************************************************/
+
+/*=======================================================*/
+/* Colour classification                                 */
+/*=======================================================*/
+
+/*
+ * buildColourLUT
+ * Fill the 180 x 256 hue-saturation table with the index of the colour of each hue and saturation, or NO_COLOUR,
+ * so that each pixel is classified by one table look-up whatever the number of colours
+ */
+
+void buildColourLUT(brickDetectorType *detector) {
+
+   int hue, saturation, c;
+   bool in_range;
+   brickColourType *colour;
+
+   detector->colour_lut = Mat(180, 256, CV_8U, Scalar(NO_COLOUR));
+
+   for (c = detector->number_of_colours - 1; c >= 0; c--) {   // the first colour wins where ranges overlap
+      colour = &detector->colours[c];
+
+      for (hue = 0; hue < 180; hue++) {
+         if (colour->hue_min <= colour->hue_max) {
+            in_range = hue >= colour->hue_min && hue <= colour->hue_max;
+         }
+         else {
+            in_range = hue >= colour->hue_min || hue <= colour->hue_max;
+         }
+
+         if (in_range) {
+            for (saturation = colour->saturation_min; saturation < 256; saturation++) {
+               detector->colour_lut.at<uchar>(hue, saturation) = (uchar) c;
+            }
+         }
+      }
+   }
+}
+
+
+/*
+ * classifyColours
+ * Colour index of each pixel of a BGR image
+ */
+
+void classifyColours(const Mat &bgr_image, const Mat &colour_lut, Mat &colour_index) {
+
+   Mat hsv_image;
+   const uchar *hsv;
+   uchar *index;
+   int row, col;
+
+   cvtColor(bgr_image, hsv_image, CV_BGR2HSV);
+   colour_index.create(bgr_image.rows, bgr_image.cols, CV_8U);
+
+   for (row = 0; row < hsv_image.rows; row++) {
+      hsv   = hsv_image.ptr<uchar>(row);
+      index = colour_index.ptr<uchar>(row);
+
+      for (col = 0; col < hsv_image.cols; col++, hsv += 3) {
+         if (hsv[2] < MIN_VALUE) {
+            index[col] = NO_COLOUR;
+         }
+         else {
+            index[col] = colour_lut.at<uchar>(hsv[0], hsv[1]);
+         }
+      }
+   }
+}
+
+
+/*=======================================================*/
+/* Blob geometry                                         */
+/*=======================================================*/
+
+/*
+ * accumulateBlobMoments
+ * Raw moments up to second order of every label, in one pass over the label image.
+ * The coordinates are taken relative to the top left of the bounding box of each label to keep the sums small.
+ */
+
+void accumulateBlobMoments(const Mat &labels, const Mat &stats, int number_of_labels, vector<blobMomentsType> &moments) {
+
+   const int *label;
+   blobMomentsType *m;
+   int row, col, l;
+   double x, y;
+
+   moments.assign(number_of_labels, blobMomentsType());
+
+   for (row = 0; row < labels.rows; row++) {
+      label = labels.ptr<int>(row);
+
+      for (col = 0; col < labels.cols; col++) {
+         l = label[col];
+         if (l == 0) continue;
+
+         m = &moments[l];
+         x = col - stats.at<int>(l, CC_STAT_LEFT);
+         y = row - stats.at<int>(l, CC_STAT_TOP);
+
+         m->m00 += 1;
+         m->m10 += x;
+         m->m01 += y;
+         m->m20 += x * x;
+         m->m11 += x * y;
+         m->m02 += y * y;
+      }
+   }
+}
+
+
+/*
+ * brickFromMoments
+ * Centroid, principal axis, and aspect ratio of a blob from its moments; returns false if the blob is not a brick
+ */
+
+bool brickFromMoments(const blobMomentsType &m, int colour, brickDetectorType *detector, brickType *brick) {
+
+   double u, v, mu20, mu11, mu02;
+   double common, lambda1, lambda2;
+   double aspect_ratio;
+   double phi;
+
+   if (m.m00 < detector->min_area || m.m00 > detector->max_area) {
+      return false;
+   }
+
+   /* centroid and central moments */
+
+   u    = m.m10 / m.m00;
+   v    = m.m01 / m.m00;
+   mu20 = m.m20 / m.m00 - u * u;
+   mu11 = m.m11 / m.m00 - u * v;
+   mu02 = m.m02 / m.m00 - v * v;
+
+   /* eigenvalues of the covariance matrix: the variances along the principal axes */
+
+   common  = sqrt(4 * mu11 * mu11 + (mu20 - mu02) * (mu20 - mu02));
+   lambda1 = (mu20 + mu02 + common) / 2;
+   lambda2 = (mu20 + mu02 - common) / 2;
+
+   if (lambda2 <= 0) {
+      return false;                         // a line of pixels
+   }
+
+   aspect_ratio = sqrt(lambda1 / lambda2);   // ratio of length to width for a rectangle
+
+   if (aspect_ratio < detector->min_aspect_ratio || aspect_ratio > detector->max_aspect_ratio) {
+      return false;
+   }
+
+   phi = 0.5 * atan2(2 * mu11, mu20 - mu02) * 180 / CV_PI;
+   if (phi <= -90) phi += 180;
+
+   brick->colour       = colour;
+   brick->u            = (float) u;
+   brick->v            = (float) v;
+   brick->phi          = (float) phi;
+   brick->area         = (int) m.m00;
+   brick->aspect_ratio = (float) aspect_ratio;
+
+   return true;
+}
+
+
+/*
+ * detectBricks
+ * Bricks of each colour in a BGR image: colour classification, connected component labelling, and blob moments
+ */
+
+void detectBricks(const Mat &bgr_image, brickDetectorType *detector, vector<brickType> &bricks) {
+
+   static Mat opening_element = getStructuringElement(MORPH_RECT, Size(3, 3));
+
+   Mat colour_index, mask, labels, stats, centroids;
+   vector<blobMomentsType> moments;
+   brickType brick;
+   int c, l, number_of_labels;
+
+   bricks.clear();
+
+   classifyColours(bgr_image, detector->colour_lut, colour_index);
+
+   for (c = 0; c < detector->number_of_colours; c++) {
+      compare(colour_index, Scalar(c), mask, CMP_EQ);
+      morphologyEx(mask, mask, MORPH_OPEN, opening_element);
+
+      number_of_labels = connectedComponentsWithStats(mask, labels, stats, centroids, 8, CV_32S);
+
+      accumulateBlobMoments(labels, stats, number_of_labels, moments);
+
+      for (l = 1; l < number_of_labels; l++) {
+         if (brickFromMoments(moments[l], c, detector, &brick)) {
+            brick.u += stats.at<int>(l, CC_STAT_LEFT);
+            brick.v += stats.at<int>(l, CC_STAT_TOP);
+            bricks.push_back(brick);
+         }
+      }
+   }
+}
+
+
+/***************************************************************************************************************************
+
+   Ground-plane mapping: copied from cameraInvPerspectiveMonocularImplementation.cpp
+
+****************************************************************************************************************************/
+
+/*
+ * computeGroundPlaneHomography
+ * Compute the inverse homography H^-1 from image coordinates to world (x, y) coordinates on the plane z
+ * Returns false if the camera model is degenerate for this plane
+ */
+
+bool computeGroundPlaneHomography(float camera_model[][4], float z, double inverse_homography[][3]) {
+
+   double h[3][3];
+   double det;
+   int i, j;
+
+   for (i=0; i<3; i++) {
+      h[i][0] = camera_model[i][0];
+      h[i][1] = camera_model[i][1];
+      h[i][2] = camera_model[i][2] * z + camera_model[i][3];
+   }
+
+   det = h[0][0] * (h[1][1] * h[2][2] - h[1][2] * h[2][1])
+       - h[0][1] * (h[1][0] * h[2][2] - h[1][2] * h[2][0])
+       + h[0][2] * (h[1][0] * h[2][1] - h[1][1] * h[2][0]);
+
+   if (fabs(det) < 1e-12) {
+      return false;
+   }
+
+   /* inverse = adjugate / determinant */
+
+   inverse_homography[0][0] =  (h[1][1] * h[2][2] - h[1][2] * h[2][1]) / det;
+   inverse_homography[0][1] = -(h[0][1] * h[2][2] - h[0][2] * h[2][1]) / det;
+   inverse_homography[0][2] =  (h[0][1] * h[1][2] - h[0][2] * h[1][1]) / det;
+   inverse_homography[1][0] = -(h[1][0] * h[2][2] - h[1][2] * h[2][0]) / det;
+   inverse_homography[1][1] =  (h[0][0] * h[2][2] - h[0][2] * h[2][0]) / det;
+   inverse_homography[1][2] = -(h[0][0] * h[1][2] - h[0][2] * h[1][0]) / det;
+   inverse_homography[2][0] =  (h[1][0] * h[2][1] - h[1][1] * h[2][0]) / det;
+   inverse_homography[2][1] = -(h[0][0] * h[2][1] - h[0][1] * h[2][0]) / det;
+   inverse_homography[2][2] =  (h[0][0] * h[1][1] - h[0][1] * h[1][0]) / det;
+
+   for (i=0; i<3; i++) {
+      for (j=0; j<3; j++) {
+         if (cvIsNaN(inverse_homography[i][j]) || cvIsInf(inverse_homography[i][j])) {
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+
+/*
+ * inversePerspectiveTransformationBatch
+ * Inverse perspective transformation of an arbitrary array of image points onto the plane z
+ * Returns false if the camera model is degenerate for this plane
+ */
+
+bool inversePerspectiveTransformationBatch(const vector<Point2f> &image_points,
+                                           float camera_model[][4],
+                                           float z,
+                                           vector<Point3f> &world_points) {
+
+   double hi[3][3];
+   double w;
+   int i;
+
+   if (!computeGroundPlaneHomography(camera_model, z, hi)) {
+      return false;
+   }
+
+   world_points.resize(image_points.size());
+
+   for (i=0; i<(int)image_points.size(); i++) {
+      w = hi[2][0] * image_points[i].x + hi[2][1] * image_points[i].y + hi[2][2];
+
+      world_points[i].x = (float) ((hi[0][0] * image_points[i].x + hi[0][1] * image_points[i].y + hi[0][2]) / w);
+      world_points[i].y = (float) ((hi[1][0] * image_points[i].x + hi[1][1] * image_points[i].y + hi[1][2]) / w);
+      world_points[i].z = z;
+   }
+
+   return true;
+}
+
+
+/*
+ * locateBricks
+ * Bricks of each colour in the image, with their positions and orientations on the ground plane
+ */
+
+void locateBricks(const Mat &image, pipelineType *pipeline, vector<brickMessageType> &bricks) {
+
+    vector<brickType> image_bricks;
+    vector<Point2f>   image_points;
+    vector<Point3f>   world_points;
+    brickMessageType  brick;
+    Point2f centroid, axis;
+    double phi;
+    size_t i;
+
+    bricks.clear();
+
+    detectBricks(image, &pipeline->detector, image_bricks);
+
+    /* map the centroid and a point on the principal axis of each brick to the ground plane */
+
+    for (i = 0; i < image_bricks.size(); i++) {
+        centroid = Point2f(image_bricks[i].u, image_bricks[i].v);
+        axis     = Point2f((float) cos(image_bricks[i].phi * CV_PI / 180), (float) sin(image_bricks[i].phi * CV_PI / 180));
+        image_points.push_back(centroid);
+        image_points.push_back(centroid + axis * (float) ORIENTATION_OFFSET);
+    }
+
+    if (!inversePerspectiveTransformationBatch(image_points, pipeline->camera_model, 0, world_points)) {
+        return;
+    }
+
+    for (i = 0; i < image_bricks.size(); i++) {
+        phi = atan2(world_points[2 * i + 1].y - world_points[2 * i].y, world_points[2 * i + 1].x - world_points[2 * i].x) * 180 / CV_PI;
+        if (phi >   90) phi -= 180;
+        if (phi <= -90) phi += 180;
+
+        brick.colour   = image_bricks[i].colour;
+        brick.pose.x   = world_points[2 * i].x;
+        brick.pose.y   = world_points[2 * i].y;
+        brick.pose.z   = pipeline->object_z;
+        brick.pose.phi = (float) phi;
+        bricks.push_back(brick);
+    }
+}
+
+
+/*
+ * imageMessageReceived
+ * Camera stage: hand the latest image to perception
+ */
+
+void imageMessageReceived(const sensor_msgs::ImageConstPtr& msg) {
+    cv_bridge::CvImagePtr cv_ptr;
+    frameType frame;
+
+    frame.capture_time = pipelineTime();
+
+    try {
+        cv_ptr = cv_bridge::toCvCopy(msg, sensor_msgs::image_encodings::BGR8);
+    }
+    catch (cv_bridge::Exception& e) {
+        ROS_ERROR("cv_bridge exception: %s", e.what());
+        return;
+    }
+
+    frame.image = cv_ptr->image;
+    pipeline.frames.pushLatest(frame);
+
+    std::lock_guard<std::mutex> lock(pipeline.mutex);
+    pipeline.frames_received++;
+}
+
+
+/*
+ * perceptionStage
+ * Perception thread: detect bricks in each frame and hand each brick that is stable and not yet handled to the arm
+ */
+
+struct candidateType {
+    brickMessageType brick;
+    int              count;      // number of successive frames in which the brick has been seen here
+    bool             seen;       // seen in the current frame
+};
+
+static bool is_excluded(pipelineType *pipeline, const BrickPose &pose) {
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+
+    for (size_t i = 0; i < pipeline->excluded.size(); i++) {
+        if (norm(pipeline->excluded[i] - Point2f(pose.x, pose.y)) < EXCLUSION_DISTANCE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void perceptionStage(pipelineType *pipeline) {
+
+    frameType frame;
+    vector<brickMessageType> bricks;
+    vector<candidateType>    candidates, next_candidates;
+    candidateType candidate;
+    double start_time, end_time;
+    size_t i, j;
+
+    while (true) {
+
+        if (!pipeline->frames.pop(frame, 1.0)) {
+            if (pipeline->frames.closed()) break;
+            continue;
+        }
+
+        start_time = pipelineTime();
+        locateBricks(frame.image, pipeline, bricks);
+        end_time = pipelineTime();
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline->mutex);
+            pipeline->latency.frame_wait.push_back((start_time - frame.capture_time) * 1000);
+            pipeline->latency.perception.push_back((end_time - start_time) * 1000);
+            pipeline->frames_processed++;
+        }
+
+        /* track the bricks from frame to frame; candidates not seen in this frame are dropped */
+
+        next_candidates.clear();
+
+        for (i = 0; i < bricks.size(); i++) {
+            candidate.brick = bricks[i];
+            candidate.count = 1;
+
+            for (j = 0; j < candidates.size(); j++) {
+                if (!candidates[j].seen && candidates[j].brick.colour == bricks[i].colour &&
+                    norm(Point2f(candidates[j].brick.pose.x - bricks[i].pose.x, candidates[j].brick.pose.y - bricks[i].pose.y)) < MATCH_DISTANCE) {
+                    candidates[j].seen = true;
+                    candidate.count = candidates[j].count + 1;
+                    break;
+                }
+            }
+
+            if (candidate.count == STABLE_FRAMES && !is_excluded(pipeline, candidate.brick.pose)) {
+                {
+                    std::lock_guard<std::mutex> lock(pipeline->mutex);
+                    pipeline->excluded.push_back(Point2f(candidate.brick.pose.x, candidate.brick.pose.y));
+                }
+
+                candidate.brick.capture_time   = frame.capture_time;
+                candidate.brick.perceived_time = pipelineTime();
+
+                printf("Found %s brick at (%6.1f, %6.1f) phi %6.1f\n", pipeline->detector.colours[candidate.brick.colour].name,
+                       candidate.brick.pose.x, candidate.brick.pose.y, candidate.brick.pose.phi);
+
+                if (!pipeline->poses.push(candidate.brick)) break;      // closed while waiting for the arm
+            }
+
+            candidate.seen = false;
+            next_candidates.push_back(candidate);
+        }
+
+        candidates.swap(next_candidates);
+    }
+}
+
+
+/*
+ * executionStage
+ * Arm executor: pick each brick handed over by perception and place it at the destination for its colour;
+ * stops after max_bricks bricks (0 for no limit) or when no brick has been found for IDLE_TIMEOUT seconds
+ */
+
+void executionStage(pipelineType *pipeline, int max_bricks) {
+
+    brickMessageType brick;
+    brickColourType *colour;
+    BrickPose destination;
+    double start_time, end_time;
+    int number_picked = 0;
+
+    while (ros::ok() && (max_bricks == 0 || number_picked < max_bricks)) {
+
+        if (!pipeline->poses.pop(brick, IDLE_TIMEOUT)) {
+            printf("No more bricks found\n");
+            break;
+        }
+
+        start_time = pipelineTime();
+
+        colour = &pipeline->detector.colours[brick.colour];
+        destination = pipeline->destinations[brick.colour];
+        destination.y += (float) (pipeline->number_placed[brick.colour] * PLACE_SPACING);
+        pipeline->number_placed[brick.colour]++;
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline->mutex);
+            pipeline->excluded.push_back(Point2f(destination.x, destination.y));
+        }
+
+        printf("Picking %s brick at (%6.1f, %6.1f) phi %6.1f and placing it at (%6.1f, %6.1f)\n", colour->name,
+               brick.pose.x, brick.pose.y, brick.pose.phi, destination.x, destination.y);
+
+        pickAndPlace(brick.pose.x,  brick.pose.y,  brick.pose.z,  brick.pose.phi,
+                     destination.x, destination.y, destination.z, destination.phi);
+
+        end_time = pipelineTime();
+        number_picked++;
+
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        pipeline->latency.pose_wait.push_back((start_time - brick.perceived_time) * 1000);
+        pipeline->latency.execution.push_back((end_time - start_time) * 1000);
+        pipeline->latency.end_to_end.push_back((end_time - brick.capture_time) * 1000);
+    }
+}
+
+
+/*
+ * printLatencyPercentiles
+ * Median, 90th and 99th percentile (nearest rank), and maximum of the latency samples of one stage
+ */
+
+static double percentile(const vector<double> &sorted, double p) {
+    int rank = (int) ceil(p / 100 * sorted.size()) - 1;
+
+    if (rank < 0) rank = 0;
+    return sorted[rank];
+}
+
+void printLatencyPercentiles(const char *stage, vector<double> samples) {
+
+    if (samples.empty()) {
+        printf("%-24s %6d\n", stage, 0);
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    printf("%-24s %6d %10.1f %10.1f %10.1f %10.1f\n", stage, (int) samples.size(),
+           percentile(samples, 50), percentile(samples, 90), percentile(samples, 99), samples.back());
+}
+
+void printPipelineReport(pipelineType *pipeline, double elapsed_time) {
+
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+
+    printf("\nPipeline latency (ms)\n");
+    printf("%-24s %6s %10s %10s %10s %10s\n", "stage", "n", "p50", "p90", "p99", "max");
+    printLatencyPercentiles("frame queue",  pipeline->latency.frame_wait);
+    printLatencyPercentiles("perception",   pipeline->latency.perception);
+    printLatencyPercentiles("pose queue",   pipeline->latency.pose_wait);
+    printLatencyPercentiles("pick and place", pipeline->latency.execution);
+    printLatencyPercentiles("end to end",   pipeline->latency.end_to_end);
+
+    printf("\nFrames received %ld, processed %ld, dropped %ld; %.1f frames per second processed over %.1f s\n",
+           pipeline->frames_received, pipeline->frames_processed, pipeline->frames.dropped(),
+           elapsed_time > 0 ? pipeline->frames_processed / elapsed_time : 0.0, elapsed_time);
+}
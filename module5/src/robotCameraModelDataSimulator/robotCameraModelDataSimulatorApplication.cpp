@@ -49,6 +49,15 @@
   Once the above steps are completed for the top-left and bottom-right control points the coordinates of the remaining
   points are computed using linear interpolation and written to file.
 
+  If automatic is set to true (the default), no keyboard input is needed: the application subscribes to the simulator
+  camera and drives the gripper onto the top-left and bottom-right control points by visual servoing, i.e. it locates the
+  gripper in the camera image, computes the pixel error to the control point, and takes proportional steps in x and y
+  until the gripper is on the control point (see collectControlPointsAutomatically()).  If the servoing fails, the
+  application falls back to the manual procedure described above.
+
+  Added the automatic mode; leave_field_of_view() is copied from moveRobotImplementation.cpp.
+  16 October 2026
+
 */
 
 #include "module5/robotCameraModelDataSimulator.h"
@@ -84,7 +93,7 @@ int main(int argc, char** argv) {
    char filename[MAX_FILENAME_LENGTH];
 
    float cameraX, cameraY, cameraZ;
-   float boardZ;
+   float boardZ = 0;     // the world control points are written with z = 0
    float gripperX, gripperY, gripperZ;
    float stepSize = 5.0;
    float boxsize;
@@ -93,6 +102,8 @@ int main(int argc, char** argv) {
    int nPointsX, nPointsY;
 
    bool showCheckerboard = true;
+   bool automatic        = true;  // find the control points by visual servoing rather than from keyboard input
+   bool collected        = false;
 
    FILE *fp_in;
    FILE *fp_control_points;
@@ -110,6 +121,14 @@ int main(int argc, char** argv) {
 
    ros::init(argc, argv, "robotCameraModelDataSimulator");
 
+   ros::NodeHandle nh;
+   image_transport::ImageTransport it(nh);
+   image_transport::Subscriber sub;
+
+   if (automatic) {
+      sub = it.subscribe("/lynxmotion_al5d/external_vision/image_raw", 1, imageMessageReceived);
+   }
+
 
    if ((fp_in = fopen(input_path_and_filename,"r")) == 0) {
 	  printf("Error can't open input robotCameraModelDataSimulatorInput.txt\n");
@@ -158,117 +177,133 @@ int main(int argc, char** argv) {
                            prompt_and_exit(1);
                        }
 
-                       spawn_checkerboard(checkerboard_sdf_filename, cameraX / 1000, cameraY / 1000,
-                                          boardZ / 1000, 0, 0, 0);
-
                        controlPointCoordinates[0][0] = cameraX - (nPointsX - 1) * boxsize / 2;
                        controlPointCoordinates[0][1] = cameraY + (nPointsY - 1) * boxsize / 2;
                        controlPointCoordinates[1][0] = cameraX + (nPointsX - 1) * boxsize / 2;
                        controlPointCoordinates[1][1] = cameraY - (nPointsY - 1) * boxsize / 2;
 
-                       printf("\n*************************************************************\n");
-                       printf("* Please ensure CAPS LOCK is OFF                            *\n");
-                       printf("* Press key w to move to in the positive Y direction        *\n");
-                       printf("* Press key s to move to in the negative Y direction        *\n");
-                       printf("* Press key d to move to in the positive X direction        *\n");
-                       printf("* Press key a to move to in the negative X direction        *\n");
-                       printf("* Press key Shift + w to move to in the positive Z direction*\n");
-                       printf("* Press key Shift + s to move to in the negative Z direction*\n");
-                       printf("* Press e/c to increase decrease step size.                 *\n");
-                       printf("* Press SPACE to show/hide checkerboard.                    *\n");
-                       printf("* Press q to save and continue                              *\n");
-                       printf("*************************************************************\n");
-
-                       printf("\n Step size is currently %f\n", stepSize);
-
-                       for (int i = 0; i < 2; i++)
-                       {
-                           gripperX = controlPointCoordinates[i][0];
-                           gripperY = controlPointCoordinates[i][1];
-                           gripperZ = 0;
-
-                           spawn_model(cylinder_sdf_filename, LINE_MODEL_NAME, gripperX / 1000, gripperY / 1000,
-                                       0.5, 0, 0, 0);
-
-                           moveToCoordinates(gripperX, gripperY, 0, 0);
-
-
-                           char c;
-
-                           do {
-                               printf("Use wasd to move robot:\n");
-                               c = getchar();
-                               //printf("%c", c);int
-                               switch (c)
-                               {
-                                   case 'w':
-                                       printf("Moving to positive y\n");
-                                       fineAdjustmentMove(gripperX, gripperY + stepSize, gripperZ, 0);
-                                       gripperY += stepSize;
-                                       break;
-                                   case 'a':
-                                       printf("Moving to negative x\n");
-                                       fineAdjustmentMove(gripperX - stepSize, gripperY, gripperZ, 0);
-                                       gripperX -= stepSize;
-                                       break;
-                                   case 's':
-                                       printf("Moving to positive x\n");
-                                       fineAdjustmentMove(gripperX, gripperY - stepSize, gripperZ, 0);
-                                       gripperY -= stepSize;
-                                       break;
-                                   case 'd':
-                                       printf("Moving to negative y\n");
-                                       fineAdjustmentMove(gripperX + stepSize, gripperY, gripperZ, 0);
-                                       gripperX += stepSize;
-                                       break;
-                                   case 'W':
-                                       printf("Moving to positive z\n");
-                                       fineAdjustmentMove(gripperX, gripperY, gripperZ + stepSize, 0);
-                                       gripperZ += stepSize;
-                                       break;
-                                   case 'S':
-                                       printf("Moving to negative z\n");
-                                       fineAdjustmentMove(gripperX, gripperY, gripperZ - stepSize, 0);
-                                       gripperZ -= stepSize;
-                                       break;
-                                   case 'e':
-                                       stepSize += 1;
-                                       printf("\nStep size now set to %f\n", stepSize);
-                                       break;
-                                   case 'c':
-                                       stepSize -= 1;
-                                       if (stepSize < 1)
-                                       {
-                                           stepSize = 1;
-                                       }
-                                       printf("\nStep size now set to %f\n", stepSize);
-                                       break;
-                                   case ' ':
-                                       if (showCheckerboard)
-                                       {
-                                           delete_checkerboard();
-                                           showCheckerboard = false;
-                                       }
-                                       else
-                                       {
-                                           spawn_checkerboard(checkerboard_sdf_filename, cameraX / 1000, cameraY / 1000,
-                                                              boardZ / 1000, 0, 0, 0);
-                                           showCheckerboard = true;
-                                       }
-                                       break;
-
-                               }
-                           } while (c != 'q');
-                           // printf("(%f, %f)", gripperX, gripperY);
-                           controlPointCoordinates[i][0] = gripperX;
-                           controlPointCoordinates[i][1] = gripperY;
-
-                           delete_model(LINE_MODEL_NAME);
+                       if (automatic) {
+                           collected = collectControlPointsAutomatically(checkerboard_sdf_filename, cameraX, cameraY, cameraZ,
+                                                                         boardZ, nPointsX, nPointsY, boxsize,
+                                                                         controlPointCoordinates);
+                           if (!collected) {
+                               printf("Automatic collection failed: please position the robot manually\n");
+                               controlPointCoordinates[0][0] = cameraX - (nPointsX - 1) * boxsize / 2;
+                               controlPointCoordinates[0][1] = cameraY + (nPointsY - 1) * boxsize / 2;
+                               controlPointCoordinates[1][0] = cameraX + (nPointsX - 1) * boxsize / 2;
+                               controlPointCoordinates[1][1] = cameraY - (nPointsY - 1) * boxsize / 2;
+                           }
                        }
-                       if (showCheckerboard)
-                       {
-                           delete_checkerboard();
+
+                       if (!collected) {
+                           spawn_checkerboard(checkerboard_sdf_filename, cameraX / 1000, cameraY / 1000,
+                                              boardZ / 1000, 0, 0, 0);
+
+                           printf("\n*************************************************************\n");
+                           printf("* Please ensure CAPS LOCK is OFF                            *\n");
+                           printf("* Press key w to move to in the positive Y direction        *\n");
+                           printf("* Press key s to move to in the negative Y direction        *\n");
+                           printf("* Press key d to move to in the positive X direction        *\n");
+                           printf("* Press key a to move to in the negative X direction        *\n");
+                           printf("* Press key Shift + w to move to in the positive Z direction*\n");
+                           printf("* Press key Shift + s to move to in the negative Z direction*\n");
+                           printf("* Press e/c to increase decrease step size.                 *\n");
+                           printf("* Press SPACE to show/hide checkerboard.                    *\n");
+                           printf("* Press q to save and continue                              *\n");
+                           printf("*************************************************************\n");
+
+                           printf("\n Step size is currently %f\n", stepSize);
+
+                           for (int i = 0; i < 2; i++)
+                           {
+                               gripperX = controlPointCoordinates[i][0];
+                               gripperY = controlPointCoordinates[i][1];
+                               gripperZ = 0;
+
+                               spawn_model(cylinder_sdf_filename, LINE_MODEL_NAME, gripperX / 1000, gripperY / 1000,
+                                           0.5, 0, 0, 0);
+
+                               moveToCoordinates(gripperX, gripperY, 0, 0);
+
+
+                               char c;
+
+                               do {
+                                   printf("Use wasd to move robot:\n");
+                                   c = getchar();
+                                   //printf("%c", c);int
+                                   switch (c)
+                                   {
+                                       case 'w':
+                                           printf("Moving to positive y\n");
+                                           fineAdjustmentMove(gripperX, gripperY + stepSize, gripperZ, 0);
+                                           gripperY += stepSize;
+                                           break;
+                                       case 'a':
+                                           printf("Moving to negative x\n");
+                                           fineAdjustmentMove(gripperX - stepSize, gripperY, gripperZ, 0);
+                                           gripperX -= stepSize;
+                                           break;
+                                       case 's':
+                                           printf("Moving to positive x\n");
+                                           fineAdjustmentMove(gripperX, gripperY - stepSize, gripperZ, 0);
+                                           gripperY -= stepSize;
+                                           break;
+                                       case 'd':
+                                           printf("Moving to negative y\n");
+                                           fineAdjustmentMove(gripperX + stepSize, gripperY, gripperZ, 0);
+                                           gripperX += stepSize;
+                                           break;
+                                       case 'W':
+                                           printf("Moving to positive z\n");
+                                           fineAdjustmentMove(gripperX, gripperY, gripperZ + stepSize, 0);
+                                           gripperZ += stepSize;
+                                           break;
+                                       case 'S':
+                                           printf("Moving to negative z\n");
+                                           fineAdjustmentMove(gripperX, gripperY, gripperZ - stepSize, 0);
+                                           gripperZ -= stepSize;
+                                           break;
+                                       case 'e':
+                                           stepSize += 1;
+                                           printf("\nStep size now set to %f\n", stepSize);
+                                           break;
+                                       case 'c':
+                                           stepSize -= 1;
+                                           if (stepSize < 1)
+                                           {
+                                               stepSize = 1;
+                                           }
+                                           printf("\nStep size now set to %f\n", stepSize);
+                                           break;
+                                       case ' ':
+                                           if (showCheckerboard)
+                                           {
+                                               delete_checkerboard();
+                                               showCheckerboard = false;
+                                           }
+                                           else
+                                           {
+                                               spawn_checkerboard(checkerboard_sdf_filename, cameraX / 1000, cameraY / 1000,
+                                                                  boardZ / 1000, 0, 0, 0);
+                                               showCheckerboard = true;
+                                           }
+                                           break;
+
+                                   }
+                               } while (c != 'q');
+                               // printf("(%f, %f)", gripperX, gripperY);
+                               controlPointCoordinates[i][0] = gripperX;
+                               controlPointCoordinates[i][1] = gripperY;
+
+                               delete_model(LINE_MODEL_NAME);
+                           }
+                           if (showCheckerboard)
+                           {
+                               delete_checkerboard();
+                           }
                        }
+
                        // printf("(%f, %f)\n", (controlPointCoordinates[1][0] - controlPointCoordinates[0][0])/ 7,
                        //       (controlPointCoordinates[1][1] - controlPointCoordinates[0][1])/ 5);
                        Size2f adjustedBoxSize((controlPointCoordinates[1][0] - controlPointCoordinates[0][0]) / (nPointsX - 1),
@@ -11,6 +11,9 @@
  *                 This was done to allow the simulator to be controlled by publishing joint angles on the
  *                 ROS /lynxmotion_al5d/joints_positions/command topic
  *
+ *   16 October 2026: added imageMessageReceived and collectControlPointsAutomatically to find the control points
+ *                 by visual servoing with the simulator camera instead of by jogging the robot from the keyboard
+ *
  *******************************************************************************************************************/
 
 #ifdef WIN32
@@ -1749,3 +1752,409 @@ void writeWorldCoordinatesToFile(FILE *fp_world_points, float topleftX, float to
     }
     fprintf(fp_world_points, "\n");
 }
+
+
+/***************************************************************************************************************************
+
+   Automatic control point collection by visual servoing
+   -----------------------------------------------------
+
+   Instead of jogging the gripper onto the top-left and bottom-right control points with keypresses, the gripper is driven
+   onto them with the simulator camera in the loop:
+
+   1. the checkerboard corners are detected in the camera image; the top-left and bottom-right corners are the targets, and
+      the corner spacing gives the image Jacobian, i.e. the change in image position per millimetre in x and y
+   2. the checkerboard is removed and a background image is taken
+   3. for each target, the gripper is moved to the nominal position of the control point; in each iteration the gripper is
+      located in the image by background subtraction, the pixel error to the target is mapped through the inverse Jacobian
+      to a Cartesian step, and a proportion of that step is taken; the gain is halved whenever the error grows, and each
+      step is limited to SERVO_MAX_STEP millimetres
+   4. the loop stops when the error is less than SERVO_TOLERANCE pixels, and the commanded position is the control point
+
+   The gripper position in the image is the centre of the part of the arm silhouette within SERVO_TIP_RADIUS millimetres
+   of the silhouette point farthest from the robot base; with a vertical approach this is the centre of the wrist, which
+   is the point that is aligned with the control point in the manual procedure.  Because the wrist is SERVO_WRIST_HEIGHT
+   above the control point and the camera looks down from cameraZ, the target and the Jacobian are scaled about the image
+   of the point directly below the camera to the height of the wrist.  Rather than waiting a fixed time after each move,
+   images are read until the detected position is stable.
+
+***************************************************************************************************************************/
+
+#define SERVO_TOLERANCE            1.0    // pixels
+#define SERVO_MAX_ITERATIONS       30
+#define SERVO_INITIAL_GAIN         0.8
+#define SERVO_MIN_GAIN             0.1
+#define SERVO_MAX_STEP             10.0   // millimetres
+#define SERVO_TIP_RADIUS           15.0   // millimetres
+#define SERVO_WRIST_HEIGHT         60.0   // millimetres above the control point of the part of the gripper seen by the camera
+#define SERVO_DIFFERENCE_THRESHOLD 30     // grey-level difference from the background
+#define SERVO_SETTLE_PIXELS        0.5    // the gripper has stopped when successive positions are closer than this
+#define SERVO_SETTLE_COUNT         3      // ... for this many successive images
+#define SERVO_SETTLE_FRAMES        90     // maximum number of images to wait for the gripper to stop
+#define SERVO_IMAGE_TIMEOUT        5.0    // seconds
+
+extern Mat scene_image;
+extern int imageCount;
+
+
+/*
+ * imageMessageReceived
+ * Keep the latest simulator camera image
+ */
+
+void imageMessageReceived(const sensor_msgs::ImageConstPtr& msg)
+{
+    cv_bridge::CvImagePtr cv_ptr;
+
+    try
+    {
+        cv_ptr = cv_bridge::toCvCopy(msg, sensor_msgs::image_encodings::BGR8);
+    }
+    catch (cv_bridge::Exception& e)
+    {
+        ROS_ERROR("cv_bridge exception: %s", e.what());
+        return;
+    }
+    scene_image = cv_ptr->image;
+    imageCount++;
+}
+
+
+/*
+ * wait_for_image
+ * Spin until an image later than image number after_count arrives; returns false on timeout
+ */
+
+static bool wait_for_image(int after_count, Mat &image)
+{
+    ros::WallTime deadline = ros::WallTime::now() + ros::WallDuration(SERVO_IMAGE_TIMEOUT);
+
+    while (ros::ok() && ros::WallTime::now() < deadline) {
+        ros::spinOnce();
+        if (imageCount > after_count) {
+            image = scene_image.clone();
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+
+/*
+ * wait_for_still_image
+ * Read images until SERVO_SETTLE_COUNT successive images differ from the one before by no more than
+ * SERVO_DIFFERENCE_THRESHOLD, i.e. until the arm has stopped and the models have appeared or disappeared;
+ * returns false if the scene is not still within SERVO_SETTLE_FRAMES images
+ */
+
+static bool wait_for_still_image(Mat &image)
+{
+    Mat grey, previous, difference;
+    int stable = 0;
+
+    for (int frame = 0; frame < SERVO_SETTLE_FRAMES; frame++) {
+        if (!wait_for_image(imageCount, image)) {
+            return false;
+        }
+        cvtColor(image, grey, CV_BGR2GRAY);
+        if (!previous.empty()) {
+            absdiff(grey, previous, difference);
+            if (countNonZero(difference > SERVO_DIFFERENCE_THRESHOLD) == 0) {
+                if (++stable == SERVO_SETTLE_COUNT) {
+                    return true;
+                }
+            }
+            else {
+                stable = 0;
+            }
+        }
+        previous = grey.clone();
+    }
+    return false;
+}
+
+
+/*
+ * leave_field_of_view
+ * Copied from moveRobotImplementation.cpp
+ */
+
+void leave_field_of_view()
+{
+//    Frame OOFV = trans(90, 0, (float) robotConfigurationData.home[2]); // Out of field of view
+    Frame OOFV = trans((float) robotConfigurationData.effector_z, 0, 180); // Out of field of view
+    move(OOFV);
+}
+
+
+/*
+ * servo_move
+ * Move the gripper to (x, y, z) with a vertical approach, without waiting
+ */
+
+static bool servo_move(float x, float y, float z)
+{
+    Frame E;
+    Frame T6;
+
+    E  = trans((float) robotConfigurationData.effector_x,
+               (float) robotConfigurationData.effector_y,
+               (float) robotConfigurationData.effector_z);
+
+    T6 = trans(x, y, z) * roty(180) * inv(E);
+
+    return move(T6);
+}
+
+
+/*
+ * detect_gripper
+ * Position of the gripper in the image: see above
+ */
+
+static bool detect_gripper(const Mat &image, const Mat &background, Point2f base, float radius, Point2f &gripper)
+{
+    Mat grey, difference, mask;
+    vector<Point> points;
+    Point2f farthest;
+    double distance, max_distance = -1;
+    double sum_u = 0, sum_v = 0;
+    int n = 0;
+    size_t i;
+
+    cvtColor(image, grey, CV_BGR2GRAY);
+    absdiff(grey, background, difference);
+    threshold(difference, mask, SERVO_DIFFERENCE_THRESHOLD, 255, THRESH_BINARY);
+    morphologyEx(mask, mask, MORPH_OPEN, getStructuringElement(MORPH_RECT, Size(3, 3)));
+
+    findNonZero(mask, points);
+    if (points.empty()) {
+        return false;
+    }
+
+    for (i = 0; i < points.size(); i++) {
+        distance = norm(Point2f((float) points[i].x, (float) points[i].y) - base);
+        if (distance > max_distance) {
+            max_distance = distance;
+            farthest = Point2f((float) points[i].x, (float) points[i].y);
+        }
+    }
+
+    for (i = 0; i < points.size(); i++) {
+        if (norm(Point2f((float) points[i].x, (float) points[i].y) - farthest) < radius) {
+            sum_u += points[i].x;
+            sum_v += points[i].y;
+            n++;
+        }
+    }
+
+    gripper = Point2f((float) (sum_u / n), (float) (sum_v / n));
+    return true;
+}
+
+
+/*
+ * wait_for_gripper
+ * Read images until the gripper is detected at the same position in SERVO_SETTLE_COUNT successive images;
+ * returns false if it is not within SERVO_SETTLE_FRAMES images
+ */
+
+static bool wait_for_gripper(const Mat &background, Point2f base, float radius, Point2f &gripper)
+{
+    Mat image;
+    Point2f previous(-1, -1);
+    bool found;
+    int stable = 0;
+
+    for (int frame = 0; frame < SERVO_SETTLE_FRAMES; frame++) {
+        if (!wait_for_image(imageCount, image)) {
+            return false;
+        }
+        found = detect_gripper(image, background, base, radius, gripper);
+        if (found && norm(gripper - previous) < SERVO_SETTLE_PIXELS) {
+            if (++stable == SERVO_SETTLE_COUNT) {
+                return true;
+            }
+        }
+        else {
+            stable = 0;
+        }
+        if (found) previous = gripper;
+    }
+    return false;
+}
+
+
+/*
+ * servoToImagePoint
+ * Drive the gripper onto the target image point, starting from the commanded position (x, y); on return (x, y) is the
+ * commanded position at which the gripper is on the target.  Returns false if the gripper can't be detected or the loop
+ * does not converge.
+ */
+
+bool servoToImagePoint(Point2f target, Matx22f jacobian, Point2f base, float radius, const Mat &background, 
+                       float &x, float &y, int *iterations)
+{
+    Matx22f inverse_jacobian = jacobian.inv();
+    Point2f gripper;
+    Vec2f   pixel_error, previous_pixel_error, step;
+    double  error, previous_error = DBL_MAX;
+    double  gain = SERVO_INITIAL_GAIN;
+    double  length;
+    float   previous_x = x, previous_y = y;
+    int     iteration;
+    bool    debug = false;
+
+    for (iteration = 0; iteration < SERVO_MAX_ITERATIONS; iteration++) {
+
+        if (!servo_move(x, y, 0) || !wait_for_gripper(background, base, radius, gripper)) {
+            *iterations = iteration;
+            return false;
+        }
+
+        pixel_error = Vec2f(target.x - gripper.x, target.y - gripper.y);
+        error = norm(pixel_error);
+
+        if (debug) printf("   iteration %2d: commanded (%6.1f, %6.1f) gripper (%6.1f, %6.1f) error %5.2f pixels\n", 
+                          iteration, x, y, gripper.x, gripper.y, error);
+
+        if (error < SERVO_TOLERANCE) {
+            *iterations = iteration + 1;
+            return true;
+        }
+
+        /* adaptive step size: if the last step made things worse, take a smaller step from the previous position */
+
+        if (error > previous_error && gain > SERVO_MIN_GAIN) {
+            gain = gain / 2;
+            x = previous_x;
+            y = previous_y;
+            pixel_error = previous_pixel_error;
+        }
+        else {
+            previous_error = error;
+            previous_pixel_error = pixel_error;
+            previous_x = x;
+            previous_y = y;
+        }
+
+        step = inverse_jacobian * pixel_error * (float) gain;
+        length = norm(step);
+        if (length > SERVO_MAX_STEP) {
+            step = step * (float) (SERVO_MAX_STEP / length);
+        }
+
+        x += step[0];
+        y += step[1];
+    }
+
+    *iterations = iteration;
+    return false;
+}
+
+
+/*
+ * collectControlPointsAutomatically
+ * Find the commanded gripper positions for the top-left and bottom-right control points by visual servoing;
+ * controlPointCoordinates holds the nominal positions on entry and the commanded positions on return.
+ * Returns false if the checkerboard or the gripper can't be found or the servoing does not converge.
+ */
+
+bool collectControlPointsAutomatically(const char *checkerboard_sdf_filename, float cameraX, float cameraY, float cameraZ,
+                                       float boardZ, int nPointsX, int nPointsY, float boxsize, 
+                                       float controlPointCoordinates[2][2])
+{
+    vector<Point2f> corners;
+    Mat image, grey, background;
+    Matx22f jacobian;
+    Point2f targets[2];
+    Point2f base, nadir;
+    float radius, scale;
+    int iterations;
+    int64 start_ticks = getTickCount();
+    int i;
+
+    /* 1. targets and image Jacobian from the checkerboard, with the arm out of the field of view */
+
+    leave_field_of_view();
+    if (!wait_for_still_image(image)) {
+        printf("No still image received from the simulator camera\n");
+        return false;
+    }
+
+    spawn_checkerboard(checkerboard_sdf_filename, cameraX / 1000, cameraY / 1000, boardZ / 1000, 0, 0, 0);
+
+    if (!wait_for_still_image(image)) {
+        printf("No still image received from the simulator camera\n");
+        delete_checkerboard();
+        return false;
+    }
+
+    cvtColor(image, grey, CV_BGR2GRAY);
+    if (!findChessboardCorners(grey, Size(nPointsX, nPointsY), corners, 
+                               CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE)) {
+        printf("Checkerboard not found in the camera image\n");
+        delete_checkerboard();
+        return false;
+    }
+    cornerSubPix(grey, corners, Size(11, 11), Size(-1, -1), TermCriteria(CV_TERMCRIT_EPS + CV_TERMCRIT_ITER, 30, 0.1));
+
+    /* corners are ordered with x increasing along a row and y decreasing from row to row,          */
+    /* as in writeWorldCoordinatesToFile(); corners[0] is the top-left control point.               */
+    /* findChessboardCorners() may return them in the reverse order; the camera looks down with u   */
+    /* along x and v along -y, so the top-left control point is the corner nearest the image origin */
+
+    if (corners[0].x + corners[0].y > corners.back().x + corners.back().y) {
+        std::reverse(corners.begin(), corners.end());
+    }
+
+    Point2f du_dx = (corners[nPointsX - 1] - corners[0]) * (1.0f / ((nPointsX - 1) * boxsize));
+    Point2f du_dy = (corners[0] - corners[(nPointsY - 1) * nPointsX]) * (1.0f / ((nPointsY - 1) * boxsize));
+    jacobian = Matx22f(du_dx.x, du_dy.x,
+                       du_dx.y, du_dy.y);
+
+    /* image positions of the robot base, at the world origin, and of the point below the camera */
+
+    Vec2f base_offset  = jacobian * Vec2f(-controlPointCoordinates[0][0], -controlPointCoordinates[0][1]);
+    Vec2f nadir_offset = jacobian * Vec2f(cameraX - controlPointCoordinates[0][0], cameraY - controlPointCoordinates[0][1]);
+    base  = corners[0] + Point2f(base_offset[0], base_offset[1]);
+    nadir = corners[0] + Point2f(nadir_offset[0], nadir_offset[1]);
+
+    /* targets and Jacobian at the height of the wrist */
+
+    scale      = (float) ((cameraZ - boardZ) / (cameraZ - SERVO_WRIST_HEIGHT));
+    targets[0] = nadir + (corners[0] - nadir) * scale;
+    targets[1] = nadir + (corners[corners.size() - 1] - nadir) * scale;
+    jacobian   = jacobian * scale;
+    radius     = (float) (SERVO_TIP_RADIUS * norm(du_dx) * scale);
+
+    /* 2. background */
+
+    delete_checkerboard();
+    if (!wait_for_still_image(image)) {
+        printf("No still image received from the simulator camera\n");
+        return false;
+    }
+    cvtColor(image, background, CV_BGR2GRAY);
+
+    /* 3. and 4. servo onto each control point */
+
+    grasp(GRIPPER_OPEN);
+
+    for (i = 0; i < 2; i++) {
+        printf("Control point %d: target (%6.1f, %6.1f) pixels\n", i + 1, targets[i].x, targets[i].y);
+
+        if (!servoToImagePoint(targets[i], jacobian, base, radius, background, 
+                               controlPointCoordinates[i][0], controlPointCoordinates[i][1], &iterations)) {
+            printf("Control point %d: visual servoing did not converge after %d iterations\n", i + 1, iterations);
+            return false;
+        }
+        printf("Control point %d: (%6.1f, %6.1f) mm after %d iterations\n", 
+               i + 1, controlPointCoordinates[i][0], controlPointCoordinates[i][1], iterations);
+    }
+
+    printf("Control points collected in %.1f s\n", (getTickCount() - start_ticks) / getTickFrequency());
+
+    return true;
+}